@@ -0,0 +1,953 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+
+/**
+ * Host-native microbenchmarks of the crypto and transaction core. Every
+ * hw_* primitive is timed on its own, followed by the tx_load_input path
+ * and the tx_sign path for transactions of 1, 16 and 90 inputs.
+ *
+ * Host timings only say how the code paths compare with each other; the
+ * cx_* op counts reported alongside are what dominate the cost on device.
+ */
+
+#include <cx_counters.h>
+#include <nonce_pool.h>
+#include <profile.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <transaction.h>
+
+#define DEFAULT_ITERATIONS 50
+
+unsigned char G_working_set[WORKING_SET_SIZE];
+
+unsigned char G_tx_working_set[TX_WORKING_SET_SIZE];
+
+static unsigned int L_iterations = DEFAULT_ITERATIONS;
+
+static uint16_t L_status;
+
+static bool L_failed;
+
+static struct
+{
+    unsigned char tx_public_key[KEY_SIZE];
+
+    unsigned char tx_private_key[KEY_SIZE];
+
+    unsigned char derivation[KEY_SIZE];
+
+    unsigned char output_key[KEY_SIZE];
+
+    unsigned char private_ephemeral[KEY_SIZE];
+
+    unsigned char public_keys[RING_PARTICIPANTS * KEY_SIZE];
+
+    unsigned char prefix_hash[KEY_SIZE];
+
+    unsigned char key_image[KEY_SIZE];
+
+    unsigned char signature[SIG_SIZE];
+
+    unsigned char signatures[SIG_SIZE * RING_PARTICIPANTS];
+
+    unsigned char k[KEY_SIZE];
+
+    unsigned char out[SIG_SIZE * RING_PARTICIPANTS];
+} L_data;
+
+#define REAL_OUTPUT_INDEX 1
+
+typedef struct input_s
+{
+    unsigned char tx_public_key[KEY_SIZE];
+
+    unsigned char public_keys[RING_PARTICIPANTS * KEY_SIZE];
+
+    uint32_t offsets[RING_PARTICIPANTS];
+
+    uint8_t real_output_index;
+} input_t;
+
+static input_t L_inputs[TX_MAX_INPUTS];
+
+static uint64_t now_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void print_header()
+{
+    printf(
+        "%-36s %6s %12s %7s %6s %6s %6s %7s %6s %6s\n",
+        "benchmark",
+        "iters",
+        "ns/op",
+        "smult",
+        "padd",
+        "decmp",
+        "cmp",
+        "modop",
+        "hash",
+        "nvm");
+}
+
+/**
+ * Prints a result line, op counts are per operation
+ */
+static void print_result(
+    const char *name,
+    const uint64_t iterations,
+    const uint64_t elapsed,
+    const cx_op_counts_t *counts,
+    const unsigned long long nvm_writes)
+{
+    const double n = (double)iterations;
+
+    printf(
+        "%-36s %6llu %12.0f %7.1f %6.1f %6.1f %6.1f %7.1f %6.1f %6.1f",
+        name,
+        (unsigned long long)iterations,
+        (double)elapsed / n,
+        (double)counts->scalar_mult / n,
+        (double)counts->add_point / n,
+        (double)counts->decompress / n,
+        (double)counts->compress / n,
+        (double)(counts->multm + counts->addm + counts->subm + counts->modm) / n,
+        (double)counts->hash / n,
+        (double)nvm_writes / n);
+
+    if (L_failed)
+    {
+        printf("  FAILED (0x%04x)", L_status);
+    }
+
+    printf("\n");
+}
+
+/**
+ * Runs fn iterations times, calling setup (if any) before each call with
+ * its time and op counts left out of the result
+ */
+static void run_setup(const char *name, void (*setup)(), void (*fn)(), const unsigned int iterations)
+{
+    uint64_t excluded = 0;
+
+    L_status = OP_OK;
+
+    L_failed = false;
+
+    // warm up (and make sure the call actually succeeds)
+    if (setup)
+    {
+        setup();
+    }
+
+    fn();
+
+    memset(&G_cx_op_counts, 0, sizeof(G_cx_op_counts));
+
+    const unsigned long long nvm_writes = G_nvm_write_count;
+
+    const uint64_t start = now_ns();
+
+    for (unsigned int i = 0; i < iterations; i++)
+    {
+        if (setup)
+        {
+            const cx_op_counts_t counts = G_cx_op_counts;
+
+            const uint64_t setup_start = now_ns();
+
+            setup();
+
+            excluded += now_ns() - setup_start;
+
+            G_cx_op_counts = counts;
+        }
+
+        fn();
+    }
+
+    const uint64_t elapsed = now_ns() - start - excluded;
+
+    print_result(name, iterations, elapsed, &G_cx_op_counts, G_nvm_write_count - nvm_writes);
+}
+
+static void run(const char *name, void (*fn)(), const unsigned int iterations)
+{
+    run_setup(name, NULL, fn, iterations);
+}
+
+#define CHECK_RESULT(x, expected)     \
+    {                                 \
+        const uint16_t _status = (x); \
+        if (_status != (expected))    \
+        {                             \
+            L_status = _status;       \
+            L_failed = true;          \
+        }                             \
+    }
+
+#define CHECK(x) CHECK_RESULT(x, OP_OK)
+
+// the hw_check_* calls return whether the check passed rather than a status
+#define CHECK_VALID(x) CHECK_RESULT(x, 1)
+
+static void b_check_key()
+{
+    CHECK_VALID(hw_check_key(PTR_SPEND_PUBLIC));
+}
+
+static void b_check_scalar()
+{
+    CHECK_VALID(hw_check_scalar(PTR_SPEND_PRIVATE));
+}
+
+// a full APDU_CHECK_KEYS or APDU_CHECK_SCALARS request, the same value fourteen times over
+#define CHECK_BATCH_SIZE 14
+
+static void b_check_keys()
+{
+    unsigned char keys[CHECK_BATCH_SIZE * KEY_SIZE], results[2];
+
+    for (int i = 0; i < CHECK_BATCH_SIZE; i++)
+    {
+        os_memmove(keys + (i * KEY_SIZE), PTR_SPEND_PUBLIC, KEY_SIZE);
+    }
+
+    CHECK(hw_check_keys(results, keys, CHECK_BATCH_SIZE));
+
+    CHECK_RESULT(results[0] | (results[1] << 8), (1 << CHECK_BATCH_SIZE) - 1);
+}
+
+static void b_check_scalars()
+{
+    unsigned char scalars[CHECK_BATCH_SIZE * KEY_SIZE], results[2];
+
+    for (int i = 0; i < CHECK_BATCH_SIZE; i++)
+    {
+        os_memmove(scalars + (i * KEY_SIZE), PTR_SPEND_PRIVATE, KEY_SIZE);
+    }
+
+    CHECK(hw_check_scalars(results, scalars, CHECK_BATCH_SIZE));
+
+    CHECK_RESULT(results[0] | (results[1] << 8), (1 << CHECK_BATCH_SIZE) - 1);
+}
+
+static void b_check_signature()
+{
+    CHECK_VALID(hw_check_signature(L_data.prefix_hash, PTR_SPEND_PUBLIC, L_data.signature));
+}
+
+// a full APDU_CHECK_SIGNATURES request, the same signature four times over
+static void b_check_signatures()
+{
+    unsigned char public_keys[RING_PARTICIPANTS * KEY_SIZE], signatures[RING_PARTICIPANTS * SIG_SIZE];
+
+    unsigned char results = 0;
+
+    for (int i = 0; i < RING_PARTICIPANTS; i++)
+    {
+        os_memmove(public_keys + (i * KEY_SIZE), PTR_SPEND_PUBLIC, KEY_SIZE);
+
+        os_memmove(signatures + (i * SIG_SIZE), L_data.signature, SIG_SIZE);
+    }
+
+    CHECK(hw_check_signatures(&results, L_data.prefix_hash, RING_PARTICIPANTS, public_keys, signatures));
+
+    CHECK_RESULT(results, (1 << RING_PARTICIPANTS) - 1);
+}
+
+static void b_check_ring_signatures()
+{
+    CHECK_VALID(hw_check_ring_signatures(L_data.prefix_hash, L_data.key_image, L_data.public_keys, L_data.signatures));
+}
+
+static hp_cache_t L_hp_cache;
+
+// every ring member already seen, as when rings share their members
+static void b_check_ring_signatures_cached()
+{
+    CHECK_VALID(hw_check_ring_signatures_cached(
+        L_data.prefix_hash, L_data.key_image, L_data.public_keys, L_data.signatures, &L_hp_cache));
+}
+
+static void b_complete_ring_signature()
+{
+    os_memmove(L_data.out, L_data.signature, SIG_SIZE);
+
+    CHECK(hw_complete_ring_signature(
+        L_data.out,
+        L_data.tx_public_key,
+        0,
+        L_data.output_key,
+        L_data.k,
+        PTR_VIEW_PRIVATE,
+        PTR_SPEND_PRIVATE,
+        PTR_SPEND_PUBLIC));
+}
+
+static void b_derive_public_key()
+{
+    CHECK(hw_derive_public_key(L_data.out, L_data.derivation, 0, PTR_SPEND_PUBLIC));
+}
+
+static void b_derive_secret_key()
+{
+    CHECK(hw_derive_secret_key(L_data.out, L_data.derivation, 0, PTR_SPEND_PRIVATE));
+}
+
+static void b_generate_key_derivation()
+{
+    CHECK(hw_generate_key_derivation(L_data.out, L_data.tx_public_key, PTR_VIEW_PRIVATE));
+}
+
+static void b_generate_key_image()
+{
+    CHECK(hw_generate_key_image(
+        L_data.out,
+        L_data.tx_public_key,
+        0,
+        L_data.output_key,
+        PTR_VIEW_PRIVATE,
+        PTR_SPEND_PRIVATE,
+        PTR_SPEND_PUBLIC));
+}
+
+static void b_generate_key_image_primitive()
+{
+    CHECK(hw_generate_key_image_primitive(
+        L_data.out, L_data.derivation, 0, L_data.output_key, PTR_SPEND_PRIVATE, PTR_SPEND_PUBLIC));
+}
+
+static void b_generate_keypair()
+{
+    CHECK(hw_generate_keypair(L_data.out, L_data.out + KEY_SIZE));
+}
+
+static void b_generate_private_view_key()
+{
+    CHECK(hw_generate_private_view_key(L_data.out, PTR_SPEND_PRIVATE));
+}
+
+static void b_generate_ring_signatures()
+{
+    CHECK(hw_generate_ring_signatures(
+        L_data.out,
+        L_data.tx_public_key,
+        0,
+        L_data.output_key,
+        L_data.prefix_hash,
+        L_data.public_keys,
+        REAL_OUTPUT_INDEX,
+        PTR_VIEW_PRIVATE,
+        PTR_SPEND_PRIVATE,
+        PTR_SPEND_PUBLIC));
+}
+
+static void b_generate_signature()
+{
+    CHECK(hw_generate_signature(L_data.out, L_data.prefix_hash, PTR_SPEND_PUBLIC, PTR_SPEND_PRIVATE));
+}
+
+// a full APDU_GENERATE_SIGNATURES chunk, the ring keys stand in for the digests
+static void b_generate_signatures()
+{
+    CHECK(hw_generate_signatures(
+        L_data.out, L_data.public_keys, RING_PARTICIPANTS, PTR_SPEND_PUBLIC, PTR_SPEND_PRIVATE));
+}
+
+// what idle ticker events do between signatures on the device
+static void fill_nonce_pool()
+{
+    while (nonce_pool_count() < NONCE_POOL_SIZE)
+    {
+        nonce_pool_tick();
+    }
+}
+
+static void b_keccak()
+{
+    CHECK(hw_keccak(L_data.public_keys, sizeof(L_data.public_keys), L_data.out));
+}
+
+// the input size of hash to point
+static void b_keccak_key()
+{
+    CHECK(hw_keccak(L_data.public_keys, KEY_SIZE, L_data.out));
+}
+
+static void b_private_key_to_public_key()
+{
+    CHECK(hw_private_key_to_public_key(L_data.out, PTR_SPEND_PRIVATE));
+}
+
+static void b_retrieve_private_spend_key()
+{
+    CHECK(hw_retrieve_private_spend_key(L_data.out));
+}
+
+static void b__generate_key_image()
+{
+    CHECK(hw__generate_key_image(L_data.out, L_data.output_key, L_data.private_ephemeral));
+}
+
+static void b__generate_ring_signatures()
+{
+    CHECK(hw__generate_ring_signatures(
+        L_data.out,
+        L_data.prefix_hash,
+        L_data.key_image,
+        L_data.public_keys,
+        L_data.private_ephemeral,
+        REAL_OUTPUT_INDEX));
+}
+
+/**
+ * Fills the given ring with random keys and puts the output key for the
+ * given transaction public key and output index at the real output index
+ */
+static uint16_t make_ring(
+    unsigned char *public_keys,
+    const unsigned char *tx_public_key,
+    const size_t output_index,
+    const uint8_t real_output_index)
+{
+    unsigned char derivation[KEY_SIZE], private[KEY_SIZE];
+
+    for (int i = 0; i < RING_PARTICIPANTS; i++)
+    {
+        hw_generate_keypair(public_keys + (i * KEY_SIZE), private);
+    }
+
+    uint16_t status = hw_generate_key_derivation(derivation, tx_public_key, PTR_VIEW_PRIVATE);
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+
+    return hw_derive_public_key(
+        public_keys + (real_output_index * KEY_SIZE), derivation, output_index, PTR_SPEND_PUBLIC);
+}
+
+static uint16_t setup_primitives()
+{
+    uint16_t status = hw_generate_keypair(L_data.tx_public_key, L_data.tx_private_key);
+
+    status |= hw_generate_key_derivation(L_data.derivation, L_data.tx_public_key, PTR_VIEW_PRIVATE);
+
+    status |= make_ring(L_data.public_keys, L_data.tx_public_key, 0, REAL_OUTPUT_INDEX);
+
+    os_memmove(L_data.output_key, L_data.public_keys + (REAL_OUTPUT_INDEX * KEY_SIZE), KEY_SIZE);
+
+    status |= hw_derive_secret_key(L_data.private_ephemeral, L_data.derivation, 0, PTR_SPEND_PRIVATE);
+
+    status |= hw_keccak((const unsigned char *)"turtlecoin", 10, L_data.prefix_hash);
+
+    status |= hw__generate_key_image(L_data.key_image, L_data.output_key, L_data.private_ephemeral);
+
+    status |= hw__generate_ring_signatures(
+        L_data.signatures,
+        L_data.prefix_hash,
+        L_data.key_image,
+        L_data.public_keys,
+        L_data.private_ephemeral,
+        REAL_OUTPUT_INDEX);
+
+    status |= hw_generate_signature(L_data.signature, L_data.prefix_hash, PTR_SPEND_PUBLIC, PTR_SPEND_PRIVATE);
+
+    status |= hw_generate_keypair(L_data.out, L_data.k);
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+
+    // the shim is only useful if what it produces actually verifies
+    if (hw_check_signature(L_data.prefix_hash, PTR_SPEND_PUBLIC, L_data.signature) != 1
+        || hw_check_ring_signatures(L_data.prefix_hash, L_data.key_image, L_data.public_keys, L_data.signatures) != 1)
+    {
+        return OP_NOK;
+    }
+
+    return OP_OK;
+}
+
+static uint16_t setup_inputs()
+{
+    unsigned char private[KEY_SIZE];
+
+    for (int i = 0; i < TX_MAX_INPUTS; i++)
+    {
+        input_t *input = &L_inputs[i];
+
+        input->real_output_index = (uint8_t)(i % RING_PARTICIPANTS);
+
+        hw_generate_keypair(input->tx_public_key, private);
+
+        const uint16_t status =
+            make_ring(input->public_keys, input->tx_public_key, (size_t)i, input->real_output_index);
+
+        if (status != OP_OK)
+        {
+            return status;
+        }
+
+        for (int j = 0; j < RING_PARTICIPANTS; j++)
+        {
+            input->offsets[j] = (uint32_t)(1000 * i + j + 1);
+        }
+    }
+
+    return OP_OK;
+}
+
+/**
+ * Builds a transaction with the given number of inputs (and one output)
+ * up to the point where it is ready to sign
+ * @param input_count the number of inputs
+ * @param load_ns receives the time spent in tx_load_input
+ * @param load_counts receives the cx_* calls made by tx_load_input
+ * @param load_nvm_writes receives the nvm_write calls made by tx_load_input
+ */
+static uint16_t build_transaction(
+    const uint8_t input_count,
+    uint64_t *load_ns,
+    cx_op_counts_t *load_counts,
+    unsigned long long *load_nvm_writes)
+{
+    unsigned char tx_public_key[KEY_SIZE], tx_private_key[KEY_SIZE], payment_id[KEY_SIZE] = {0};
+
+    unsigned char output_key[KEY_SIZE];
+
+    hw_generate_keypair(tx_public_key, tx_private_key);
+
+    hw_generate_keypair(output_key, tx_private_key);
+
+    uint16_t status = tx_start(0, input_count, 1, tx_public_key, 0, payment_id);
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+
+    status = tx_start_input_load();
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+
+    memset(&G_cx_op_counts, 0, sizeof(G_cx_op_counts));
+
+    const unsigned long long nvm_writes = G_nvm_write_count;
+
+    const uint64_t start = now_ns();
+
+    for (uint8_t i = 0; i < input_count; i++)
+    {
+        const input_t *input = &L_inputs[i];
+
+        status = tx_load_input(
+            input->tx_public_key, i, 100, input->public_keys, input->offsets, input->real_output_index);
+
+        if (status != OP_OK)
+        {
+            return status;
+        }
+    }
+
+    *load_ns = now_ns() - start;
+
+    *load_counts = G_cx_op_counts;
+
+    *load_nvm_writes = G_nvm_write_count - nvm_writes;
+
+    status = tx_start_output_load();
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+
+    status = tx_load_output((uint64_t)input_count * 100 - 10, output_key);
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+
+    return tx_finalize_prefix();
+}
+
+/**
+ * Signs the transaction in the selected slot through to its last input; when
+ * the rings are not kept (TX_COMPACT_PRESIG) they are supplied again the way
+ * the host does with APDU_TX_SIGN_RING
+ */
+static uint16_t sign_transaction()
+{
+#if TX_COMPACT_PRESIG == 1
+    uint16_t status = tx_sign_begin();
+
+    while (status == OP_OK && tx_state() == TX_SIGNING)
+    {
+        status = tx_sign_ring(tx_signed_input_count(), L_inputs[tx_signed_input_count()].public_keys);
+    }
+
+    return status;
+#else
+    return tx_sign();
+#endif
+}
+
+static void bench_transaction(const uint8_t input_count)
+{
+    char name[64];
+
+    // tx_load_input, timed across all of the inputs of the transaction
+    {
+        uint64_t elapsed = 0;
+
+        cx_op_counts_t counts = {0};
+
+        unsigned long long nvm_writes = 0;
+
+        L_status = build_transaction(input_count, &elapsed, &counts, &nvm_writes);
+
+        L_failed = L_status != OP_OK;
+
+        snprintf(name, sizeof(name), "tx_load_input (%u inputs)", input_count);
+
+        print_result(name, input_count, elapsed, &counts, nvm_writes);
+    }
+
+    // tx_sign, from a prefix ready to sign through to the last ring signature
+    {
+        memset(&G_cx_op_counts, 0, sizeof(G_cx_op_counts));
+
+        const unsigned long long nvm_writes = G_nvm_write_count;
+
+        const uint64_t start = now_ns();
+
+        if (!L_failed)
+        {
+            L_status = sign_transaction();
+
+            L_failed = L_status != OP_OK;
+        }
+
+        const uint64_t elapsed = now_ns() - start;
+
+        snprintf(name, sizeof(name), "tx_sign (%u inputs)", input_count);
+
+        print_result(name, 1, elapsed, &G_cx_op_counts, G_nvm_write_count - nvm_writes);
+    }
+
+#if TX_COMPACT_PRESIG == 0
+    // tx_verify, every ring of the signed transaction in one call
+    {
+        unsigned char results[(TX_MAX_INPUTS + 7) / 8];
+
+        memset(&G_cx_op_counts, 0, sizeof(G_cx_op_counts));
+
+        const uint64_t start = now_ns();
+
+        if (!L_failed)
+        {
+            L_status = tx_verify(results, &L_hp_cache);
+
+            L_failed = L_status != OP_OK;
+
+            for (uint8_t i = 0; i < input_count; i++)
+            {
+                L_failed |= !(results[i / 8] & (1 << (i % 8)));
+            }
+        }
+
+        const uint64_t elapsed = now_ns() - start;
+
+        snprintf(name, sizeof(name), "tx_verify (%u inputs)", input_count);
+
+        print_result(name, 1, elapsed, &G_cx_op_counts, 0);
+    }
+
+    tx_reset();
+
+    // the same again but signed while the approval is displayed, what is left once approved is timed
+    {
+        uint64_t elapsed = 0;
+
+        cx_op_counts_t counts = {0};
+
+        unsigned long long nvm_writes = 0;
+
+        if (!L_failed)
+        {
+            L_status = build_transaction(input_count, &elapsed, &counts, &nvm_writes);
+
+            L_failed = L_status != OP_OK;
+        }
+
+        const uint16_t prefix_size = tx_size();
+
+        // a rejection part way through must leave the prefix ready to sign again
+        if (!L_failed)
+        {
+            L_status = tx_presign_begin();
+
+            if (L_status == OP_OK)
+            {
+                L_status = tx_sign_step();
+            }
+
+            if (L_status == OP_OK)
+            {
+                L_status = tx_presign_abort();
+            }
+
+            L_failed = L_status != OP_OK || tx_state() != TX_PREFIX_READY || tx_size() != prefix_size;
+        }
+
+        if (!L_failed)
+        {
+            L_status = tx_presign_begin();
+
+            while (L_status == OP_OK && tx_signed_input_count() < tx_input_count())
+            {
+                L_status = tx_sign_step();
+            }
+
+            L_failed = L_status != OP_OK || tx_state() != TX_PRESIGNING;
+        }
+
+        memset(&G_cx_op_counts, 0, sizeof(G_cx_op_counts));
+
+        const unsigned long long approve_nvm_writes = G_nvm_write_count;
+
+        const uint64_t start = now_ns();
+
+        if (!L_failed)
+        {
+            L_status = tx_sign();
+
+            L_failed = L_status != OP_OK || tx_state() != TX_COMPLETE;
+        }
+
+        elapsed = now_ns() - start;
+
+        snprintf(name, sizeof(name), "tx_sign presigned (%u inputs)", input_count);
+
+        print_result(name, 1, elapsed, &G_cx_op_counts, G_nvm_write_count - approve_nvm_writes);
+    }
+#endif
+
+    tx_reset();
+}
+
+typedef struct nvm_budget_s
+{
+    uint8_t input_count;
+
+    uint32_t writes;
+
+    uint32_t bytes;
+
+    uint32_t page_programs;
+
+    uint32_t distinct_pages;
+} nvm_budget_t;
+
+/**
+ * The most NVRAM that building and signing a transaction with the given
+ * number of inputs (and one output) may program. Lower these whenever a
+ * change reduces the writes so that they cannot creep back up
+ */
+static const nvm_budget_t C_NVM_BUDGETS[] = {
+#if TX_COMPACT_PRESIG == 1
+    {1, 20, 48602, 771, 741},
+    {16, 95, 57183, 968, 741},
+    {TX_MAX_INPUTS, 465, 99803, 1947, 741},
+#else
+    {1, 20, 57338, 908, 876},
+    {16, 95, 67359, 1127, 876},
+    {TX_MAX_INPUTS, 465, 117083, 2217, 876},
+#endif
+};
+
+static uint32_t read_uint32(const unsigned char *in)
+{
+    return ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | (uint32_t)in[3];
+}
+
+static bool check_budget(const char *name, const uint32_t used, const uint32_t budget)
+{
+    const bool over = used > budget;
+
+    printf("  %-16s %10u / %10u%s\n", name, used, budget, over ? "  OVER BUDGET" : "");
+
+    return !over;
+}
+
+/**
+ * Builds and signs the reference transactions and checks the NVRAM that
+ * they program against their budgets
+ * @return whether every transaction stayed within its budget
+ */
+static bool nvm_budget()
+{
+    bool result = true;
+
+    for (size_t i = 0; i < sizeof(C_NVM_BUDGETS) / sizeof(nvm_budget_t); i++)
+    {
+        const nvm_budget_t *budget = &C_NVM_BUDGETS[i];
+
+        unsigned char stats[PROFILE_NVM_SIZE];
+
+        uint64_t elapsed = 0;
+
+        cx_op_counts_t counts = {0};
+
+        unsigned long long nvm_writes = 0;
+
+        tx_select(0);
+
+        nvm_pages_reset();
+
+        uint16_t status = build_transaction(budget->input_count, &elapsed, &counts, &nvm_writes);
+
+        if (status == OP_OK)
+        {
+            status = sign_transaction();
+        }
+
+        if (status != OP_OK)
+        {
+            printf("transaction (%u inputs) FAILED (0x%04x)\n", budget->input_count, status);
+
+            return false;
+        }
+
+        profile_nvm_dump(stats);
+
+        // the first 16 bytes are the last APDU, followed by the transaction in each slot
+        const unsigned char *tx_stats = stats + PROFILE_NVM_STATS_SIZE + 4;
+
+        printf("transaction (%u inputs)\n", budget->input_count);
+
+        result &= check_budget("writes", read_uint32(tx_stats), budget->writes);
+
+        result &= check_budget("bytes", read_uint32(tx_stats + 4), budget->bytes);
+
+        result &= check_budget("page programs", read_uint32(tx_stats + 8), budget->page_programs);
+
+        result &= check_budget("distinct pages", (uint32_t)G_nvm_distinct_pages, budget->distinct_pages);
+
+        tx_reset();
+    }
+
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    bool budget = false;
+
+    if (argc > 1 && strcmp(argv[1], "--nvm-budget") == 0)
+    {
+        budget = true;
+    }
+    else if (argc > 1)
+    {
+        L_iterations = (unsigned int)strtoul(argv[1], NULL, 10);
+
+        if (L_iterations == 0)
+        {
+            fprintf(stderr, "usage: %s [iterations | --nvm-budget]\n", argv[0]);
+
+            return 1;
+        }
+    }
+
+    if (init_keys() != OP_OK || init_tx() != OP_OK)
+    {
+        fprintf(stderr, "could not initialize the wallet\n");
+
+        return 1;
+    }
+
+    if (setup_primitives() != OP_OK || setup_inputs() != OP_OK)
+    {
+        fprintf(stderr, "self test failed, the cx shim is producing invalid results\n");
+
+        return 1;
+    }
+
+    if (budget)
+    {
+        return nvm_budget() ? 0 : 1;
+    }
+
+    print_header();
+
+    run("hw_check_key", b_check_key, L_iterations);
+    run("hw_check_keys (14 keys)", b_check_keys, L_iterations);
+    run("hw_check_scalar", b_check_scalar, L_iterations);
+    run("hw_check_scalars (14 scalars)", b_check_scalars, L_iterations);
+    run("hw_check_signature", b_check_signature, L_iterations);
+    run("hw_check_signatures (4 signatures)", b_check_signatures, L_iterations);
+    run("hw_check_ring_signatures", b_check_ring_signatures, L_iterations);
+    run("hw_check_ring_signatures (cached)", b_check_ring_signatures_cached, L_iterations);
+    run("hw_complete_ring_signature", b_complete_ring_signature, L_iterations);
+    run("hw_derive_public_key", b_derive_public_key, L_iterations);
+    run("hw_derive_secret_key", b_derive_secret_key, L_iterations);
+    run("hw_generate_key_derivation", b_generate_key_derivation, L_iterations);
+    run("hw_generate_key_image", b_generate_key_image, L_iterations);
+    run("hw_generate_key_image_primitive", b_generate_key_image_primitive, L_iterations);
+    run("hw_generate_keypair", b_generate_keypair, L_iterations);
+    run("hw_generate_private_view_key", b_generate_private_view_key, L_iterations);
+    run("hw_generate_ring_signatures", b_generate_ring_signatures, L_iterations);
+    run_setup("hw_generate_ring_signatures (pooled)", fill_nonce_pool, b_generate_ring_signatures, L_iterations);
+    run("hw_generate_signature", b_generate_signature, L_iterations);
+    run_setup("hw_generate_signature (pooled)", fill_nonce_pool, b_generate_signature, L_iterations);
+    run("hw_generate_signatures (4 digests)", b_generate_signatures, L_iterations);
+    run_setup("hw_generate_signatures (4, pooled)", fill_nonce_pool, b_generate_signatures, L_iterations);
+    run("hw_keccak", b_keccak, L_iterations);
+    run("hw_keccak (32 bytes)", b_keccak_key, L_iterations);
+    run("hw_private_key_to_public_key", b_private_key_to_public_key, L_iterations);
+    run("hw_retrieve_private_spend_key", b_retrieve_private_spend_key, L_iterations);
+    run("hw__generate_key_image", b__generate_key_image, L_iterations);
+    run("hw__generate_ring_signatures", b__generate_ring_signatures, L_iterations);
+
+    printf("\n");
+
+    print_header();
+
+    bench_transaction(1);
+    bench_transaction(16);
+    bench_transaction(TX_MAX_INPUTS);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,1163 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+/**
+ * Differential fuzzing of the hw_* primitives, the varint coder and the
+ * base58 encoder against the independent implementation in ref/. The first
+ * byte of an input picks the target, the rest (zero padded) feeds it.
+ *
+ * Built with -DFUZZ_LIBFUZZER this is a plain libFuzzer target. Otherwise
+ * main() runs the inputs named on the command line (or stdin, for AFL's @@
+ * or a crash reproducer) or, given -runs N, N pseudo random inputs.
+ *
+ * Any disagreement prints the target and the input then aborts. Functions
+ * that draw from cx_rng are checked by verifying their output with the other
+ * implementation instead of comparing bytes.
+ */
+
+#include <base58.h>
+#include <hw_crypto.h>
+#include <nonce_pool.h>
+#include <sc25519.h>
+#include <scratch.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <varint.h>
+
+#include "ref/ref_crypto.h"
+
+#define FUZZ_INPUT_SIZE 384
+
+#define DEFAULT_RUNS 2000
+
+unsigned char G_working_set[WORKING_SET_SIZE];
+
+unsigned char G_tx_working_set[TX_WORKING_SET_SIZE];
+
+static const unsigned char *L_input;
+
+static size_t L_input_size;
+
+static const char *L_target;
+
+static void fuzz_fail(const char *what)
+{
+    fprintf(stderr, "fuzz: %s: %s\ninput: ", L_target, what);
+
+    for (size_t i = 0; i < L_input_size; i++)
+    {
+        fprintf(stderr, "%02x", L_input[i]);
+    }
+
+    fprintf(stderr, "\n");
+
+    abort();
+}
+
+#define EXPECT(condition, what) \
+    if (!(condition))           \
+    {                           \
+        fuzz_fail(what);        \
+    }
+
+/**
+ * Calls into the app and checks that no try context was left behind, a
+ * return from inside TRY without CLOSE_TRY would leave a dangling one
+ */
+#define HW_CALL(expression)                                                             \
+    ({                                                                                  \
+        try_context_t *__context = try_context_get();                                   \
+        const uint16_t __status = (expression);                                         \
+        EXPECT(try_context_get() == __context, "try context leaked by " #expression);   \
+        __status;                                                                       \
+    })
+
+/**
+ * Maps a check result onto 1 (valid), 0 (invalid) or -1 (error) so that the
+ * app's status codes can be compared with the reference
+ */
+static int check_class(const uint16_t status)
+{
+    return status == 1 ? 1 : (status == 0 ? 0 : -1);
+}
+
+/**
+ * Stretches the input into as much key material as a target needs
+ */
+static void expand(unsigned char *out, const size_t length, const unsigned char *seed, const unsigned char label)
+{
+    unsigned char buffer[KEY_SIZE + 2];
+
+    memcpy(buffer, seed, KEY_SIZE);
+
+    buffer[KEY_SIZE] = label;
+
+    for (size_t i = 0; i * KEY_SIZE < length; i++)
+    {
+        unsigned char block[KEY_SIZE];
+
+        buffer[KEY_SIZE + 1] = (unsigned char)i;
+
+        ref_keccak(buffer, sizeof(buffer), block);
+
+        memcpy(out + (i * KEY_SIZE), block, length - (i * KEY_SIZE) < KEY_SIZE ? length - (i * KEY_SIZE) : KEY_SIZE);
+    }
+}
+
+static uint32_t read_uint32(const unsigned char *in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+static uint64_t read_uint64(const unsigned char *in)
+{
+    return (uint64_t)read_uint32(in) | ((uint64_t)read_uint32(in + 4) << 32);
+}
+
+static uint16_t
+    hw_encode_varint(unsigned char *out, const uint64_t value, const size_t max_length, unsigned int *length)
+{
+    BEGIN_TRY
+    {
+        TRY
+        {
+            *length = encode_varint(out, value, max_length);
+
+            CLOSE_TRY;
+
+            return OP_OK;
+        }
+        CATCH_OTHER(e)
+        {
+            return e;
+        }
+        FINALLY {}
+    }
+    END_TRY;
+}
+
+static uint16_t
+    hw_decode_varint(const unsigned char *in, const size_t max_length, uint64_t *value, unsigned int *length)
+{
+    BEGIN_TRY
+    {
+        TRY
+        {
+            *length = decode_varint(in, max_length, value);
+
+            CLOSE_TRY;
+
+            return OP_OK;
+        }
+        CATCH_OTHER(e)
+        {
+            return e;
+        }
+        FINALLY {}
+    }
+    END_TRY;
+}
+
+/**
+ * A wallet and an output sent to it, derived by the reference
+ */
+typedef struct
+{
+    unsigned char tx_public_key[KEY_SIZE];
+
+    unsigned char private_view[KEY_SIZE];
+
+    unsigned char private_spend[KEY_SIZE];
+
+    unsigned char public_spend[KEY_SIZE];
+
+    uint32_t output_index;
+
+    unsigned char derivation[KEY_SIZE];
+
+    unsigned char output_key[KEY_SIZE];
+
+    unsigned char private_ephemeral[KEY_SIZE];
+
+    int valid;
+} output_t;
+
+/**
+ * Uses 100 bytes of input. Bit 0 of the flags leaves the transaction public
+ * key unchecked, bit 1 damages the output key so that it is not ours
+ */
+static void make_output(output_t *output, const unsigned char *in)
+{
+    const unsigned char flags = in[99];
+
+    if (flags & 1)
+    {
+        memcpy(output->tx_public_key, in, KEY_SIZE);
+    }
+    else
+    {
+        unsigned char r[KEY_SIZE];
+
+        ref_sc_reduce32(r, in);
+
+        ref_scalarmult_base(output->tx_public_key, r);
+    }
+
+    ref_sc_reduce32(output->private_view, in + 32);
+
+    ref_sc_reduce32(output->private_spend, in + 64);
+
+    ref_scalarmult_base(output->public_spend, output->private_spend);
+
+    output->output_index = read_uint32(in + 96) & 0xffffff;
+
+    output->valid = ref_generate_key_derivation(output->derivation, output->tx_public_key, output->private_view) == 0
+                    && ref_derive_public_key(
+                           output->output_key, output->derivation, output->output_index, output->public_spend)
+                           == 0;
+
+    if (!output->valid)
+    {
+        memset(output->derivation, 0, KEY_SIZE);
+
+        memset(output->output_key, 0, KEY_SIZE);
+    }
+
+    ref_derive_secret_key(output->private_ephemeral, output->derivation, output->output_index, output->private_spend);
+
+    if (flags & 2)
+    {
+        output->output_key[flags % KEY_SIZE] ^= 0x01;
+
+        output->valid = 0;
+    }
+}
+
+static void t_keccak(const unsigned char *in, const size_t size)
+{
+    unsigned char hw[KEY_SIZE], ref[KEY_SIZE];
+
+    EXPECT(HW_CALL(hw_keccak(in, size, hw)) == OP_OK, "hw_keccak failed");
+
+    ref_keccak(in, size, ref);
+
+    EXPECT(memcmp(hw, ref, KEY_SIZE) == 0, "digests differ");
+}
+
+static void t_encode_varint(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    unsigned char hw[16] = {0}, ref[16] = {0};
+
+    unsigned int hw_length = 0;
+
+    const uint64_t value = read_uint64(in) >> (in[8] % 64);
+
+    const size_t max_length = 1 + (in[9] % 10);
+
+    const uint16_t status = HW_CALL(hw_encode_varint(hw, value, max_length, &hw_length));
+
+    const unsigned int ref_length = ref_encode_varint(ref, value);
+
+    if (ref_length > max_length)
+    {
+        EXPECT(status == ERR_VARINT_DATA_RANGE, "overlong value accepted");
+    }
+    else
+    {
+        EXPECT(status == OP_OK, "encode failed");
+
+        EXPECT(hw_length == ref_length && memcmp(hw, ref, ref_length) == 0, "encodings differ");
+    }
+}
+
+static void t_decode_varint(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    uint64_t hw_value = 0, ref_value = 0;
+
+    unsigned int hw_length = 0;
+
+    // a varint of ten bytes already covers 64 bits
+    const size_t max_length = 1 + (in[0] % 10);
+
+    const uint16_t status = HW_CALL(hw_decode_varint(in + 1, max_length, &hw_value, &hw_length));
+
+    const int ref_length = ref_decode_varint(in + 1, max_length, &ref_value);
+
+    if (ref_length < 0)
+    {
+        EXPECT(status == ERR_VARINT_DATA_RANGE, "unterminated varint accepted");
+    }
+    else
+    {
+        EXPECT(status == OP_OK, "decode failed");
+
+        EXPECT(hw_length == (unsigned int)ref_length && hw_value == ref_value, "decodings differ");
+    }
+}
+
+static void t_base58(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    unsigned char hw[BASE58_ADDRESS_STR_SIZE] = {0};
+
+    char ref[BASE58_ADDRESS_STR_SIZE + 16];
+
+    EXPECT(HW_CALL(base58_encode(in, hw)) == OP_OK, "base58_encode failed");
+
+    ref_base58_encode(in, RAW_ADDRESS_SIZE, ref);
+
+    EXPECT(strlen(ref) == BASE58_ADDRESS_SIZE, "unexpected reference length");
+
+    EXPECT(memcmp(hw, ref, BASE58_ADDRESS_SIZE) == 0, "encodings differ");
+}
+
+static void t_check_scalar(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    EXPECT(HW_CALL(hw_check_scalar(in)) == (uint16_t)ref_sc_check(in), "canonical scalar check differs");
+}
+
+static void t_check_key(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    /**
+     * hw_check_key only guards against a private key passed as a public one;
+     * it does not decompress, so it cannot agree with ref_check_key. Check
+     * that it keeps to that contract instead
+     */
+    EXPECT(HW_CALL(hw_check_key(in)) == (uint16_t)!ref_sc_check(in), "key check differs");
+}
+
+static void t_check_batches(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+#define FUZZ_CHECK_COUNT (FUZZ_INPUT_SIZE / KEY_SIZE)
+
+    unsigned char values[FUZZ_INPUT_SIZE];
+
+    unsigned char keys[2] = {0}, scalars[2] = {0}, expected_keys[2] = {0}, expected_scalars[2] = {0};
+
+    memcpy(values, in, sizeof(values));
+
+    for (int i = 0; i < FUZZ_CHECK_COUNT; i++)
+    {
+        // random bytes are rarely canonical, so reduce every other value to cover both outcomes
+        if (i & 1)
+        {
+            ref_sc_reduce32(values + (i * KEY_SIZE), values + (i * KEY_SIZE));
+        }
+
+        if (ref_sc_check(values + (i * KEY_SIZE)))
+        {
+            expected_scalars[i / 8] |= 1 << (i % 8);
+        }
+        else
+        {
+            expected_keys[i / 8] |= 1 << (i % 8);
+        }
+    }
+
+    EXPECT(HW_CALL(hw_check_keys(keys, values, FUZZ_CHECK_COUNT)) == OP_OK, "hw_check_keys failed");
+
+    EXPECT(HW_CALL(hw_check_scalars(scalars, values, FUZZ_CHECK_COUNT)) == OP_OK, "hw_check_scalars failed");
+
+    EXPECT(memcmp(keys, expected_keys, sizeof(keys)) == 0, "key batch checks differ");
+
+    EXPECT(memcmp(scalars, expected_scalars, sizeof(scalars)) == 0, "scalar batch checks differ");
+
+#undef FUZZ_CHECK_COUNT
+}
+
+static void t_private_to_public(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    unsigned char scalar[KEY_SIZE], hw[KEY_SIZE], ref[KEY_SIZE];
+
+    ref_sc_reduce32(scalar, in);
+
+    EXPECT(HW_CALL(hw_private_key_to_public_key(hw, scalar)) == OP_OK, "hw_private_key_to_public_key failed");
+
+    ref_scalarmult_base(ref, scalar);
+
+    EXPECT(memcmp(hw, ref, KEY_SIZE) == 0, "public keys differ");
+}
+
+static void t_key_derivation(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    unsigned char scalar[KEY_SIZE], hw[KEY_SIZE], ref[KEY_SIZE];
+
+    ref_sc_reduce32(scalar, in + 32);
+
+    const uint16_t status = HW_CALL(hw_generate_key_derivation(hw, in, scalar));
+
+    if (ref_generate_key_derivation(ref, in, scalar) != 0)
+    {
+        EXPECT(status != OP_OK, "invalid point accepted");
+    }
+    else
+    {
+        EXPECT(status == OP_OK, "valid point rejected");
+
+        EXPECT(memcmp(hw, ref, KEY_SIZE) == 0, "derivations differ");
+    }
+}
+
+static void t_derive_public_key(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    unsigned char hw[KEY_SIZE], ref[KEY_SIZE];
+
+    const uint32_t output_index = read_uint32(in + 64);
+
+    const uint16_t status = HW_CALL(hw_derive_public_key(hw, in, output_index, in + 32));
+
+    if (ref_derive_public_key(ref, in, output_index, in + 32) != 0)
+    {
+        EXPECT(status != OP_OK, "invalid point accepted");
+    }
+    else
+    {
+        EXPECT(status == OP_OK, "valid point rejected");
+
+        EXPECT(memcmp(hw, ref, KEY_SIZE) == 0, "public keys differ");
+    }
+}
+
+static void t_derive_secret_key(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    unsigned char base[KEY_SIZE], hw[KEY_SIZE], ref[KEY_SIZE];
+
+    const uint32_t output_index = read_uint32(in + 64);
+
+    ref_sc_reduce32(base, in + 32);
+
+    EXPECT(HW_CALL(hw_derive_secret_key(hw, in, output_index, base)) == OP_OK, "hw_derive_secret_key failed");
+
+    ref_derive_secret_key(ref, in, output_index, base);
+
+    EXPECT(memcmp(hw, ref, KEY_SIZE) == 0, "secret keys differ");
+}
+
+static void t__generate_key_image(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    unsigned char scalar[KEY_SIZE], hw[KEY_SIZE], ref[KEY_SIZE];
+
+    ref_sc_reduce32(scalar, in + 32);
+
+    const uint16_t status = HW_CALL(hw__generate_key_image(hw, in, scalar));
+
+    EXPECT(ref_generate_key_image(ref, in, scalar) == 0, "hash to point failed");
+
+    EXPECT(status == OP_OK, "hw__generate_key_image failed");
+
+    EXPECT(memcmp(hw, ref, KEY_SIZE) == 0, "key images differ");
+}
+
+static void t_generate_key_image(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    output_t output;
+
+    unsigned char hw[KEY_SIZE], ref[KEY_SIZE];
+
+    make_output(&output, in);
+
+    const uint16_t status = HW_CALL(hw_generate_key_image(
+        hw,
+        output.tx_public_key,
+        output.output_index,
+        output.output_key,
+        output.private_view,
+        output.private_spend,
+        output.public_spend));
+
+    if (!output.valid)
+    {
+        EXPECT(status != OP_OK, "output that is not ours accepted");
+
+        return;
+    }
+
+    EXPECT(status == OP_OK, "hw_generate_key_image failed");
+
+    ref_generate_key_image(ref, output.output_key, output.private_ephemeral);
+
+    EXPECT(memcmp(hw, ref, KEY_SIZE) == 0, "key images differ");
+}
+
+static void t_key_image_primitive(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    output_t output;
+
+    unsigned char hw[KEY_SIZE], ref[KEY_SIZE];
+
+    make_output(&output, in);
+
+    const uint16_t status = HW_CALL(hw_generate_key_image_primitive(
+        hw, output.derivation, output.output_index, output.output_key, output.private_spend, output.public_spend));
+
+    if (!output.valid)
+    {
+        // an invalid transaction key leaves the derivation meaningless, but still not ours
+        EXPECT(status != OP_OK, "output that is not ours accepted");
+
+        return;
+    }
+
+    EXPECT(status == OP_OK, "hw_generate_key_image_primitive failed");
+
+    ref_generate_key_image(ref, output.output_key, output.private_ephemeral);
+
+    EXPECT(memcmp(hw, ref, KEY_SIZE) == 0, "key images differ");
+}
+
+static void t_private_view_key(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    unsigned char hw[KEY_SIZE], ref[KEY_SIZE];
+
+    EXPECT(HW_CALL(hw_generate_private_view_key(hw, in)) == OP_OK, "hw_generate_private_view_key failed");
+
+    ref_hash_to_scalar(ref, in, KEY_SIZE);
+
+    EXPECT(memcmp(hw, ref, KEY_SIZE) == 0, "view keys differ");
+}
+
+/**
+ * Puts between 0 and NONCE_POOL_SIZE nonces in the pool, so that signing
+ * runs with it full, partly drained or empty
+ */
+static void fill_nonce_pool(const unsigned char selector)
+{
+    nonce_pool_clear();
+
+    for (unsigned int i = 0; i < selector % (NONCE_POOL_SIZE + 1); i++)
+    {
+        nonce_pool_tick();
+    }
+}
+
+static void t_generate_signature(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    unsigned char private_key[KEY_SIZE], public_key[KEY_SIZE], signature[SIG_SIZE];
+
+    ref_sc_reduce32(private_key, in + 32);
+
+    ref_scalarmult_base(public_key, private_key);
+
+    fill_nonce_pool(in[64]);
+
+    EXPECT(HW_CALL(hw_generate_signature(signature, in, public_key, private_key)) == OP_OK,
+           "hw_generate_signature failed");
+
+    EXPECT(ref_check_signature(in, public_key, signature) == 1, "signature rejected by the reference");
+}
+
+#define FUZZ_BATCH_SIZE 3
+
+static void t_generate_signatures(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    unsigned char private_key[KEY_SIZE], public_key[KEY_SIZE], signatures[SIG_SIZE * FUZZ_BATCH_SIZE];
+
+    const size_t count = 1 + (in[128] % FUZZ_BATCH_SIZE);
+
+    ref_sc_reduce32(private_key, in + 96);
+
+    ref_scalarmult_base(public_key, private_key);
+
+    // a pool that runs dry part way through the batch
+    fill_nonce_pool(in[129]);
+
+    EXPECT(HW_CALL(hw_generate_signatures(signatures, in, count, public_key, private_key)) == OP_OK,
+           "hw_generate_signatures failed");
+
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT(ref_check_signature(in + (i * KEY_SIZE), public_key, signatures + (i * SIG_SIZE)) == 1,
+               "signature rejected by the reference");
+    }
+}
+
+static void t_check_signature(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    unsigned char private_key[KEY_SIZE], public_key[KEY_SIZE], k[KEY_SIZE], signature[SIG_SIZE];
+
+    const unsigned char flags = in[96];
+
+    ref_sc_reduce32(private_key, in + 32);
+
+    ref_sc_reduce32(k, in + 64);
+
+    ref_scalarmult_base(public_key, private_key);
+
+    ref_generate_signature(signature, in, public_key, private_key, k);
+
+    if (flags & 1)
+    {
+        // any key at all, usually not the signer's and sometimes not a point
+        memcpy(public_key, in + 97, KEY_SIZE);
+    }
+
+    if (flags & 2)
+    {
+        signature[in[129] % SIG_SIZE] ^= in[130] | 1;
+
+        ref_sc_reduce32(signature, signature);
+
+        ref_sc_reduce32(signature + KEY_SIZE, signature + KEY_SIZE);
+    }
+
+    const int hw = check_class(HW_CALL(hw_check_signature(in, public_key, signature)));
+
+    const int ref = ref_check_signature(in, public_key, signature);
+
+    EXPECT(hw == ref, "signature checks differ");
+}
+
+static void t_check_signatures(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    unsigned char private_keys[FUZZ_BATCH_SIZE * KEY_SIZE], nonces[FUZZ_BATCH_SIZE * KEY_SIZE];
+
+    unsigned char public_keys[FUZZ_BATCH_SIZE * KEY_SIZE], signatures[FUZZ_BATCH_SIZE * SIG_SIZE];
+
+    unsigned char results = 0, expected = 0;
+
+    const unsigned char flags = in[96];
+
+    expand(private_keys, sizeof(private_keys), in + 32, 'x');
+
+    expand(nonces, sizeof(nonces), in + 64, 'k');
+
+    for (int i = 0; i < FUZZ_BATCH_SIZE; i++)
+    {
+        unsigned char *private_key = private_keys + (i * KEY_SIZE), *k = nonces + (i * KEY_SIZE);
+
+        unsigned char *public_key = public_keys + (i * KEY_SIZE), *signature = signatures + (i * SIG_SIZE);
+
+        ref_sc_reduce32(private_key, private_key);
+
+        ref_sc_reduce32(k, k);
+
+        ref_scalarmult_base(public_key, private_key);
+
+        ref_generate_signature(signature, in, public_key, private_key, k);
+
+        // each signature is broken, or signed by some other key, on its own bits of the flags
+        if (flags & (1 << i))
+        {
+            signature[in[97 + i] % SIG_SIZE] ^= in[100 + i] | 1;
+
+            ref_sc_reduce32(signature, signature);
+
+            ref_sc_reduce32(signature + KEY_SIZE, signature + KEY_SIZE);
+        }
+
+        if (flags & (8 << i))
+        {
+            memcpy(public_key, in + 128 + (i * KEY_SIZE), KEY_SIZE);
+        }
+
+        if (ref_check_signature(in, public_key, signature) == 1)
+        {
+            expected |= 1 << i;
+        }
+    }
+
+    EXPECT(HW_CALL(hw_check_signatures(&results, in, FUZZ_BATCH_SIZE, public_keys, signatures)) == OP_OK,
+           "hw_check_signatures failed");
+
+    EXPECT(results == expected, "signature batch checks differ");
+}
+
+/**
+ * A ring of RING_PARTICIPANTS keys that includes x * G at real_index, and
+ * the key image of x. Uses 64 bytes of input
+ */
+typedef struct
+{
+    unsigned char prefix_hash[KEY_SIZE];
+
+    unsigned char private_key[KEY_SIZE];
+
+    unsigned char public_keys[RING_PARTICIPANTS * KEY_SIZE];
+
+    unsigned char key_image[KEY_SIZE];
+
+    size_t real_index;
+} ring_t;
+
+static void make_ring(ring_t *ring, const unsigned char *in)
+{
+    unsigned char scalars[RING_PARTICIPANTS * KEY_SIZE];
+
+    memcpy(ring->prefix_hash, in, KEY_SIZE);
+
+    expand(scalars, sizeof(scalars), in + 32, 'k');
+
+    ring->real_index = in[32] % RING_PARTICIPANTS;
+
+    for (size_t i = 0; i < RING_PARTICIPANTS; i++)
+    {
+        ref_sc_reduce32(scalars + (i * KEY_SIZE), scalars + (i * KEY_SIZE));
+
+        ref_scalarmult_base(ring->public_keys + (i * KEY_SIZE), scalars + (i * KEY_SIZE));
+    }
+
+    memcpy(ring->private_key, scalars + (ring->real_index * KEY_SIZE), KEY_SIZE);
+
+    ref_generate_key_image(ring->key_image, ring->public_keys + (ring->real_index * KEY_SIZE), ring->private_key);
+}
+
+static void t__generate_ring_signatures(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    ring_t ring;
+
+    unsigned char signatures[SIG_SET_SIZE];
+
+    make_ring(&ring, in);
+
+    fill_nonce_pool(in[64]);
+
+    EXPECT(HW_CALL(hw__generate_ring_signatures(
+               signatures, ring.prefix_hash, ring.key_image, ring.public_keys, ring.private_key, ring.real_index))
+               == OP_OK,
+           "hw__generate_ring_signatures failed");
+
+    EXPECT(
+        ref_check_ring_signatures(ring.prefix_hash, ring.key_image, ring.public_keys, RING_PARTICIPANTS, signatures)
+            == 1,
+        "ring signatures rejected by the reference");
+}
+
+static void t_check_ring_signatures(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    ring_t ring;
+
+    unsigned char randomness[RING_PARTICIPANTS * SIG_SIZE], signatures[SIG_SET_SIZE];
+
+    const unsigned char flags = in[64];
+
+    make_ring(&ring, in);
+
+    expand(randomness, sizeof(randomness), in + 32, 'r');
+
+    EXPECT(ref_generate_ring_signatures(
+               signatures,
+               ring.prefix_hash,
+               ring.key_image,
+               ring.public_keys,
+               RING_PARTICIPANTS,
+               ring.private_key,
+               ring.real_index,
+               randomness)
+               == 0,
+           "reference ring signing failed");
+
+    if (flags & 1)
+    {
+        // a key from the input, which need not be a point
+        memcpy(ring.public_keys + ((flags >> 4) % RING_PARTICIPANTS) * KEY_SIZE, in + 65, KEY_SIZE);
+    }
+
+    if (flags & 2)
+    {
+        memcpy(ring.key_image, in + 97, KEY_SIZE);
+    }
+
+    if (flags & 4)
+    {
+        const size_t position = in[129] % SIG_SET_SIZE;
+
+        signatures[position] ^= in[130] | 1;
+
+        ref_sc_reduce32(signatures + (position / KEY_SIZE) * KEY_SIZE, signatures + (position / KEY_SIZE) * KEY_SIZE);
+    }
+
+    const int hw = check_class(
+        HW_CALL(hw_check_ring_signatures(ring.prefix_hash, ring.key_image, ring.public_keys, signatures)));
+
+    const int ref =
+        ref_check_ring_signatures(ring.prefix_hash, ring.key_image, ring.public_keys, RING_PARTICIPANTS, signatures);
+
+    EXPECT(hw == ref, "ring signature checks differ");
+
+    // once with the ring members to be hashed and again with all of them cached
+    hp_cache_t cache = {0};
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const int cached = check_class(HW_CALL(
+            hw_check_ring_signatures_cached(ring.prefix_hash, ring.key_image, ring.public_keys, signatures, &cache)));
+
+        EXPECT(cached == ref, "cached ring signature checks differ");
+    }
+}
+
+static void t_complete_ring_signature(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    output_t output;
+
+    unsigned char k[KEY_SIZE], hw[SIG_SIZE], ref[KEY_SIZE];
+
+    make_output(&output, in);
+
+    ref_sc_reduce32(hw, in + 100);
+
+    ref_sc_reduce32(k, in + 132);
+
+    const uint16_t status = HW_CALL(hw_complete_ring_signature(
+        hw,
+        output.tx_public_key,
+        output.output_index,
+        output.output_key,
+        k,
+        output.private_view,
+        output.private_spend,
+        output.public_spend));
+
+    if (!output.valid)
+    {
+        EXPECT(status != OP_OK, "output that is not ours accepted");
+
+        return;
+    }
+
+    EXPECT(status == OP_OK, "hw_complete_ring_signature failed");
+
+    ref_sc_mulsub(ref, hw, output.private_ephemeral, k);
+
+    EXPECT(memcmp(hw + KEY_SIZE, ref, KEY_SIZE) == 0, "completed signatures differ");
+}
+
+static void t_generate_ring_signatures(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    output_t output;
+
+    ring_t ring;
+
+    unsigned char key_image[KEY_SIZE], signatures[SIG_SET_SIZE];
+
+    make_output(&output, in);
+
+    make_ring(&ring, in + 100);
+
+    memcpy(ring.public_keys + (ring.real_index * KEY_SIZE), output.output_key, KEY_SIZE);
+
+    const uint16_t status = HW_CALL(hw_generate_ring_signatures(
+        signatures,
+        output.tx_public_key,
+        output.output_index,
+        output.output_key,
+        ring.prefix_hash,
+        ring.public_keys,
+        ring.real_index,
+        output.private_view,
+        output.private_spend,
+        output.public_spend));
+
+    if (!output.valid)
+    {
+        EXPECT(status != OP_OK, "output that is not ours accepted");
+
+        return;
+    }
+
+    EXPECT(status == OP_OK, "hw_generate_ring_signatures failed");
+
+    ref_generate_key_image(key_image, output.output_key, output.private_ephemeral);
+
+    EXPECT(
+        ref_check_ring_signatures(ring.prefix_hash, key_image, ring.public_keys, RING_PARTICIPANTS, signatures) == 1,
+        "ring signatures rejected by the reference");
+}
+
+/**
+ * The software scalar kernels on any 256-bit input, whichever backend the
+ * hw_* functions were built with. Bits of the last byte swap an operand for
+ * all ones so that the largest inputs are always covered
+ */
+static void t_sc25519(const unsigned char *in, const size_t size)
+{
+    UNUSED(size);
+
+    unsigned char a[KEY_SIZE], b[KEY_SIZE], c[KEY_SIZE], sw[KEY_SIZE], ref[KEY_SIZE];
+
+    const unsigned char flags = in[97];
+
+    memcpy(a, in, KEY_SIZE);
+
+    memcpy(b, in + 32, KEY_SIZE);
+
+    memcpy(c, in + 64, KEY_SIZE);
+
+    if (flags & 0x10)
+    {
+        memset(a, 0xff, KEY_SIZE);
+    }
+
+    if (flags & 0x20)
+    {
+        memset(b, 0xff, KEY_SIZE);
+    }
+
+    switch (in[96] % 5)
+    {
+        case 0:
+            sc25519_reduce32(sw, a);
+
+            ref_sc_reduce32(ref, a);
+
+            break;
+        case 1:
+            sc25519_add(sw, a, b);
+
+            ref_sc_add(ref, a, b);
+
+            break;
+        case 2:
+            sc25519_sub(sw, a, b);
+
+            ref_sc_sub(ref, a, b);
+
+            break;
+        case 3:
+            sc25519_mul(sw, a, b);
+
+            ref_sc_mulsub(ref, a, b, (const unsigned char[KEY_SIZE]) {0});
+
+            ref_sc_sub(ref, (const unsigned char[KEY_SIZE]) {0}, ref);
+
+            break;
+        default:
+            sc25519_mulsub(sw, a, b, c);
+
+            ref_sc_mulsub(ref, a, b, c);
+
+            break;
+    }
+
+    EXPECT(memcmp(sw, ref, KEY_SIZE) == 0, "scalars differ");
+}
+
+typedef struct
+{
+    const char *name;
+
+    void (*fn)(const unsigned char *, const size_t);
+} target_t;
+
+static const target_t C_TARGETS[] = {
+    {"hw_keccak", t_keccak},
+    {"encode_varint", t_encode_varint},
+    {"decode_varint", t_decode_varint},
+    {"base58_encode", t_base58},
+    {"hw_check_scalar", t_check_scalar},
+    {"hw_check_key", t_check_key},
+    {"hw_check_keys / hw_check_scalars", t_check_batches},
+    {"hw_private_key_to_public_key", t_private_to_public},
+    {"hw_generate_key_derivation", t_key_derivation},
+    {"hw_derive_public_key", t_derive_public_key},
+    {"hw_derive_secret_key", t_derive_secret_key},
+    {"hw__generate_key_image", t__generate_key_image},
+    {"hw_generate_key_image", t_generate_key_image},
+    {"hw_generate_key_image_primitive", t_key_image_primitive},
+    {"hw_generate_private_view_key", t_private_view_key},
+    {"hw_generate_signature", t_generate_signature},
+    {"hw_generate_signatures", t_generate_signatures},
+    {"hw_check_signature", t_check_signature},
+    {"hw_check_signatures", t_check_signatures},
+    {"hw__generate_ring_signatures", t__generate_ring_signatures},
+    {"hw_check_ring_signatures", t_check_ring_signatures},
+    {"hw_complete_ring_signature", t_complete_ring_signature},
+    {"hw_generate_ring_signatures", t_generate_ring_signatures},
+    {"sc25519", t_sc25519}};
+
+#define TARGET_COUNT (sizeof(C_TARGETS) / sizeof(C_TARGETS[0]))
+
+static unsigned long long L_runs[TARGET_COUNT];
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    static int self_tested = 0;
+
+    unsigned char in[FUZZ_INPUT_SIZE] = {0};
+
+    if (!self_tested)
+    {
+        L_target = "ref_self_test";
+
+        EXPECT(ref_self_test(), "reference implementation failed its self test");
+
+        self_tested = 1;
+    }
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    const size_t target = data[0] % TARGET_COUNT;
+
+    const size_t length = size - 1 < FUZZ_INPUT_SIZE ? size - 1 : FUZZ_INPUT_SIZE;
+
+    memcpy(in, data + 1, length);
+
+    L_input = data;
+
+    L_input_size = size;
+
+    L_target = C_TARGETS[target].name;
+
+    C_TARGETS[target].fn(in, length);
+
+    // every region must be released, in order and without being written past its end
+    EXPECT(scratch_in_use() == 0 && scratch_faults() == 0, "scratch region leaked, overrun or released out of order");
+
+    L_runs[target]++;
+
+    return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+
+static uint64_t L_rng_state = 0x7475727465636f69ULL;
+
+static uint64_t splitmix64(void)
+{
+    uint64_t z = (L_rng_state += 0x9e3779b97f4a7c15ULL);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+    return z ^ (z >> 31);
+}
+
+static int run_file(FILE *file)
+{
+    static unsigned char data[1 + FUZZ_INPUT_SIZE];
+
+    const size_t size = fread(data, 1, sizeof(data), file);
+
+    return LLVMFuzzerTestOneInput(data, size);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long long runs = 0;
+
+    if (argc == 1)
+    {
+        return run_file(stdin);
+    }
+
+    if (argc == 3 && strcmp(argv[1], "-runs") == 0)
+    {
+        runs = strtoull(argv[2], NULL, 10);
+
+        if (runs == 0)
+        {
+            runs = DEFAULT_RUNS;
+        }
+    }
+    else
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            FILE *file = fopen(argv[i], "rb");
+
+            if (file == NULL)
+            {
+                fprintf(stderr, "fuzz: cannot open %s\n", argv[i]);
+
+                return 1;
+            }
+
+            run_file(file);
+
+            fclose(file);
+        }
+
+        return 0;
+    }
+
+    for (unsigned long long i = 0; i < runs; i++)
+    {
+        unsigned char data[1 + FUZZ_INPUT_SIZE];
+
+        const size_t size = 1 + (size_t)(splitmix64() % FUZZ_INPUT_SIZE);
+
+        for (size_t j = 0; j < size; j += 8)
+        {
+            const uint64_t value = splitmix64();
+
+            memcpy(data + j, &value, size - j < 8 ? size - j : 8);
+        }
+
+        // visit every target in turn
+        data[0] = (unsigned char)(i % TARGET_COUNT);
+
+        LLVMFuzzerTestOneInput(data, size);
+    }
+
+    for (size_t i = 0; i < TARGET_COUNT; i++)
+    {
+        printf("%-36s %10llu runs\n", C_TARGETS[i].name, L_runs[i]);
+    }
+
+    printf("%llu inputs, no differences\n", runs);
+
+    return 0;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,1459 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "ref_crypto.h"
+
+#include <string.h>
+
+/**
+ * Field elements mod p = 2^255 - 19 as sixteen 16-bit limbs held in int64_t
+ * so that the intermediate products do not overflow (after TweetNaCl)
+ */
+typedef int64_t gf[16];
+
+static const gf gf0;
+
+static const gf gf1 = {1};
+
+static const gf C_D = {0x78a3, 0x1359, 0x4dca, 0x75eb, 0xd8ab, 0x4141, 0x0a4d, 0x0070,
+                       0xe898, 0x7779, 0x4079, 0x8cc7, 0xfe73, 0x2b6f, 0x6cee, 0x5203};
+
+static const gf C_D2 = {0xf159, 0x26b2, 0x9b94, 0xebd6, 0xb156, 0x8283, 0x149a, 0x00e0,
+                        0xd130, 0xeef3, 0x80f2, 0x198e, 0xfce7, 0x56df, 0xd9dc, 0x2406};
+
+static const gf C_X = {0xd51a, 0x8f25, 0x2d60, 0xc956, 0xa7b2, 0x9525, 0xc760, 0x692c,
+                       0xdc5c, 0xfdd6, 0xe231, 0xc0a4, 0x53fe, 0xcd6e, 0x36d3, 0x2169};
+
+static const gf C_Y = {0x6658, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666,
+                       0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666};
+
+static const gf C_SQRTM1 = {0xa0b0, 0x4a0e, 0x1b27, 0xc4ee, 0xe478, 0xad2f, 0x1806, 0x2f43,
+                            0xd7a7, 0x3dfb, 0x0099, 0x2b4d, 0xdf0b, 0x4fc1, 0x2480, 0x2b83};
+
+// the group order l, little endian
+static const int64_t C_L[32] = {0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7,
+                                0xa2, 0xde, 0xf9, 0xde, 0x14, 0,    0,    0,    0,    0,    0,
+                                0,    0,    0,    0,    0,    0,    0,    0,    0,    0x10};
+
+#define MONTGOMERY_A 486662
+
+static void set25519(gf r, const gf a)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        r[i] = a[i];
+    }
+}
+
+static void car25519(gf o)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        o[i] += (1LL << 16);
+
+        const int64_t c = o[i] >> 16;
+
+        o[(i + 1) * (i < 15)] += c - 1 + 37 * (c - 1) * (i == 15);
+
+        o[i] -= c << 16;
+    }
+}
+
+static void sel25519(gf p, gf q, int b)
+{
+    const int64_t c = ~(b - 1);
+
+    for (int i = 0; i < 16; i++)
+    {
+        const int64_t t = c & (p[i] ^ q[i]);
+
+        p[i] ^= t;
+
+        q[i] ^= t;
+    }
+}
+
+static void pack25519(unsigned char *o, const gf n)
+{
+    gf m, t;
+
+    set25519(t, n);
+
+    car25519(t);
+
+    car25519(t);
+
+    car25519(t);
+
+    for (int j = 0; j < 2; j++)
+    {
+        m[0] = t[0] - 0xffed;
+
+        for (int i = 1; i < 15; i++)
+        {
+            m[i] = t[i] - 0xffff - ((m[i - 1] >> 16) & 1);
+
+            m[i - 1] &= 0xffff;
+        }
+
+        m[15] = t[15] - 0x7fff - ((m[14] >> 16) & 1);
+
+        const int b = (m[15] >> 16) & 1;
+
+        m[14] &= 0xffff;
+
+        sel25519(t, m, 1 - b);
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+        o[2 * i] = t[i] & 0xff;
+
+        o[2 * i + 1] = t[i] >> 8;
+    }
+}
+
+static int neq25519(const gf a, const gf b)
+{
+    unsigned char c[32], d[32];
+
+    pack25519(c, a);
+
+    pack25519(d, b);
+
+    return memcmp(c, d, 32) != 0;
+}
+
+static int par25519(const gf a)
+{
+    unsigned char d[32];
+
+    pack25519(d, a);
+
+    return d[0] & 1;
+}
+
+static int iszero25519(const gf a)
+{
+    return !neq25519(a, gf0);
+}
+
+/**
+ * Loads the low 255 bits, as fe_frombytes does
+ */
+static void unpack25519(gf o, const unsigned char *n)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        o[i] = n[2 * i] + ((int64_t)n[2 * i + 1] << 8);
+    }
+
+    o[15] &= 0x7fff;
+}
+
+static void A(gf o, const gf a, const gf b)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        o[i] = a[i] + b[i];
+    }
+}
+
+static void Z(gf o, const gf a, const gf b)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        o[i] = a[i] - b[i];
+    }
+}
+
+static void M(gf o, const gf a, const gf b)
+{
+    int64_t t[31] = {0};
+
+    for (int i = 0; i < 16; i++)
+    {
+        for (int j = 0; j < 16; j++)
+        {
+            t[i + j] += a[i] * b[j];
+        }
+    }
+
+    for (int i = 0; i < 15; i++)
+    {
+        t[i] += 38 * t[i + 16];
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+        o[i] = t[i];
+    }
+
+    car25519(o);
+
+    car25519(o);
+}
+
+static void S(gf o, const gf a)
+{
+    M(o, a, a);
+}
+
+static void inv25519(gf o, const gf i)
+{
+    gf c;
+
+    set25519(c, i);
+
+    // i^(p - 2)
+    for (int a = 253; a >= 0; a--)
+    {
+        S(c, c);
+
+        if (a != 2 && a != 4)
+        {
+            M(c, c, i);
+        }
+    }
+
+    set25519(o, c);
+}
+
+static void pow2523(gf o, const gf i)
+{
+    gf c;
+
+    set25519(c, i);
+
+    // i^((p - 5) / 8) = i^(2^252 - 3)
+    for (int a = 250; a >= 0; a--)
+    {
+        S(c, c);
+
+        if (a != 1)
+        {
+            M(c, c, i);
+        }
+    }
+
+    set25519(o, c);
+}
+
+static void neg25519(gf o, const gf a)
+{
+    Z(o, gf0, a);
+}
+
+/**
+ * Square root of a square, either of the two roots
+ */
+static void sqrt25519(gf o, const gf a)
+{
+    gf t, chk;
+
+    // a^((p + 3) / 8) = a * a^((p - 5) / 8)
+    pow2523(t, a);
+
+    M(t, t, a);
+
+    S(chk, t);
+
+    if (neq25519(chk, a))
+    {
+        M(t, t, C_SQRTM1);
+    }
+
+    set25519(o, t);
+}
+
+static void gf_from_int(gf o, int64_t value)
+{
+    set25519(o, gf0);
+
+    if (value < 0)
+    {
+        gf t = {0};
+
+        t[0] = -value;
+
+        car25519(t);
+
+        neg25519(o, t);
+    }
+    else
+    {
+        o[0] = value;
+
+        car25519(o);
+    }
+}
+
+/**
+ * Points in extended coordinates (X, Y, Z, T)
+ */
+typedef gf point[4];
+
+static void point_add(point p, point q)
+{
+    gf a, b, c, d, t, e, f, g, h;
+
+    Z(a, p[1], p[0]);
+
+    Z(t, q[1], q[0]);
+
+    M(a, a, t);
+
+    A(b, p[0], p[1]);
+
+    A(t, q[0], q[1]);
+
+    M(b, b, t);
+
+    M(c, p[3], q[3]);
+
+    M(c, c, C_D2);
+
+    M(d, p[2], q[2]);
+
+    A(d, d, d);
+
+    Z(e, b, a);
+
+    Z(f, d, c);
+
+    A(g, d, c);
+
+    A(h, b, a);
+
+    M(p[0], e, f);
+
+    M(p[1], h, g);
+
+    M(p[2], g, f);
+
+    M(p[3], e, h);
+}
+
+static void point_cswap(point p, point q, int b)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        sel25519(p[i], q[i], b);
+    }
+}
+
+static void point_pack(unsigned char *r, point p)
+{
+    gf tx, ty, zi;
+
+    inv25519(zi, p[2]);
+
+    M(tx, p[0], zi);
+
+    M(ty, p[1], zi);
+
+    pack25519(r, ty);
+
+    r[31] ^= par25519(tx) << 7;
+}
+
+static void point_identity(point p)
+{
+    set25519(p[0], gf0);
+
+    set25519(p[1], gf1);
+
+    set25519(p[2], gf1);
+
+    set25519(p[3], gf0);
+}
+
+static void point_copy(point r, point p)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        set25519(r[i], p[i]);
+    }
+}
+
+/**
+ * p = s * q for the full 256-bit integer s
+ */
+static void point_scalarmult(point p, point q, const unsigned char *s)
+{
+    point_identity(p);
+
+    for (int i = 255; i >= 0; --i)
+    {
+        const int b = (s[i / 8] >> (i & 7)) & 1;
+
+        point_cswap(p, q, b);
+
+        point_add(q, p);
+
+        point_add(p, p);
+
+        point_cswap(p, q, b);
+    }
+}
+
+static void point_base(point p)
+{
+    set25519(p[0], C_X);
+
+    set25519(p[1], C_Y);
+
+    set25519(p[2], gf1);
+
+    M(p[3], C_X, C_Y);
+}
+
+/**
+ * Decompresses a point with the semantics of CryptoNote's ge_frombytes_vartime:
+ * the y coordinate is taken mod p and a zero x with the sign bit set is refused
+ */
+static int point_unpack(point r, const unsigned char *p)
+{
+    gf t, chk, num, den, den2, den4, den6;
+
+    set25519(r[2], gf1);
+
+    unpack25519(r[1], p);
+
+    S(num, r[1]);
+
+    M(den, num, C_D);
+
+    Z(num, num, r[2]);
+
+    A(den, r[2], den);
+
+    S(den2, den);
+
+    S(den4, den2);
+
+    M(den6, den4, den2);
+
+    M(t, den6, num);
+
+    M(t, t, den);
+
+    pow2523(t, t);
+
+    M(t, t, num);
+
+    M(t, t, den);
+
+    M(t, t, den);
+
+    M(r[0], t, den);
+
+    S(chk, r[0]);
+
+    M(chk, chk, den);
+
+    if (neq25519(chk, num))
+    {
+        M(r[0], r[0], C_SQRTM1);
+    }
+
+    S(chk, r[0]);
+
+    M(chk, chk, den);
+
+    if (neq25519(chk, num))
+    {
+        return -1;
+    }
+
+    if (par25519(r[0]) != (p[31] >> 7))
+    {
+        if (iszero25519(r[0]))
+        {
+            return -1;
+        }
+
+        neg25519(r[0], r[0]);
+    }
+
+    M(r[3], r[0], r[1]);
+
+    return 0;
+}
+
+/**
+ * Reduces the 512-bit little endian value in x mod l
+ */
+static void modL(unsigned char *r, int64_t x[64])
+{
+    int64_t carry;
+
+    int i, j;
+
+    for (i = 63; i >= 32; --i)
+    {
+        carry = 0;
+
+        for (j = i - 32; j < i - 12; ++j)
+        {
+            x[j] += carry - 16 * x[i] * C_L[j - (i - 32)];
+
+            carry = (x[j] + 128) >> 8;
+
+            x[j] -= carry * 256;
+        }
+
+        x[j] += carry;
+
+        x[i] = 0;
+    }
+
+    carry = 0;
+
+    for (j = 0; j < 32; j++)
+    {
+        x[j] += carry - (x[31] >> 4) * C_L[j];
+
+        carry = x[j] >> 8;
+
+        x[j] &= 255;
+    }
+
+    for (j = 0; j < 32; j++)
+    {
+        x[j] -= carry * C_L[j];
+    }
+
+    for (i = 0; i < 32; i++)
+    {
+        x[i + 1] += x[i] >> 8;
+
+        r[i] = x[i] & 255;
+    }
+}
+
+void ref_sc_reduce32(unsigned char *out, const unsigned char *in)
+{
+    int64_t x[64] = {0};
+
+    for (int i = 0; i < 32; i++)
+    {
+        x[i] = in[i];
+    }
+
+    modL(out, x);
+}
+
+int ref_sc_check(const unsigned char *scalar)
+{
+    unsigned char reduced[32];
+
+    ref_sc_reduce32(reduced, scalar);
+
+    return memcmp(reduced, scalar, 32) == 0;
+}
+
+static void sc_mul(unsigned char *r, const unsigned char *a, const unsigned char *b)
+{
+    int64_t x[64] = {0};
+
+    for (int i = 0; i < 32; i++)
+    {
+        for (int j = 0; j < 32; j++)
+        {
+            x[i + j] += (int64_t)a[i] * b[j];
+        }
+    }
+
+    modL(r, x);
+}
+
+void ref_sc_add(unsigned char *r, const unsigned char *a, const unsigned char *b)
+{
+    int64_t x[64] = {0};
+
+    for (int i = 0; i < 32; i++)
+    {
+        x[i] = (int64_t)a[i] + b[i];
+    }
+
+    modL(r, x);
+}
+
+void ref_sc_sub(unsigned char *r, const unsigned char *a, const unsigned char *b)
+{
+    // a - b = a + (l - 1) * b mod l, which keeps every limb non-negative
+    unsigned char minus_one[32];
+
+    unsigned char t[32];
+
+    for (int i = 0; i < 32; i++)
+    {
+        minus_one[i] = (unsigned char)C_L[i];
+    }
+
+    minus_one[0] -= 1;
+
+    sc_mul(t, b, minus_one);
+
+    ref_sc_add(r, a, t);
+}
+
+void ref_sc_mulsub(unsigned char *r, const unsigned char *a, const unsigned char *b, const unsigned char *c)
+{
+    unsigned char ab[32];
+
+    sc_mul(ab, a, b);
+
+    ref_sc_sub(r, c, ab);
+}
+
+/**
+ * Keccak-f[1600] with the rotation offsets and round constants derived from
+ * the specification rather than tabulated
+ */
+static uint64_t rotl64(uint64_t x, unsigned int n)
+{
+    n %= 64;
+
+    return n == 0 ? x : (x << n) | (x >> (64 - n));
+}
+
+static int keccak_rc_bit(unsigned int t)
+{
+    uint8_t r = 1;
+
+    for (unsigned int i = 1; i <= t % 255; i++)
+    {
+        r = (uint8_t)((r << 1) ^ ((r & 0x80) ? 0x71 : 0));
+    }
+
+    return r & 1;
+}
+
+static void keccak_f(uint64_t a[5][5])
+{
+    unsigned int offsets[5][5] = {{0}};
+
+    unsigned int x = 1, y = 0;
+
+    for (unsigned int t = 0; t < 24; t++)
+    {
+        offsets[x][y] = ((t + 1) * (t + 2) / 2) % 64;
+
+        const unsigned int nx = y;
+
+        y = (2 * x + 3 * y) % 5;
+
+        x = nx;
+    }
+
+    for (unsigned int round = 0; round < 24; round++)
+    {
+        uint64_t c[5], d[5], b[5][5];
+
+        // theta
+        for (x = 0; x < 5; x++)
+        {
+            c[x] = a[x][0] ^ a[x][1] ^ a[x][2] ^ a[x][3] ^ a[x][4];
+        }
+
+        for (x = 0; x < 5; x++)
+        {
+            d[x] = c[(x + 4) % 5] ^ rotl64(c[(x + 1) % 5], 1);
+        }
+
+        for (x = 0; x < 5; x++)
+        {
+            for (y = 0; y < 5; y++)
+            {
+                a[x][y] ^= d[x];
+            }
+        }
+
+        // rho and pi
+        for (x = 0; x < 5; x++)
+        {
+            for (y = 0; y < 5; y++)
+            {
+                b[y][(2 * x + 3 * y) % 5] = rotl64(a[x][y], offsets[x][y]);
+            }
+        }
+
+        // chi
+        for (x = 0; x < 5; x++)
+        {
+            for (y = 0; y < 5; y++)
+            {
+                a[x][y] = b[x][y] ^ (~b[(x + 1) % 5][y] & b[(x + 2) % 5][y]);
+            }
+        }
+
+        // iota
+        for (unsigned int j = 0; j < 7; j++)
+        {
+            if (keccak_rc_bit(j + 7 * round))
+            {
+                a[0][0] ^= 1ULL << ((1u << j) - 1);
+            }
+        }
+    }
+}
+
+/**
+ * Keccak-256 with the original padding (0x01 ... 0x80) as used by CryptoNote
+ */
+void ref_keccak(const unsigned char *in, size_t length, unsigned char *out)
+{
+    const size_t rate = 136;
+
+    uint64_t a[5][5] = {{0}};
+
+    unsigned char block[136];
+
+    int done = 0;
+
+    while (!done)
+    {
+        const size_t take = length < rate ? length : rate;
+
+        memset(block, 0, sizeof(block));
+
+        memcpy(block, in, take);
+
+        if (take < rate)
+        {
+            block[take] ^= 0x01;
+
+            block[rate - 1] ^= 0x80;
+
+            done = 1;
+        }
+
+        // lane (x, y) holds bytes 8 * (x + 5 * y) onwards, little endian
+        for (size_t i = 0; i < rate / 8; i++)
+        {
+            uint64_t lane = 0;
+
+            for (int j = 7; j >= 0; j--)
+            {
+                lane = (lane << 8) | block[8 * i + j];
+            }
+
+            a[i % 5][i / 5] ^= lane;
+        }
+
+        keccak_f(a);
+
+        in += take;
+
+        length -= take;
+    }
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 8; j++)
+        {
+            out[8 * i + j] = (unsigned char)(a[i % 5][i / 5] >> (8 * j));
+        }
+    }
+}
+
+void ref_hash_to_scalar(unsigned char *out, const unsigned char *in, size_t length)
+{
+    unsigned char hash[32];
+
+    ref_keccak(in, length, hash);
+
+    ref_sc_reduce32(out, hash);
+}
+
+int ref_check_key(const unsigned char *key)
+{
+    point p;
+
+    return point_unpack(p, key) == 0;
+}
+
+void ref_scalarmult_base(unsigned char *out, const unsigned char *scalar)
+{
+    point p, q;
+
+    point_base(q);
+
+    point_scalarmult(p, q, scalar);
+
+    point_pack(out, p);
+}
+
+int ref_scalarmult(unsigned char *out, const unsigned char *key, const unsigned char *scalar)
+{
+    point p, q;
+
+    if (point_unpack(q, key) != 0)
+    {
+        return -1;
+    }
+
+    point_scalarmult(p, q, scalar);
+
+    point_pack(out, p);
+
+    return 0;
+}
+
+int ref_add(unsigned char *out, const unsigned char *a, const unsigned char *b)
+{
+    point p, q;
+
+    if (point_unpack(p, a) != 0 || point_unpack(q, b) != 0)
+    {
+        return -1;
+    }
+
+    point_add(p, q);
+
+    point_pack(out, p);
+
+    return 0;
+}
+
+static void point_mul8(point p)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        point t;
+
+        point_copy(t, p);
+
+        point_add(p, t);
+    }
+}
+
+/**
+ * CryptoNote's ge_fromfe_frombytes_vartime: an Elligator-style map of the
+ * hash (taken as a full 256-bit value mod p) onto the curve
+ */
+static void point_fromfe(point r, const unsigned char *s)
+{
+    gf u, v, w, x, y, z, t, a, fffb1, fffb2, fffb3, fffb4, ma, ma2, rx;
+
+    int sign;
+
+    // the constants, computed rather than tabulated: any root will do as the sign of x is fixed below
+    gf_from_int(ma, -MONTGOMERY_A);
+
+    gf_from_int(a, MONTGOMERY_A);
+
+    M(ma2, ma, a); // -A^2
+
+    gf_from_int(t, MONTGOMERY_A + 2);
+
+    M(t, t, a); // A * (A + 2)
+
+    A(fffb2, t, t); // 2 * A * (A + 2)
+
+    neg25519(fffb1, fffb2);
+
+    sqrt25519(fffb1, fffb1);
+
+    sqrt25519(fffb2, fffb2);
+
+    M(fffb4, t, C_SQRTM1);
+
+    neg25519(fffb3, fffb4);
+
+    sqrt25519(fffb3, fffb3);
+
+    sqrt25519(fffb4, fffb4);
+
+    // u = s mod p, including bit 255 (2^255 = 19 mod p)
+    unpack25519(u, s);
+
+    if (s[31] & 0x80)
+    {
+        gf nineteen;
+
+        gf_from_int(nineteen, 19);
+
+        A(u, u, nineteen);
+    }
+
+    S(v, u);
+
+    A(v, v, v); // 2 * u^2
+
+    A(w, v, gf1); // 2 * u^2 + 1
+
+    S(x, w);
+
+    M(y, ma2, v);
+
+    A(x, x, y); // w^2 - 2 * A^2 * u^2
+
+    // (w / x)^((p + 3) / 8) = w * x^3 * (w * x^7)^((p - 5) / 8)
+    {
+        gf x3, x7;
+
+        S(x3, x);
+
+        M(x3, x3, x);
+
+        S(x7, x3);
+
+        M(x7, x7, x);
+
+        M(x7, x7, w);
+
+        pow2523(rx, x7);
+
+        M(rx, rx, x3);
+
+        M(rx, rx, w);
+    }
+
+    S(y, rx);
+
+    M(x, y, x);
+
+    Z(y, w, x);
+
+    set25519(z, ma);
+
+    if (!iszero25519(y))
+    {
+        A(y, w, x);
+
+        if (!iszero25519(y))
+        {
+            M(x, x, C_SQRTM1);
+
+            Z(y, w, x);
+
+            M(rx, rx, iszero25519(y) ? fffb4 : fffb3);
+
+            sign = 1;
+
+            goto setsign;
+        }
+
+        M(rx, rx, fffb1);
+    }
+    else
+    {
+        M(rx, rx, fffb2);
+    }
+
+    M(rx, rx, u);
+
+    M(z, z, v);
+
+    sign = 0;
+
+setsign:
+    if (par25519(rx) != sign)
+    {
+        neg25519(rx, rx);
+    }
+
+    // projective (X : Y : Z) = (rx * (z + w) : z - w : z + w)
+    A(r[2], z, w);
+
+    Z(r[1], z, w);
+
+    M(r[0], rx, r[2]);
+
+    M(r[3], r[0], r[1]);
+
+    // keep the extended coordinate consistent: T = XY / Z
+    {
+        gf zi;
+
+        inv25519(zi, r[2]);
+
+        M(r[3], r[3], zi);
+    }
+}
+
+void ref_hash_to_ec(unsigned char *out, const unsigned char *key)
+{
+    unsigned char hash[32];
+
+    point p;
+
+    ref_keccak(key, 32, hash);
+
+    point_fromfe(p, hash);
+
+    point_mul8(p);
+
+    point_pack(out, p);
+}
+
+int ref_generate_key_derivation(unsigned char *out, const unsigned char *key, const unsigned char *scalar)
+{
+    point p, q;
+
+    if (point_unpack(q, key) != 0)
+    {
+        return -1;
+    }
+
+    point_scalarmult(p, q, scalar);
+
+    point_mul8(p);
+
+    point_pack(out, p);
+
+    return 0;
+}
+
+unsigned int ref_encode_varint(unsigned char *out, uint64_t value)
+{
+    unsigned int length = 0;
+
+    do
+    {
+        out[length] = value & 0x7f;
+
+        value >>= 7;
+
+        if (value != 0)
+        {
+            out[length] |= 0x80;
+        }
+
+        length++;
+    } while (value != 0);
+
+    return length;
+}
+
+int ref_decode_varint(const unsigned char *in, size_t max_length, uint64_t *value)
+{
+    uint64_t result = 0;
+
+    for (size_t i = 0; i < max_length; i++)
+    {
+        if (7 * i < 64)
+        {
+            result |= (uint64_t)(in[i] & 0x7f) << (7 * i);
+        }
+
+        if ((in[i] & 0x80) == 0)
+        {
+            *value = result;
+
+            return (int)(i + 1);
+        }
+    }
+
+    return -1;
+}
+
+void ref_derivation_to_scalar(unsigned char *out, const unsigned char *derivation, uint64_t output_index)
+{
+    unsigned char buffer[32 + 10];
+
+    memcpy(buffer, derivation, 32);
+
+    const unsigned int length = ref_encode_varint(buffer + 32, output_index);
+
+    ref_hash_to_scalar(out, buffer, 32 + length);
+}
+
+int ref_derive_public_key(
+    unsigned char *out,
+    const unsigned char *derivation,
+    uint64_t output_index,
+    const unsigned char *base)
+{
+    unsigned char scalar[32], point_bytes[32];
+
+    ref_derivation_to_scalar(scalar, derivation, output_index);
+
+    ref_scalarmult_base(point_bytes, scalar);
+
+    return ref_add(out, point_bytes, base);
+}
+
+void ref_derive_secret_key(
+    unsigned char *out,
+    const unsigned char *derivation,
+    uint64_t output_index,
+    const unsigned char *base)
+{
+    unsigned char scalar[32];
+
+    ref_derivation_to_scalar(scalar, derivation, output_index);
+
+    ref_sc_add(out, scalar, base);
+}
+
+int ref_generate_key_image(unsigned char *out, const unsigned char *public_key, const unsigned char *private_key)
+{
+    unsigned char hp[32];
+
+    ref_hash_to_ec(hp, public_key);
+
+    return ref_scalarmult(out, hp, private_key);
+}
+
+/**
+ * r = a * P + b * G
+ */
+static int
+    double_scalarmult_base(unsigned char *r, const unsigned char *a, const unsigned char *P, const unsigned char *b)
+{
+    unsigned char aP[32], bG[32];
+
+    if (ref_scalarmult(aP, P, a) != 0)
+    {
+        return -1;
+    }
+
+    ref_scalarmult_base(bG, b);
+
+    return ref_add(r, aP, bG);
+}
+
+/**
+ * r = a * P + b * Q
+ */
+static int double_scalarmult(
+    unsigned char *r,
+    const unsigned char *a,
+    const unsigned char *P,
+    const unsigned char *b,
+    const unsigned char *Q)
+{
+    unsigned char aP[32], bQ[32];
+
+    if (ref_scalarmult(aP, P, a) != 0 || ref_scalarmult(bQ, Q, b) != 0)
+    {
+        return -1;
+    }
+
+    return ref_add(r, aP, bQ);
+}
+
+void ref_generate_signature(
+    unsigned char *signature,
+    const unsigned char *message_digest,
+    const unsigned char *public_key,
+    const unsigned char *private_key,
+    const unsigned char *k)
+{
+    unsigned char buffer[96];
+
+    memcpy(buffer, message_digest, 32);
+
+    memcpy(buffer + 32, public_key, 32);
+
+    ref_scalarmult_base(buffer + 64, k);
+
+    ref_hash_to_scalar(signature, buffer, sizeof(buffer));
+
+    ref_sc_mulsub(signature + 32, signature, private_key, k);
+}
+
+int ref_check_signature(
+    const unsigned char *message_digest,
+    const unsigned char *public_key,
+    const unsigned char *signature)
+{
+    unsigned char buffer[96], c[32];
+
+    memcpy(buffer, message_digest, 32);
+
+    memcpy(buffer + 32, public_key, 32);
+
+    if (double_scalarmult_base(buffer + 64, signature, public_key, signature + 32) != 0)
+    {
+        return -1;
+    }
+
+    ref_hash_to_scalar(c, buffer, sizeof(buffer));
+
+    ref_sc_sub(c, c, signature);
+
+    for (int i = 0; i < 32; i++)
+    {
+        if (c[i] != 0)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+#define REF_MAX_RING 16
+
+int ref_generate_ring_signatures(
+    unsigned char *signatures,
+    const unsigned char *prefix_hash,
+    const unsigned char *key_image,
+    const unsigned char *public_keys,
+    size_t count,
+    const unsigned char *private_key,
+    size_t real_index,
+    const unsigned char *randomness)
+{
+    unsigned char buffer[32 + (REF_MAX_RING * 64)], sum[32] = {0}, k[32], h[32];
+
+    if (count > REF_MAX_RING || real_index >= count)
+    {
+        return -1;
+    }
+
+    memcpy(buffer, prefix_hash, 32);
+
+    // the caller supplies count * 2 scalars: k, then (c, r) for every other member
+    ref_sc_reduce32(k, randomness);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        unsigned char *L = buffer + 32 + (i * 64);
+
+        unsigned char *R = L + 32;
+
+        unsigned char hp[32];
+
+        ref_hash_to_ec(hp, public_keys + (i * 32));
+
+        if (i == real_index)
+        {
+            ref_scalarmult_base(L, k);
+
+            if (ref_scalarmult(R, hp, k) != 0)
+            {
+                return -1;
+            }
+        }
+        else
+        {
+            unsigned char *c = signatures + (i * 64);
+
+            unsigned char *r = c + 32;
+
+            ref_sc_reduce32(c, randomness + 32 + (i * 64));
+
+            ref_sc_reduce32(r, randomness + 64 + (i * 64));
+
+            if (double_scalarmult_base(L, c, public_keys + (i * 32), r) != 0
+                || double_scalarmult(R, r, hp, c, key_image) != 0)
+            {
+                return -1;
+            }
+
+            ref_sc_add(sum, sum, c);
+        }
+    }
+
+    ref_hash_to_scalar(h, buffer, 32 + (count * 64));
+
+    ref_sc_sub(signatures + (real_index * 64), h, sum);
+
+    ref_sc_mulsub(signatures + (real_index * 64) + 32, signatures + (real_index * 64), private_key, k);
+
+    return 0;
+}
+
+int ref_check_ring_signatures(
+    const unsigned char *prefix_hash,
+    const unsigned char *key_image,
+    const unsigned char *public_keys,
+    size_t count,
+    const unsigned char *signatures)
+{
+    unsigned char buffer[32 + (REF_MAX_RING * 64)], sum[32] = {0}, h[32];
+
+    if (count > REF_MAX_RING)
+    {
+        return -1;
+    }
+
+    memcpy(buffer, prefix_hash, 32);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const unsigned char *c = signatures + (i * 64);
+
+        const unsigned char *r = c + 32;
+
+        unsigned char hp[32];
+
+        ref_hash_to_ec(hp, public_keys + (i * 32));
+
+        if (double_scalarmult_base(buffer + 32 + (i * 64), c, public_keys + (i * 32), r) != 0
+            || double_scalarmult(buffer + 64 + (i * 64), r, hp, c, key_image) != 0)
+        {
+            return -1;
+        }
+
+        ref_sc_add(sum, sum, c);
+    }
+
+    ref_hash_to_scalar(h, buffer, 32 + (count * 64));
+
+    ref_sc_sub(h, h, sum);
+
+    for (int i = 0; i < 32; i++)
+    {
+        if (h[i] != 0)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * CryptoNote block base58: every 8 bytes become 11 characters, a shorter
+ * final block becomes the fewest characters able to hold it. Each block is
+ * converted by long division of its big endian bytes
+ */
+void ref_base58_encode(const unsigned char *in, size_t length, char *out)
+{
+    static const char alphabet[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+    static const size_t sizes[] = {0, 2, 3, 5, 6, 7, 9, 10, 11};
+
+    size_t pos = 0;
+
+    for (size_t offset = 0; offset < length; offset += 8)
+    {
+        const size_t size = length - offset < 8 ? length - offset : 8;
+
+        unsigned char digits[8];
+
+        memcpy(digits, in + offset, size);
+
+        for (size_t i = sizes[size]; i > 0; i--)
+        {
+            unsigned int remainder = 0;
+
+            for (size_t j = 0; j < size; j++)
+            {
+                const unsigned int value = (remainder << 8) | digits[j];
+
+                digits[j] = (unsigned char)(value / 58);
+
+                remainder = value % 58;
+            }
+
+            out[pos + i - 1] = alphabet[remainder];
+        }
+
+        pos += sizes[size];
+    }
+
+    out[pos] = '\0';
+}
+
+int ref_self_test(void)
+{
+    gf t, u;
+
+    // d = -121665 / 121666
+    gf_from_int(t, 121666);
+
+    M(t, t, C_D);
+
+    gf_from_int(u, -121665);
+
+    if (neq25519(t, u))
+    {
+        return 0;
+    }
+
+    // d2 = 2 * d
+    A(t, C_D, C_D);
+
+    if (neq25519(t, C_D2))
+    {
+        return 0;
+    }
+
+    // sqrt(-1)^2 = -1
+    S(t, C_SQRTM1);
+
+    gf_from_int(u, -1);
+
+    if (neq25519(t, u))
+    {
+        return 0;
+    }
+
+    // the base point is on the curve: -x^2 + y^2 = 1 + d x^2 y^2
+    {
+        gf x2, y2, lhs, rhs;
+
+        S(x2, C_X);
+
+        S(y2, C_Y);
+
+        Z(lhs, y2, x2);
+
+        M(rhs, x2, y2);
+
+        M(rhs, rhs, C_D);
+
+        A(rhs, rhs, gf1);
+
+        if (neq25519(lhs, rhs))
+        {
+            return 0;
+        }
+    }
+
+    // l * G is the identity
+    {
+        unsigned char order[32], out[32], identity[32] = {1};
+
+        for (int i = 0; i < 32; i++)
+        {
+            order[i] = (unsigned char)C_L[i];
+        }
+
+        ref_scalarmult_base(out, order);
+
+        if (memcmp(out, identity, 32) != 0)
+        {
+            return 0;
+        }
+    }
+
+    // Keccak-256("") with the original padding
+    {
+        static const unsigned char expected[32] = {
+            0xc5, 0xd2, 0x46, 0x01, 0x86, 0xf7, 0x23, 0x3c, 0x92, 0x7e, 0x7d, 0xb2, 0xdc, 0xc7, 0x03, 0xc0,
+            0xe5, 0x00, 0xb6, 0x53, 0xca, 0x82, 0x27, 0x3b, 0x7b, 0xfa, 0xd8, 0x04, 0x5d, 0x85, 0xa4, 0x70};
+
+        unsigned char out[32];
+
+        ref_keccak((const unsigned char *)"", 0, out);
+
+        if (memcmp(out, expected, 32) != 0)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
\ No newline at end of file
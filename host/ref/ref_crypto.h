@@ -0,0 +1,118 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+/**
+ * A reference ed25519/CryptoNote implementation used only by the host fuzzing
+ * harness to check hw_crypto.c against. It shares no code with src/ or with
+ * the cx shim: the field and scalar arithmetic follow TweetNaCl (public domain)
+ * and Keccak is built from the round definitions in the specification, so a
+ * mistake has to be made twice, in two different ways, to go unnoticed.
+ *
+ * Nothing here is constant time and it must never be built into the app.
+ */
+
+#ifndef HOST_REF_CRYPTO_H
+#define HOST_REF_CRYPTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define REF_KEY_SIZE 32
+#define REF_SIG_SIZE 64
+
+/**
+ * Checks the reference implementation against known constants, returns 1 on success
+ */
+int ref_self_test(void);
+
+void ref_keccak(const unsigned char *in, size_t length, unsigned char *out);
+
+void ref_hash_to_scalar(unsigned char *out, const unsigned char *in, size_t length);
+
+void ref_sc_reduce32(unsigned char *out, const unsigned char *in);
+
+int ref_sc_check(const unsigned char *scalar);
+
+void ref_sc_add(unsigned char *r, const unsigned char *a, const unsigned char *b);
+
+void ref_sc_sub(unsigned char *r, const unsigned char *a, const unsigned char *b);
+
+void ref_sc_mulsub(unsigned char *r, const unsigned char *a, const unsigned char *b, const unsigned char *c);
+
+int ref_check_key(const unsigned char *key);
+
+void ref_scalarmult_base(unsigned char *out, const unsigned char *scalar);
+
+int ref_scalarmult(unsigned char *out, const unsigned char *point, const unsigned char *scalar);
+
+int ref_add(unsigned char *out, const unsigned char *p, const unsigned char *q);
+
+void ref_hash_to_ec(unsigned char *out, const unsigned char *key);
+
+int ref_generate_key_derivation(unsigned char *out, const unsigned char *point, const unsigned char *scalar);
+
+void ref_derivation_to_scalar(unsigned char *out, const unsigned char *derivation, uint64_t output_index);
+
+int ref_derive_public_key(
+    unsigned char *out,
+    const unsigned char *derivation,
+    uint64_t output_index,
+    const unsigned char *base);
+
+void ref_derive_secret_key(
+    unsigned char *out,
+    const unsigned char *derivation,
+    uint64_t output_index,
+    const unsigned char *base);
+
+int ref_generate_key_image(unsigned char *out, const unsigned char *public_key, const unsigned char *private_key);
+
+void ref_generate_signature(
+    unsigned char *signature,
+    const unsigned char *message_digest,
+    const unsigned char *public_key,
+    const unsigned char *private_key,
+    const unsigned char *k);
+
+int ref_check_signature(
+    const unsigned char *message_digest,
+    const unsigned char *public_key,
+    const unsigned char *signature);
+
+int ref_generate_ring_signatures(
+    unsigned char *signatures,
+    const unsigned char *prefix_hash,
+    const unsigned char *key_image,
+    const unsigned char *public_keys,
+    size_t count,
+    const unsigned char *private_key,
+    size_t real_index,
+    const unsigned char *randomness);
+
+int ref_check_ring_signatures(
+    const unsigned char *prefix_hash,
+    const unsigned char *key_image,
+    const unsigned char *public_keys,
+    size_t count,
+    const unsigned char *signatures);
+
+unsigned int ref_encode_varint(unsigned char *out, uint64_t value);
+
+int ref_decode_varint(const unsigned char *in, size_t max_length, uint64_t *value);
+
+void ref_base58_encode(const unsigned char *in, size_t length, char *out);
+
+#endif // HOST_REF_CRYPTO_H
\ No newline at end of file
@@ -0,0 +1,1063 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+
+/**
+ * Software implementation of the cx_* calls used by src/hw_crypto.c so that
+ * the crypto and transaction core can be built and benchmarked on a host.
+ *
+ * Arithmetic modulo the ed25519 field prime uses 51-bit limbs; every other
+ * modulus (ie. the curve order) falls back to a simple shift and subtract
+ * reduction. None of this is constant time, it is only meant for testing.
+ */
+
+#include "cx.h"
+
+#include "cx_counters.h"
+#include "os.h"
+
+#define FE_MASK 0x7ffffffffffffULL
+
+typedef unsigned __int128 uint128_t;
+
+typedef struct
+{
+    uint64_t v[5];
+} fe_t;
+
+typedef struct
+{
+    fe_t X;
+
+    fe_t Y;
+
+    fe_t Z;
+
+    fe_t T;
+} ge_t;
+
+cx_op_counts_t G_cx_op_counts;
+
+static const unsigned char C_FIELD[32] = {0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                          0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                          0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xed};
+
+static fe_t C_d, C_2d, C_sqrtm1;
+
+static int L_constants_ready = 0;
+
+static uint64_t L_rng_state = 0x5475727465436f69ULL;
+
+/* field arithmetic modulo 2^255 - 19 */
+
+static void fe_frombytes(fe_t *h, const unsigned char *s) // little endian
+{
+    uint64_t w[4];
+
+    for (int i = 0; i < 4; i++)
+    {
+        w[i] = 0;
+
+        for (int j = 7; j >= 0; j--)
+        {
+            w[i] = (w[i] << 8) | s[i * 8 + j];
+        }
+    }
+
+    h->v[0] = w[0] & FE_MASK;
+
+    h->v[1] = ((w[0] >> 51) | (w[1] << 13)) & FE_MASK;
+
+    h->v[2] = ((w[1] >> 38) | (w[2] << 26)) & FE_MASK;
+
+    h->v[3] = ((w[2] >> 25) | (w[3] << 39)) & FE_MASK;
+
+    h->v[4] = (w[3] >> 12) & FE_MASK;
+}
+
+static void fe_carry(fe_t *h)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        h->v[i + 1] += h->v[i] >> 51;
+
+        h->v[i] &= FE_MASK;
+    }
+
+    h->v[0] += 19 * (h->v[4] >> 51);
+
+    h->v[4] &= FE_MASK;
+
+    h->v[1] += h->v[0] >> 51;
+
+    h->v[0] &= FE_MASK;
+}
+
+static void fe_tobytes(unsigned char *s, const fe_t *f) // little endian, fully reduced
+{
+    fe_t h = *f;
+
+    fe_carry(&h);
+
+    fe_carry(&h);
+
+    // compute q = floor((h + 19) / 2^255) and subtract q * p
+    uint64_t q = (h.v[0] + 19) >> 51;
+
+    for (int i = 1; i < 5; i++)
+    {
+        q = (h.v[i] + q) >> 51;
+    }
+
+    h.v[0] += 19 * q;
+
+    for (int i = 0; i < 4; i++)
+    {
+        h.v[i + 1] += h.v[i] >> 51;
+
+        h.v[i] &= FE_MASK;
+    }
+
+    h.v[4] &= FE_MASK;
+
+    const uint64_t w[4] = {h.v[0] | (h.v[1] << 51),
+                           (h.v[1] >> 13) | (h.v[2] << 38),
+                           (h.v[2] >> 26) | (h.v[3] << 25),
+                           (h.v[3] >> 39) | (h.v[4] << 12)};
+
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 8; j++)
+        {
+            s[i * 8 + j] = (unsigned char)(w[i] >> (8 * j));
+        }
+    }
+}
+
+static void fe_frombe(fe_t *h, const unsigned char *be)
+{
+    unsigned char le[32];
+
+    for (int i = 0; i < 32; i++)
+    {
+        le[i] = be[31 - i];
+    }
+
+    fe_frombytes(h, le);
+}
+
+static void fe_tobe(unsigned char *be, const fe_t *f)
+{
+    unsigned char le[32];
+
+    fe_tobytes(le, f);
+
+    for (int i = 0; i < 32; i++)
+    {
+        be[i] = le[31 - i];
+    }
+}
+
+static void fe_set(fe_t *h, uint64_t value)
+{
+    memset(h, 0, sizeof(fe_t));
+
+    h->v[0] = value;
+}
+
+static void fe_add(fe_t *h, const fe_t *f, const fe_t *g)
+{
+    for (int i = 0; i < 5; i++)
+    {
+        h->v[i] = f->v[i] + g->v[i];
+    }
+
+    fe_carry(h);
+}
+
+static void fe_sub(fe_t *h, const fe_t *f, const fe_t *g)
+{
+    // add 4p before subtracting so that no limb underflows
+    h->v[0] = (f->v[0] + 0x1fffffffffffb4ULL) - g->v[0];
+
+    for (int i = 1; i < 5; i++)
+    {
+        h->v[i] = (f->v[i] + 0x1ffffffffffffcULL) - g->v[i];
+    }
+
+    fe_carry(h);
+}
+
+static void fe_neg(fe_t *h, const fe_t *f)
+{
+    fe_t zero;
+
+    fe_set(&zero, 0);
+
+    fe_sub(h, &zero, f);
+}
+
+static void fe_mul(fe_t *h, const fe_t *f, const fe_t *g)
+{
+    const uint64_t *a = f->v, *b = g->v;
+
+    const uint64_t b1 = 19 * b[1], b2 = 19 * b[2], b3 = 19 * b[3], b4 = 19 * b[4];
+
+    uint128_t r0 = (uint128_t)a[0] * b[0] + (uint128_t)a[1] * b4 + (uint128_t)a[2] * b3 + (uint128_t)a[3] * b2
+                   + (uint128_t)a[4] * b1;
+
+    uint128_t r1 = (uint128_t)a[0] * b[1] + (uint128_t)a[1] * b[0] + (uint128_t)a[2] * b4 + (uint128_t)a[3] * b3
+                   + (uint128_t)a[4] * b2;
+
+    uint128_t r2 = (uint128_t)a[0] * b[2] + (uint128_t)a[1] * b[1] + (uint128_t)a[2] * b[0] + (uint128_t)a[3] * b4
+                   + (uint128_t)a[4] * b3;
+
+    uint128_t r3 = (uint128_t)a[0] * b[3] + (uint128_t)a[1] * b[2] + (uint128_t)a[2] * b[1] + (uint128_t)a[3] * b[0]
+                   + (uint128_t)a[4] * b4;
+
+    uint128_t r4 = (uint128_t)a[0] * b[4] + (uint128_t)a[1] * b[3] + (uint128_t)a[2] * b[2] + (uint128_t)a[3] * b[1]
+                   + (uint128_t)a[4] * b[0];
+
+    r1 += (uint64_t)(r0 >> 51);
+
+    r2 += (uint64_t)(r1 >> 51);
+
+    r3 += (uint64_t)(r2 >> 51);
+
+    r4 += (uint64_t)(r3 >> 51);
+
+    h->v[0] = ((uint64_t)r0 & FE_MASK) + 19 * (uint64_t)(r4 >> 51);
+
+    h->v[1] = (uint64_t)r1 & FE_MASK;
+
+    h->v[2] = (uint64_t)r2 & FE_MASK;
+
+    h->v[3] = (uint64_t)r3 & FE_MASK;
+
+    h->v[4] = (uint64_t)r4 & FE_MASK;
+
+    fe_carry(h);
+}
+
+static void fe_pow(fe_t *h, const fe_t *f, const unsigned char *e, unsigned int length) // big endian exponent
+{
+    fe_t r, base = *f;
+
+    fe_set(&r, 1);
+
+    for (unsigned int i = 0; i < length * 8; i++)
+    {
+        fe_mul(&r, &r, &r);
+
+        if ((e[i / 8] >> (7 - (i % 8))) & 1)
+        {
+            fe_mul(&r, &r, &base);
+        }
+    }
+
+    *h = r;
+}
+
+static void fe_invert(fe_t *h, const fe_t *f)
+{
+    unsigned char e[32];
+
+    memcpy(e, C_FIELD, sizeof(e));
+
+    e[31] -= 2; // p - 2
+
+    fe_pow(h, f, e, sizeof(e));
+}
+
+static int fe_iszero(const fe_t *f)
+{
+    unsigned char s[32];
+
+    fe_tobytes(s, f);
+
+    int result = 0;
+
+    for (int i = 0; i < 32; i++)
+    {
+        result |= s[i];
+    }
+
+    return result == 0;
+}
+
+static int fe_isodd(const fe_t *f)
+{
+    unsigned char s[32];
+
+    fe_tobytes(s, f);
+
+    return s[0] & 1;
+}
+
+static int fe_equal(const fe_t *f, const fe_t *g)
+{
+    fe_t h;
+
+    fe_sub(&h, f, g);
+
+    return fe_iszero(&h);
+}
+
+static void init_constants()
+{
+    if (L_constants_ready)
+    {
+        return;
+    }
+
+    fe_t n, dd;
+
+    // d = -121665 / 121666
+    fe_set(&n, 121665);
+
+    fe_neg(&n, &n);
+
+    fe_set(&dd, 121666);
+
+    fe_invert(&dd, &dd);
+
+    fe_mul(&C_d, &n, &dd);
+
+    fe_add(&C_2d, &C_d, &C_d);
+
+    // sqrt(-1) = 2^((p - 1) / 4)
+    unsigned char e[32];
+
+    memcpy(e, C_FIELD, sizeof(e));
+
+    e[31] -= 1;
+
+    for (int i = 31; i >= 0; i--) // shift right by two
+    {
+        e[i] = (unsigned char)((e[i] >> 2) | (i > 0 ? (e[i - 1] << 6) : 0));
+    }
+
+    fe_set(&n, 2);
+
+    fe_pow(&C_sqrtm1, &n, e, sizeof(e));
+
+    L_constants_ready = 1;
+}
+
+/* group operations on the twisted edwards curve -x^2 + y^2 = 1 + d x^2 y^2 */
+
+static void ge_frompoint(ge_t *p, const unsigned char *P) // 0x04 || x || y
+{
+    fe_frombe(&p->X, P + 1);
+
+    fe_frombe(&p->Y, P + 33);
+
+    fe_set(&p->Z, 1);
+
+    fe_mul(&p->T, &p->X, &p->Y);
+}
+
+static void ge_topoint(unsigned char *P, const ge_t *p)
+{
+    fe_t zinv, x, y;
+
+    fe_invert(&zinv, &p->Z);
+
+    fe_mul(&x, &p->X, &zinv);
+
+    fe_mul(&y, &p->Y, &zinv);
+
+    P[0] = 0x04;
+
+    fe_tobe(P + 1, &x);
+
+    fe_tobe(P + 33, &y);
+}
+
+// add-2008-hwcd-3, unified so that it also handles doubling
+static void ge_add(ge_t *r, const ge_t *p, const ge_t *q)
+{
+    fe_t a, b, c, d, e, f, g, h, t;
+
+    fe_sub(&a, &p->Y, &p->X);
+
+    fe_sub(&t, &q->Y, &q->X);
+
+    fe_mul(&a, &a, &t);
+
+    fe_add(&b, &p->Y, &p->X);
+
+    fe_add(&t, &q->Y, &q->X);
+
+    fe_mul(&b, &b, &t);
+
+    fe_mul(&c, &p->T, &C_2d);
+
+    fe_mul(&c, &c, &q->T);
+
+    fe_mul(&d, &p->Z, &q->Z);
+
+    fe_add(&d, &d, &d);
+
+    fe_sub(&e, &b, &a);
+
+    fe_sub(&f, &d, &c);
+
+    fe_add(&g, &d, &c);
+
+    fe_add(&h, &b, &a);
+
+    fe_mul(&r->X, &e, &f);
+
+    fe_mul(&r->Y, &g, &h);
+
+    fe_mul(&r->T, &e, &h);
+
+    fe_mul(&r->Z, &f, &g);
+}
+
+/* arbitrary modulus arithmetic on big endian byte strings */
+
+static int bn_cmp(const unsigned char *a, const unsigned char *b, unsigned int length)
+{
+    return memcmp(a, b, length);
+}
+
+static int bn_sub(unsigned char *r, const unsigned char *a, const unsigned char *b, unsigned int length)
+{
+    int borrow = 0;
+
+    for (int i = (int)length - 1; i >= 0; i--)
+    {
+        const int value = a[i] - b[i] - borrow;
+
+        borrow = value < 0;
+
+        r[i] = (unsigned char)value;
+    }
+
+    return borrow;
+}
+
+/**
+ * Reduces a big endian value of any length modulo m, the result is
+ * written to r (m_length bytes)
+ */
+static void bn_mod(
+    unsigned char *r,
+    const unsigned char *v,
+    unsigned int v_length,
+    const unsigned char *m,
+    unsigned int m_length)
+{
+    // one spare byte so that the intermediate 2r + bit always fits
+    unsigned char acc[65] = {0}, mm[65] = {0};
+
+    memcpy(mm + 1, m, m_length);
+
+    for (unsigned int i = 0; i < v_length * 8; i++)
+    {
+        int carry = (v[i / 8] >> (7 - (i % 8))) & 1;
+
+        for (int j = (int)m_length; j >= 0; j--)
+        {
+            const int value = (acc[j] << 1) | carry;
+
+            carry = value >> 8;
+
+            acc[j] = (unsigned char)value;
+        }
+
+        if (bn_cmp(acc, mm, m_length + 1) >= 0)
+        {
+            bn_sub(acc, acc, mm, m_length + 1);
+        }
+    }
+
+    memcpy(r, acc + 1, m_length);
+}
+
+static int is_field(const unsigned char *m, unsigned int length)
+{
+    return length == sizeof(C_FIELD) && memcmp(m, C_FIELD, length) == 0;
+}
+
+/* cx_* API */
+
+int cx_keccak_init(cx_sha3_t *hash, unsigned int size)
+{
+    memset(hash, 0, sizeof(cx_sha3_t));
+
+    hash->output_size = size / 8;
+
+    hash->block_size = 200 - 2 * hash->output_size;
+
+    return 0;
+}
+
+static uint64_t rotl64(uint64_t x, unsigned int n)
+{
+    return n == 0 ? x : (x << n) | (x >> (64 - n));
+}
+
+static void keccakf(uint64_t st[25])
+{
+    static const uint64_t rc[24] = {
+        0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+        0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+        0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+        0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+        0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+        0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+    static const unsigned int rotc[24] = {1,  3,  6,  10, 15, 21, 28, 36, 45, 55, 2,  14,
+                                          27, 41, 56, 8,  25, 43, 62, 18, 39, 61, 20, 44};
+
+    static const unsigned int piln[24] = {10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+                                          15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1};
+
+    uint64_t bc[5], t;
+
+    for (int round = 0; round < 24; round++)
+    {
+        for (int i = 0; i < 5; i++)
+        {
+            bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+        }
+
+        for (int i = 0; i < 5; i++)
+        {
+            t = bc[(i + 4) % 5] ^ rotl64(bc[(i + 1) % 5], 1);
+
+            for (int j = 0; j < 25; j += 5)
+            {
+                st[j + i] ^= t;
+            }
+        }
+
+        t = st[1];
+
+        for (int i = 0; i < 24; i++)
+        {
+            const unsigned int j = piln[i];
+
+            bc[0] = st[j];
+
+            st[j] = rotl64(t, rotc[i]);
+
+            t = bc[0];
+        }
+
+        for (int j = 0; j < 25; j += 5)
+        {
+            for (int i = 0; i < 5; i++)
+            {
+                bc[i] = st[j + i];
+            }
+
+            for (int i = 0; i < 5; i++)
+            {
+                st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+            }
+        }
+
+        st[0] ^= rc[round];
+    }
+}
+
+static void keccak_absorb(cx_sha3_t *hash)
+{
+    for (unsigned int i = 0; i < hash->block_size / 8; i++)
+    {
+        uint64_t lane = 0;
+
+        for (int j = 7; j >= 0; j--)
+        {
+            lane = (lane << 8) | hash->block[i * 8 + j];
+        }
+
+        hash->state[i] ^= lane;
+    }
+
+    keccakf(hash->state);
+
+    G_cx_op_counts.keccak_blocks++;
+
+    hash->block_length = 0;
+}
+
+int cx_hash(
+    cx_hash_t *hash,
+    int mode,
+    const unsigned char *in,
+    unsigned int length,
+    unsigned char *out,
+    unsigned int out_length)
+{
+    cx_sha3_t *ctx = (cx_sha3_t *)hash;
+
+    G_cx_op_counts.hash++;
+
+    for (unsigned int i = 0; i < length; i++)
+    {
+        ctx->block[ctx->block_length++] = in[i];
+
+        if (ctx->block_length == ctx->block_size)
+        {
+            keccak_absorb(ctx);
+        }
+    }
+
+    if ((mode & CX_LAST) == 0)
+    {
+        return 0;
+    }
+
+    // original keccak padding (not the SHA3 0x06 domain separator)
+    memset(ctx->block + ctx->block_length, 0, ctx->block_size - ctx->block_length);
+
+    ctx->block[ctx->block_length] ^= 0x01;
+
+    ctx->block[ctx->block_size - 1] ^= 0x80;
+
+    keccak_absorb(ctx);
+
+    const unsigned int size = out_length < ctx->output_size ? out_length : ctx->output_size;
+
+    for (unsigned int i = 0; i < size; i++)
+    {
+        out[i] = (unsigned char)(ctx->state[i / 8] >> (8 * (i % 8)));
+    }
+
+    return (int)size;
+}
+
+unsigned char *cx_rng(unsigned char *buffer, unsigned int length)
+{
+    G_cx_op_counts.rng++;
+
+    for (unsigned int i = 0; i < length; i++)
+    {
+        // splitmix64, deterministic so that benchmark runs are repeatable
+        uint64_t z = (L_rng_state += 0x9e3779b97f4a7c15ULL);
+
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+        buffer[i] = (unsigned char)(z ^ (z >> 31));
+    }
+
+    return buffer;
+}
+
+int cx_ecfp_add_point(
+    unsigned int curve,
+    unsigned char *R,
+    const unsigned char *P,
+    const unsigned char *Q,
+    unsigned int length)
+{
+    (void)curve;
+
+    ge_t p, q;
+
+    init_constants();
+
+    G_cx_op_counts.add_point++;
+
+    ge_frompoint(&p, P);
+
+    ge_frompoint(&q, Q);
+
+    ge_add(&p, &p, &q);
+
+    ge_topoint(R, &p);
+
+    return (int)length;
+}
+
+int cx_ecfp_scalar_mult(
+    unsigned int curve,
+    unsigned char *P,
+    unsigned int length,
+    const unsigned char *k,
+    unsigned int k_length)
+{
+    (void)curve;
+
+    ge_t r, p;
+
+    init_constants();
+
+    G_cx_op_counts.scalar_mult++;
+
+    ge_frompoint(&p, P);
+
+    // start from the neutral element (0, 1)
+    fe_set(&r.X, 0);
+
+    fe_set(&r.Y, 1);
+
+    fe_set(&r.Z, 1);
+
+    fe_set(&r.T, 0);
+
+    for (unsigned int i = 0; i < k_length * 8; i++)
+    {
+        ge_add(&r, &r, &r);
+
+        if ((k[i / 8] >> (7 - (i % 8))) & 1)
+        {
+            ge_add(&r, &r, &p);
+        }
+    }
+
+    ge_topoint(P, &r);
+
+    return (int)length;
+}
+
+void cx_edward_compress_point(unsigned int curve, unsigned char *P, unsigned int length)
+{
+    (void)curve;
+
+    (void)length;
+
+    fe_t x, y;
+
+    G_cx_op_counts.compress++;
+
+    fe_frombe(&x, P + 1);
+
+    fe_frombe(&y, P + 33);
+
+    P[0] = 0x02;
+
+    fe_tobytes(P + 1, &y);
+
+    P[32] |= (unsigned char)(fe_isodd(&x) << 7);
+
+    memset(P + 33, 0, 32);
+}
+
+void cx_edward_decompress_point(unsigned int curve, unsigned char *P, unsigned int length)
+{
+    (void)curve;
+
+    (void)length;
+
+    unsigned char encoded[32];
+
+    fe_t x, y, u, v, v3, t, check;
+
+    init_constants();
+
+    G_cx_op_counts.decompress++;
+
+    memcpy(encoded, P + 1, sizeof(encoded));
+
+    const int sign = encoded[31] >> 7;
+
+    encoded[31] &= 0x7f;
+
+    fe_frombytes(&y, encoded);
+
+    // u = y^2 - 1, v = d * y^2 + 1
+    fe_t one;
+
+    fe_set(&one, 1);
+
+    fe_mul(&u, &y, &y);
+
+    fe_mul(&v, &u, &C_d);
+
+    fe_sub(&u, &u, &one);
+
+    fe_add(&v, &v, &one);
+
+    // x = u * v^3 * (u * v^7)^((p - 5) / 8)
+    unsigned char e[32];
+
+    memcpy(e, C_FIELD, sizeof(e));
+
+    e[31] -= 5;
+
+    for (int i = 31; i >= 0; i--) // shift right by three
+    {
+        e[i] = (unsigned char)((e[i] >> 3) | (i > 0 ? (e[i - 1] << 5) : 0));
+    }
+
+    fe_mul(&v3, &v, &v);
+
+    fe_mul(&v3, &v3, &v);
+
+    fe_mul(&t, &v3, &v3);
+
+    fe_mul(&t, &t, &v);
+
+    fe_mul(&t, &t, &u);
+
+    fe_pow(&t, &t, e, sizeof(e));
+
+    fe_mul(&x, &t, &v3);
+
+    fe_mul(&x, &x, &u);
+
+    fe_mul(&check, &x, &x);
+
+    fe_mul(&check, &check, &v);
+
+    if (!fe_equal(&check, &u))
+    {
+        fe_neg(&t, &u);
+
+        if (!fe_equal(&check, &t))
+        {
+            THROW(EXCEPTION);
+        }
+
+        fe_mul(&x, &x, &C_sqrtm1);
+    }
+
+    if (fe_iszero(&x) && sign)
+    {
+        THROW(EXCEPTION);
+    }
+
+    if (fe_isodd(&x) != sign)
+    {
+        fe_neg(&x, &x);
+    }
+
+    P[0] = 0x04;
+
+    fe_tobe(P + 1, &x);
+
+    fe_tobe(P + 33, &y);
+}
+
+int cx_math_is_zero(const unsigned char *a, unsigned int length)
+{
+    for (unsigned int i = 0; i < length; i++)
+    {
+        if (a[i] != 0)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int cx_math_sub(unsigned char *r, const unsigned char *a, const unsigned char *b, unsigned int length)
+{
+    return bn_sub(r, a, b, length);
+}
+
+void cx_math_addm(
+    unsigned char *r,
+    const unsigned char *a,
+    const unsigned char *b,
+    const unsigned char *m,
+    unsigned int length)
+{
+    unsigned char sum[65] = {0};
+
+    int carry = 0;
+
+    G_cx_op_counts.addm++;
+
+    for (int i = (int)length - 1; i >= 0; i--)
+    {
+        const int value = a[i] + b[i] + carry;
+
+        carry = value >> 8;
+
+        sum[i + 1] = (unsigned char)value;
+    }
+
+    sum[0] = (unsigned char)carry;
+
+    bn_mod(r, sum, length + 1, m, length);
+}
+
+void cx_math_subm(
+    unsigned char *r,
+    const unsigned char *a,
+    const unsigned char *b,
+    const unsigned char *m,
+    unsigned int length)
+{
+    unsigned char _a[64], _b[64];
+
+    G_cx_op_counts.subm++;
+
+    bn_mod(_a, a, length, m, length);
+
+    bn_mod(_b, b, length, m, length);
+
+    if (bn_sub(r, _a, _b, length))
+    {
+        unsigned char carry = 0;
+
+        for (int i = (int)length - 1; i >= 0; i--)
+        {
+            const int value = r[i] + m[i] + carry;
+
+            carry = (unsigned char)(value >> 8);
+
+            r[i] = (unsigned char)value;
+        }
+    }
+}
+
+void cx_math_multm(
+    unsigned char *r,
+    const unsigned char *a,
+    const unsigned char *b,
+    const unsigned char *m,
+    unsigned int length)
+{
+    G_cx_op_counts.multm++;
+
+    if (is_field(m, length))
+    {
+        fe_t f, g;
+
+        fe_frombe(&f, a);
+
+        fe_frombe(&g, b);
+
+        fe_mul(&f, &f, &g);
+
+        fe_tobe(r, &f);
+
+        return;
+    }
+
+    unsigned char product[64] = {0};
+
+    uint32_t acc[64] = {0};
+
+    for (unsigned int i = 0; i < length; i++)
+    {
+        for (unsigned int j = 0; j < length; j++)
+        {
+            acc[i + j + 1] += (uint32_t)a[i] * b[j];
+        }
+    }
+
+    uint32_t carry = 0;
+
+    for (int i = (int)(2 * length) - 1; i >= 0; i--)
+    {
+        const uint32_t value = acc[i] + carry;
+
+        product[i] = (unsigned char)value;
+
+        carry = value >> 8;
+    }
+
+    bn_mod(r, product, 2 * length, m, length);
+}
+
+void cx_math_powm(
+    unsigned char *r,
+    const unsigned char *a,
+    const unsigned char *e,
+    unsigned int length_e,
+    const unsigned char *m,
+    unsigned int length)
+{
+    G_cx_op_counts.powm++;
+
+    if (is_field(m, length))
+    {
+        fe_t f;
+
+        fe_frombe(&f, a);
+
+        fe_pow(&f, &f, e, length_e);
+
+        fe_tobe(r, &f);
+
+        return;
+    }
+
+    unsigned char result[64] = {0}, base[64];
+
+    result[length - 1] = 1;
+
+    bn_mod(base, a, length, m, length);
+
+    const uint64_t multm = G_cx_op_counts.multm;
+
+    for (unsigned int i = 0; i < length_e * 8; i++)
+    {
+        cx_math_multm(result, result, result, m, length);
+
+        if ((e[i / 8] >> (7 - (i % 8))) & 1)
+        {
+            cx_math_multm(result, result, base, m, length);
+        }
+    }
+
+    // the device does this in a single call, so don't count the inner steps
+    G_cx_op_counts.multm = multm;
+
+    memcpy(r, result, length);
+}
+
+void cx_math_modm(unsigned char *v, unsigned int length_v, const unsigned char *m, unsigned int length_m)
+{
+    unsigned char r[64];
+
+    G_cx_op_counts.modm++;
+
+    bn_mod(r, v, length_v, m, length_m);
+
+    memset(v, 0, length_v);
+
+    memcpy(v + length_v - length_m, r, length_m);
+}
+
+void cx_math_invprimem(unsigned char *r, const unsigned char *a, const unsigned char *m, unsigned int length)
+{
+    unsigned char e[64];
+
+    G_cx_op_counts.invprimem++;
+
+    // a^(m - 2) by fermat's little theorem
+    memcpy(e, m, length);
+
+    unsigned char borrow = 2;
+
+    for (int i = (int)length - 1; i >= 0 && borrow; i--)
+    {
+        const int value = e[i] - borrow;
+
+        borrow = value < 0;
+
+        e[i] = (unsigned char)value;
+    }
+
+    const uint64_t powm = G_cx_op_counts.powm;
+
+    cx_math_powm(r, a, e, length, m, length);
+
+    G_cx_op_counts.powm = powm;
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+
+/**
+ * A host-native stand-in for the parts of the BOLOS cx.h API that the
+ * crypto core uses. Numbers are big endian and points are in the BOLOS
+ * uncompressed (0x04 || x || y) or compressed (0x02 || encoding) form
+ */
+
+#ifndef HOST_SHIM_CX_H
+#define HOST_SHIM_CX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CX_LAST (1 << 0)
+
+#define CX_CURVE_Ed25519 0x71
+
+typedef struct cx_hash_s
+{
+    unsigned int algorithm;
+
+    unsigned int counter;
+} cx_hash_t;
+
+typedef struct cx_sha3_s
+{
+    cx_hash_t header;
+
+    unsigned int output_size;
+
+    unsigned int block_size;
+
+    unsigned int block_length;
+
+    unsigned char block[200];
+
+    uint64_t state[25];
+} cx_sha3_t;
+
+int cx_keccak_init(cx_sha3_t *hash, unsigned int size);
+
+int cx_hash(
+    cx_hash_t *hash,
+    int mode,
+    const unsigned char *in,
+    unsigned int length,
+    unsigned char *out,
+    unsigned int out_length);
+
+unsigned char *cx_rng(unsigned char *buffer, unsigned int length);
+
+int cx_ecfp_add_point(
+    unsigned int curve,
+    unsigned char *R,
+    const unsigned char *P,
+    const unsigned char *Q,
+    unsigned int length);
+
+int cx_ecfp_scalar_mult(
+    unsigned int curve,
+    unsigned char *P,
+    unsigned int length,
+    const unsigned char *k,
+    unsigned int k_length);
+
+void cx_edward_compress_point(unsigned int curve, unsigned char *P, unsigned int length);
+
+void cx_edward_decompress_point(unsigned int curve, unsigned char *P, unsigned int length);
+
+int cx_math_is_zero(const unsigned char *a, unsigned int length);
+
+int cx_math_sub(unsigned char *r, const unsigned char *a, const unsigned char *b, unsigned int length);
+
+void cx_math_addm(
+    unsigned char *r,
+    const unsigned char *a,
+    const unsigned char *b,
+    const unsigned char *m,
+    unsigned int length);
+
+void cx_math_subm(
+    unsigned char *r,
+    const unsigned char *a,
+    const unsigned char *b,
+    const unsigned char *m,
+    unsigned int length);
+
+void cx_math_multm(
+    unsigned char *r,
+    const unsigned char *a,
+    const unsigned char *b,
+    const unsigned char *m,
+    unsigned int length);
+
+void cx_math_powm(
+    unsigned char *r,
+    const unsigned char *a,
+    const unsigned char *e,
+    unsigned int length_e,
+    const unsigned char *m,
+    unsigned int length);
+
+void cx_math_modm(unsigned char *v, unsigned int length_v, const unsigned char *m, unsigned int length_m);
+
+void cx_math_invprimem(unsigned char *r, const unsigned char *a, const unsigned char *m, unsigned int length);
+
+#endif // HOST_SHIM_CX_H
\ No newline at end of file
@@ -0,0 +1,59 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+
+#ifndef HOST_SHIM_CX_COUNTERS_H
+#define HOST_SHIM_CX_COUNTERS_H
+
+#include <stdint.h>
+
+/**
+ * Number of times each cx_* call has been made since the counters were last
+ * cleared; on the device these are the expensive syscalls so the counts are
+ * a better guide to device cost than host timings are
+ */
+typedef struct cx_op_counts_s
+{
+    uint64_t scalar_mult;
+
+    uint64_t add_point;
+
+    uint64_t compress;
+
+    uint64_t decompress;
+
+    uint64_t multm;
+
+    uint64_t addm;
+
+    uint64_t subm;
+
+    uint64_t modm;
+
+    uint64_t powm;
+
+    uint64_t invprimem;
+
+    uint64_t hash;
+
+    uint64_t keccak_blocks;
+
+    uint64_t rng;
+} cx_op_counts_t;
+
+extern cx_op_counts_t G_cx_op_counts;
+
+#endif // HOST_SHIM_CX_COUNTERS_H
\ No newline at end of file
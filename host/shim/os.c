@@ -0,0 +1,167 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+
+/**
+ * Software implementation of the os_* and nvm_write calls used by the
+ * crypto and transaction core. NVRAM is plain RAM on the host and the
+ * BIP32 seed is fixed so that every run derives the same wallet.
+ */
+
+#include "os.h"
+
+#include <stdlib.h>
+
+static try_context_t *L_try_context = NULL;
+
+unsigned char G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+
+unsigned long long G_nvm_write_count = 0;
+
+unsigned long long G_nvm_write_bytes = 0;
+
+unsigned long long G_nvm_distinct_pages = 0;
+
+// open addressed set of the pages written (stored as page + 1 so that 0 is empty)
+#define NVM_PAGE_SET_SIZE (1 << 16)
+
+static uintptr_t L_nvm_pages[NVM_PAGE_SET_SIZE];
+
+static void nvm_pages_add(const uintptr_t page)
+{
+    size_t i = (page * 0x9e3779b1u) & (NVM_PAGE_SET_SIZE - 1);
+
+    while (L_nvm_pages[i] != 0)
+    {
+        if (L_nvm_pages[i] == page + 1)
+        {
+            return;
+        }
+
+        i = (i + 1) & (NVM_PAGE_SET_SIZE - 1);
+    }
+
+    L_nvm_pages[i] = page + 1;
+
+    G_nvm_distinct_pages++;
+}
+
+void nvm_pages_reset(void)
+{
+    memset(L_nvm_pages, 0, sizeof(L_nvm_pages));
+
+    G_nvm_distinct_pages = 0;
+}
+
+try_context_t *try_context_get(void)
+{
+    return L_try_context;
+}
+
+try_context_t *try_context_set(try_context_t *context)
+{
+    try_context_t *previous = L_try_context;
+
+    L_try_context = context;
+
+    return previous;
+}
+
+void os_longjmp(unsigned int exception)
+{
+    if (L_try_context == NULL)
+    {
+        fprintf(stderr, "uncaught exception 0x%04x\n", exception);
+
+        abort();
+    }
+
+    longjmp(L_try_context->jmp_buf, (int)exception);
+}
+
+void os_memmove(void *dst, const void *src, size_t length)
+{
+    memmove(dst, src, length);
+}
+
+int os_memcmp(const void *a, const void *b, size_t length)
+{
+    return memcmp(a, b, length);
+}
+
+void os_memset(void *dst, int value, size_t length)
+{
+    memset(dst, value, length);
+}
+
+void nvm_write(void *dst, void *src, unsigned int length)
+{
+    G_nvm_write_count++;
+
+    G_nvm_write_bytes += length;
+
+    if (length != 0)
+    {
+        const uintptr_t last = ((uintptr_t)dst + length - 1) / NVM_PAGE_SIZE;
+
+        for (uintptr_t page = (uintptr_t)dst / NVM_PAGE_SIZE; page <= last; page++)
+        {
+            nvm_pages_add(page);
+        }
+    }
+
+    if (src == NULL)
+    {
+        memset(dst, 0, length);
+    }
+    else
+    {
+        memmove(dst, src, length);
+    }
+}
+
+void os_perso_derive_node_bip32(
+    unsigned int curve,
+    const uint32_t *path,
+    unsigned int path_length,
+    unsigned char *private_key,
+    unsigned char *chain)
+{
+    (void)curve;
+
+    uint64_t state = 0x74727463686f7374ULL; // fixed seed for repeatable runs
+
+    for (unsigned int i = 0; i < path_length; i++)
+    {
+        state = (state ^ path[i]) * 0x100000001b3ULL;
+    }
+
+    for (unsigned int i = 0; i < 64; i++)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+
+        const unsigned char value = (unsigned char)(state >> 56);
+
+        if (i < 32)
+        {
+            private_key[i] = value;
+        }
+        else if (chain != NULL)
+        {
+            chain[i - 32] = value;
+        }
+    }
+}
\ No newline at end of file
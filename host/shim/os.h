@@ -0,0 +1,113 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+
+/**
+ * A host-native stand-in for the parts of the BOLOS os.h API that the
+ * crypto and transaction core use so that it can be built for the host
+ */
+
+#ifndef HOST_SHIM_OS_H
+#define HOST_SHIM_OS_H
+
+#include <setjmp.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef unsigned short exception_t;
+
+typedef struct try_context_s
+{
+    jmp_buf jmp_buf;
+
+    struct try_context_s *previous;
+
+    exception_t ex;
+} try_context_t;
+
+try_context_t *try_context_get(void);
+
+try_context_t *try_context_set(try_context_t *context);
+
+// clang-format off
+#define BEGIN_TRY_L(L) { try_context_t __try##L;
+#define TRY_L(L) __try##L.previous = try_context_set(&__try##L); __try##L.ex = setjmp(__try##L.jmp_buf); \
+    if (__try##L.ex == 0) {
+#define CATCH_L(L, x) goto __FINALLY##L; } else if (__try##L.ex == x) { __try##L.ex = 0; CLOSE_TRY_L(L);
+#define CATCH_OTHER_L(L, e) goto __FINALLY##L; } else { exception_t e; e = __try##L.ex; __try##L.ex = 0; \
+    CLOSE_TRY_L(L);
+#define CATCH_ALL_L(L) goto __FINALLY##L; } else { __try##L.ex = 0; CLOSE_TRY_L(L);
+#define FINALLY_L(L) goto __FINALLY##L; } __FINALLY##L: if (try_context_get() == &__try##L) { \
+    try_context_set(__try##L.previous); }
+#define CLOSE_TRY_L(L) try_context_set(__try##L.previous)
+#define END_TRY_L(L) if (__try##L.ex != 0) { THROW_L(L, __try##L.ex); } }
+#define THROW_L(L, x) os_longjmp(x)
+// clang-format on
+
+#define BEGIN_TRY BEGIN_TRY_L(_)
+#define TRY TRY_L(_)
+#define CATCH(x) CATCH_L(_, x)
+#define CATCH_OTHER(e) CATCH_OTHER_L(_, e)
+#define CATCH_ALL CATCH_ALL_L(_)
+#define FINALLY FINALLY_L(_)
+#define CLOSE_TRY CLOSE_TRY_L(_)
+#define END_TRY END_TRY_L(_)
+#define THROW(x) THROW_L(_, x)
+
+#define EXCEPTION 1
+#define EXCEPTION_IO_RESET 0x10
+
+#define WIDE
+#define PIC(x) ((void *)(x))
+
+#define SPRINTF(strbuf, ...) snprintf(strbuf, sizeof(strbuf), __VA_ARGS__)
+
+void os_longjmp(unsigned int exception);
+
+void os_memmove(void *dst, const void *src, size_t length);
+
+int os_memcmp(const void *a, const void *b, size_t length);
+
+void os_memset(void *dst, int value, size_t length);
+
+void nvm_write(void *dst, void *src, unsigned int length);
+
+void os_perso_derive_node_bip32(
+    unsigned int curve,
+    const uint32_t *path,
+    unsigned int path_length,
+    unsigned char *private_key,
+    unsigned char *chain);
+
+#define IO_APDU_BUFFER_SIZE 480
+
+extern unsigned char G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+
+#define NVM_PAGE_SIZE 64
+
+// number of nvm_write calls (and bytes written) since start up
+extern unsigned long long G_nvm_write_count;
+
+extern unsigned long long G_nvm_write_bytes;
+
+// number of distinct NVRAM pages written since nvm_pages_reset()
+extern unsigned long long G_nvm_distinct_pages;
+
+void nvm_pages_reset(void);
+
+#endif // HOST_SHIM_OS_H
\ No newline at end of file
@@ -0,0 +1,479 @@
+/* Copyright (c) 2020 The TurtleCoin Developers
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Static report of the G_working_set and G_io_apdu_buffer regions used by each
+   APDU handler. The layout is read from the #define'd offsets in src/ so that
+   it stays in step with the code: run with node scripts/regions.js [--json] */
+
+const fs = require('fs');
+const path = require('path');
+
+const sourceDirectory = 'src';
+
+/* The identifiers that name a shared region, and the region they resolve to */
+const regionBases = {
+    G_working_set: 'G_working_set',
+    G_io_apdu_buffer: 'G_io_apdu_buffer'
+};
+
+/* The names used for a whole region, which say nothing about its layout */
+const regionAliases = ['WORKING_SET', 'BUFFER'];
+
+/* The sizes of the types that appear in sizeof() within the offset macros */
+const typeSizes = {
+    uint8_t: 1,
+    char: 1,
+    'unsigned char': 1,
+    uint16_t: 2,
+    uint32_t: 4,
+    uint64_t: 8,
+    size_t: 4
+};
+
+/* Definitions that cannot be seen from src/ as they come from the SDK */
+const externalDefines = {
+    IO_APDU_BUFFER_SIZE: '260'
+};
+
+const jsonOutput = process.argv.includes('--json');
+
+try {
+    fs.accessSync(sourceDirectory);
+} catch (err) {
+    console.log(`Failed to find ${sourceDirectory} directory, probably in the wrong folder.`);
+    console.log('Make sure to run from the root folder, like so: node scripts/regions.js');
+    process.exit(1);
+}
+
+const files = fs.readdirSync(sourceDirectory)
+    .filter((file) => file.endsWith('.c') || file.endsWith('.h'))
+    .sort()
+    .map((file) => {
+        return {
+            name: file,
+            lines: fs.readFileSync(path.join(sourceDirectory, file)).toString().split(/\r?\n/)
+        };
+    });
+
+const defines = collectDefines(files);
+const functions = collectFunctions(files);
+const handlers = collectHandlers(files, functions);
+
+if (jsonOutput) {
+    console.log(JSON.stringify(handlers, null, 4));
+} else {
+    printReport(handlers);
+}
+
+/* Gathers every object-like #define, keeping where it was defined so that the
+   macros redefined from one function to the next (BL, DERIVATION, ...) resolve
+   to the definition in effect at the point of use */
+function collectDefines (sourceFiles) {
+    const result = {};
+
+    for (const file of sourceFiles) {
+        file.lines.forEach((line, index) => {
+            /* Join any continuation lines so that the value is read in full */
+            for (let next = index + 1; line.endsWith('\\') && next < file.lines.length; next++) {
+                line = line.slice(0, -1) + ' ' + file.lines[next].trim();
+            }
+
+            const match = line.match(/^\s*#define\s+(\w+)(?!\()\s+(.*?)\s*(\/\/.*)?$/);
+
+            if (match) {
+                result[match[1]] = result[match[1]] || [];
+
+                result[match[1]].push({ file: file.name, line: index, value: match[2] });
+            }
+
+            const undef = line.match(/^\s*#undef\s+(\w+)/);
+
+            if (undef && result[undef[1]]) {
+                result[undef[1]].push({ file: file.name, line: index, value: null });
+            }
+        });
+    }
+
+    return result;
+}
+
+/* Returns the definition of name in effect at the given line of the given file */
+function lookupDefine (name, file, line) {
+    if (!defines[name]) {
+        return externalDefines[name];
+    }
+
+    const local = defines[name].filter((define) => define.file === file && define.line <= line);
+
+    if (local.length !== 0) {
+        const value = local[local.length - 1].value;
+
+        return value === null ? undefined : value;
+    }
+
+    const headers = defines[name].filter((define) => define.file.endsWith('.h'));
+
+    return headers.length !== 0 ? headers[headers.length - 1].value : undefined;
+}
+
+/* Top-level functions are written with the opening and closing braces in the
+   first column, so the body is everything between the two */
+function collectFunctions (sourceFiles) {
+    const result = {};
+
+    for (const file of sourceFiles.filter((sourceFile) => sourceFile.name.endsWith('.c'))) {
+        let signature = [];
+
+        for (let i = 0; i < file.lines.length; i++) {
+            const line = file.lines[i];
+
+            if (line === '{') {
+                const name = signature.join(' ').match(/(\w+)\s*\([^()]*(\([^()]*\)[^()]*)*\)\s*$/);
+
+                let end = i + 1;
+
+                while (end < file.lines.length && !file.lines[end].startsWith('}')) {
+                    end++;
+                }
+
+                if (name) {
+                    result[name[1]] = { name: name[1], file: file.name, start: i, end: end };
+                }
+
+                signature = [];
+
+                i = end;
+            } else if (line.trim() === '' || line.startsWith('#') || line.startsWith('//') || /;\s*$/.test(line)) {
+                signature = [];
+            } else if (!line.startsWith(' *') && !line.startsWith('/*')) {
+                signature.push(line.trim());
+            }
+        }
+    }
+
+    return result;
+}
+
+/* Expands the macros in an expression until only the region bases and
+   constants (or identifiers we cannot resolve, like a loop index) remain */
+function expand (expression, file, line, depth = 0) {
+    if (depth > 16) {
+        return expression;
+    }
+
+    return expression.replace(/\b[A-Za-z_]\w*\b/g, (identifier) => {
+        if (regionBases[identifier]) {
+            return identifier;
+        }
+
+        const value = lookupDefine(identifier, file, line);
+
+        if (value === undefined || value === identifier) {
+            return identifier;
+        }
+
+        return '(' + expand(value, file, line, depth + 1) + ')';
+    });
+}
+
+/* Evaluates a constant expression, returning undefined if it is not one */
+function evaluate (expression) {
+    let constant = expression.replace(/sizeof\s*\(\s*([\w ]+?)\s*\)/g, (match, type) => {
+        return typeSizes[type] !== undefined ? typeSizes[type].toString() : match;
+    });
+
+    constant = constant.replace(/\(\s*(const\s+)?(unsigned\s+)?\w+\s*\*\s*\)/g, '');
+
+    if (!/^(0x[\da-fA-F]+|[\d\s+\-*/()])*$/.test(constant) || constant.trim() === '') {
+        return undefined;
+    }
+
+    try {
+        /* eslint-disable-next-line no-new-func */
+        return Math.floor(Function(`"use strict"; return (${constant});`)());
+    } catch (err) {
+        return undefined;
+    }
+}
+
+/* Resolves a macro to { region, offset, expression } if it addresses one of
+   the shared regions. Accessors such as readUint32BE(WORKING_SET + ...) are
+   unwrapped so that the field they read is reported */
+function resolveRegion (name, file, line) {
+    const value = lookupDefine(name, file, line);
+
+    if (value === undefined) {
+        return undefined;
+    }
+
+    let expanded = expand(value, file, line);
+
+    const accessor = expanded.match(/^\w+\s*\((.*)\)$/);
+
+    if (accessor) {
+        expanded = accessor[1];
+    }
+
+    const region = Object.keys(regionBases).find((base) => new RegExp(`\\b${base}\\b`).test(expanded));
+
+    if (!region) {
+        return undefined;
+    }
+
+    const relative = expanded.replace(new RegExp(`\\b${region}\\b`, 'g'), '0');
+
+    const offset = evaluate(relative);
+
+    return {
+        region: regionBases[region],
+        offset: offset,
+        expression: offset === undefined ? simplify(relative) : undefined
+    };
+}
+
+/* Tidies an expanded expression that could not be evaluated for display */
+function simplify (expression) {
+    let result = expression.replace(/sizeof\s*\(\s*(\w+)\s*\)/g, (match, type) => {
+        return typeSizes[type] !== undefined ? typeSizes[type].toString() : match;
+    });
+
+    let previous;
+
+    do {
+        previous = result;
+
+        result = result.replace(/\(\s*(\w+)\s*\)/g, '$1').replace(/\(\s*(\d+)\s*\+\s*(\d+)\s*\)/g, (match, a, b) => {
+            return (parseInt(a) + parseInt(b)).toString();
+        });
+    } while (result !== previous);
+
+    return result.replace(/^0\s*\+\s*/, '');
+}
+
+/* The identifiers referenced by the body of a function, with the line they are on */
+function references (fn) {
+    const file = files.find((sourceFile) => sourceFile.name === fn.file);
+
+    const result = [];
+
+    for (let i = fn.start; i <= fn.end; i++) {
+        const code = file.lines[i].replace(/\/\/.*$/, '');
+
+        for (const match of code.matchAll(/\b[A-Za-z_]\w*\b/g)) {
+            result.push({ identifier: match[0], line: i });
+        }
+    }
+
+    return result;
+}
+
+/* Everything that the functions of the given file can reach, following calls
+   into other files. UX flows reach their callbacks through the UX_STEP macros
+   so every function of the handler's own file is treated as a root */
+function reachable (file) {
+    const seen = new Set();
+
+    const pending = Object.values(functions).filter((fn) => fn.file === file).map((fn) => fn.name);
+
+    while (pending.length !== 0) {
+        const name = pending.pop();
+
+        if (seen.has(name)) {
+            continue;
+        }
+
+        seen.add(name);
+
+        for (const reference of references(functions[name])) {
+            if (functions[reference.identifier] && !seen.has(reference.identifier)) {
+                pending.push(reference.identifier);
+            }
+        }
+    }
+
+    return Array.from(seen).map((name) => functions[name]);
+}
+
+/* Collects the region fields used by the given functions */
+function regionFields (reachableFunctions) {
+    const fields = {};
+
+    for (const fn of reachableFunctions) {
+        for (const reference of references(fn)) {
+            const resolved = resolveRegion(reference.identifier, fn.file, reference.line);
+
+            if (!resolved || regionBases[reference.identifier] || regionAliases.includes(reference.identifier)) {
+                continue;
+            }
+
+            const key = `${resolved.region}:${reference.identifier}:${resolved.offset}:${resolved.expression}`;
+
+            fields[key] = fields[key] || {
+                region: resolved.region,
+                name: reference.identifier,
+                offset: resolved.offset,
+                expression: resolved.expression,
+                via: []
+            };
+
+            if (!fields[key].via.includes(fn.name)) {
+                fields[key].via.push(fn.name);
+            }
+        }
+
+        const file = files.find((sourceFile) => sourceFile.name === fn.file);
+
+        /* The regions cleared in full tell us their extent */
+        for (let i = fn.start; i <= fn.end; i++) {
+            const clear = file.lines[i].match(/explicit_bzero\(\s*(\w+)\s*,\s*([^)]+)\)/);
+
+            if (!clear) {
+                continue;
+            }
+
+            const resolved = resolveRegion(clear[1], fn.file, i);
+
+            const size = evaluate(expand(clear[2], fn.file, i));
+
+            if (resolved && size !== undefined) {
+                const key = `${resolved.region}:clear:${resolved.offset}:${size}`;
+
+                fields[key] = fields[key] || {
+                    region: resolved.region,
+                    name: '(cleared)',
+                    offset: resolved.offset,
+                    size: size,
+                    via: []
+                };
+
+                if (!fields[key].via.includes(fn.name)) {
+                    fields[key].via.push(fn.name);
+                }
+            }
+        }
+    }
+
+    return Object.values(fields).sort((a, b) => {
+        if (a.region !== b.region) {
+            return a.region < b.region ? -1 : 1;
+        }
+
+        return (a.offset === undefined ? Infinity : a.offset) - (b.offset === undefined ? Infinity : b.offset);
+    });
+}
+
+/* Maps each INS dispatched in main.c to its handler and the regions it uses */
+function collectHandlers (sourceFiles, allFunctions) {
+    const main = sourceFiles.find((file) => file.name === 'main.c');
+
+    const result = [];
+
+    main.lines.forEach((line, index) => {
+        const apdu = line.match(/^\s*case\s+(APDU_\w+)\s*:/);
+
+        if (!apdu) {
+            return;
+        }
+
+        const handler = main.lines.slice(index + 1, index + 3).join(' ').match(/\b(handle_\w+)\s*\(/);
+
+        if (!handler || !allFunctions[handler[1]]) {
+            return;
+        }
+
+        const fn = allFunctions[handler[1]];
+
+        const ins = evaluate(expand(apdu[1], 'main.c', index));
+
+        /* The input length the handler accepts */
+        let input;
+
+        for (const reference of references(fn)) {
+            if (reference.identifier !== 'dataLength') {
+                continue;
+            }
+
+            const file = sourceFiles.find((sourceFile) => sourceFile.name === fn.file);
+
+            const check = file.lines[reference.line].match(/dataLength\s*(!=|<|>)\s*(.+?)\s*(&&|\|\||$)/);
+
+            if (check) {
+                /* Drop the closing parenthesis of the if () the check sits in */
+                let limit = check[2];
+
+                while ((limit.match(/\)/g) || []).length > (limit.match(/\(/g) || []).length) {
+                    limit = limit.replace(/\)\s*$/, '');
+                }
+
+                const size = evaluate(expand(limit, fn.file, reference.line));
+
+                input = { check: check[1], size: size, expression: size === undefined ? limit : undefined };
+
+                break;
+            }
+        }
+
+        const fields = regionFields(reachable(fn.file));
+
+        result.push({
+            ins: ins,
+            apdu: apdu[1],
+            handler: fn.name,
+            file: fn.file,
+            input: input,
+            fields: fields
+        });
+    });
+
+    return result.sort((a, b) => a.ins - b.ins);
+}
+
+function hex (value) {
+    return '0x' + value.toString(16).padStart(2, '0');
+}
+
+function printReport (allHandlers) {
+    for (const handler of allHandlers) {
+        console.log(`${hex(handler.ins)} ${handler.apdu} -> ${handler.handler} (${handler.file})`);
+
+        if (handler.input) {
+            const limit = handler.input.size !== undefined ? handler.input.size : handler.input.expression;
+
+            const relation = { '!=': '==', '<': '>=', '>': '<=' }[handler.input.check];
+
+            console.log(`    input: dataLength ${relation} ${limit}`);
+        }
+
+        for (const region of Object.keys(regionBases)) {
+            const fields = handler.fields.filter((field) => field.region === region);
+
+            if (fields.length === 0) {
+                continue;
+            }
+
+            console.log(`    ${region}:`);
+
+            for (const field of fields) {
+                const offset = field.offset !== undefined ? `@${field.offset}` : `@${field.expression}`;
+
+                const size = field.size !== undefined ? ` ${field.size} bytes` : '';
+
+                console.log(`        ${offset.padEnd(8)} ${field.name}${size} (${field.via.join(', ')})`);
+            }
+        }
+
+        console.log('');
+    }
+}
\ No newline at end of file
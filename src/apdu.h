@@ -19,9 +19,12 @@
 
 #include <apdu_address.h>
 #include <apdu_check_key.h>
+#include <apdu_check_keys.h>
 #include <apdu_check_ringsignatures.h>
 #include <apdu_check_scalar.h>
+#include <apdu_check_scalars.h>
 #include <apdu_check_signature.h>
+#include <apdu_check_signatures.h>
 #include <apdu_complete_ringsignature.h>
 #include <apdu_debug.h>
 #include <apdu_derive_public_key.h>
@@ -31,22 +34,31 @@
 #include <apdu_generate_keyimage_primitive.h>
 #include <apdu_generate_ringsignatures.h>
 #include <apdu_generate_signature.h>
+#include <apdu_generate_signatures.h>
 #include <apdu_ident.h>
 #include <apdu_private_to_public.h>
 #include <apdu_public_keys.h>
 #include <apdu_random_key_pair.h>
 #include <apdu_reset_keys.h>
+#include <apdu_session_end.h>
+#include <apdu_session_start.h>
 #include <apdu_spend_secret_key.h>
 #include <apdu_tx_dump.h>
+#include <apdu_tx_dump_stream.h>
 #include <apdu_tx_finalize_prefix.h>
 #include <apdu_tx_input_load.h>
 #include <apdu_tx_output_load.h>
 #include <apdu_tx_reset.h>
 #include <apdu_tx_sign.h>
+#include <apdu_tx_sign_ring.h>
 #include <apdu_tx_start.h>
 #include <apdu_tx_start_input_load.h>
 #include <apdu_tx_start_output_load.h>
 #include <apdu_tx_state.h>
+#include <apdu_tx_stream_hint.h>
+#include <apdu_tx_stream_prefix.h>
+#include <apdu_tx_stream_start.h>
+#include <apdu_tx_verify.h>
 #include <apdu_version.h>
 #include <apdu_view_secret_key.h>
 #include <apdu_view_wallet_keys.h>
@@ -57,7 +69,19 @@
 #define APDU_VERSION 0x01
 
 /**
+ * P1 = 0x01 instead returns the cx_* call counts and deepest stack use (in bytes)
+ * of a PROFILE=1 build, bucketed by the INS of the APDU that made them, P1 = 0x02
+ * resets all of the counts and
+ * P1 = 0x03 returns the NVRAM programmed by the last APDU and by the transaction
+ * in each slot since it was started
+ *
  * @returns debug {1 byte}
+ *
+ * @returns bucket_count {1 byte} || (ins {1 byte} || apdus {4 bytes} || ticks {4 bytes} || stack {2 bytes}
+ *          || scalar_mult || decompress || powm || invprimem || hash || rng {4 bytes each}) {35 bytes each}
+ *
+ * @returns writes || bytes || page_programs || distinct_pages {4 bytes each}
+ *          || (writes || bytes || page_programs {4 bytes each}) {12 bytes per slot}
  */
 #define APDU_DEBUG 0x02
 
@@ -66,6 +90,20 @@
  */
 #define APDU_IDENT 0x05
 
+/**
+ * Starts a user approved session during which the non-confirm
+ * operations within the scope reply without a splash screen
+ *
+ * @param scope {1 byte} (0x01 = transactions, 0x02 = wallet sync, 0x03 = both)
+ * @returns
+ */
+#define APDU_SESSION_START 0x06
+
+/**
+ * @returns
+ */
+#define APDU_SESSION_END 0x07
+
 /**
  * @returns spend_public_key || view_public_key {64 bytes}
  */
@@ -109,6 +147,22 @@
  */
 #define APDU_RANDOM_KEY_PAIR 0x19
 
+/**
+ * Checks 1 - 14 public keys in one request, see APDU_CHECK_KEY
+ *
+ * @param public_keys {32 bytes * count}
+ * @returns valid {(count + 7) / 8 bytes} (bit i is set if key i is valid)
+ */
+#define APDU_CHECK_KEYS 0x1a
+
+/**
+ * Checks 1 - 14 private keys in one request, see APDU_CHECK_SCALAR
+ *
+ * @param private_keys {32 bytes * count}
+ * @returns valid {(count + 7) / 8 bytes} (bit i is set if scalar i is valid)
+ */
+#define APDU_CHECK_SCALARS 0x1b
+
 /**
  * @returns wallet_address {99 bytes}
  */
@@ -186,6 +240,45 @@
  */
 #define APDU_CHECK_SIGNATURE 0x56
 
+/**
+ * Starts a batch of count signatures made with the selected key (0x00 spend,
+ * 0x01 view) under a single approval that shows the count and the batch hash:
+ *
+ * batch_hash = H(digest[0] || H(digest[1] || ... H(digest[count - 1] || 0{32 bytes})))
+ *
+ * Input payload of 35 bytes
+ *
+ * @param key {1 byte}
+ * @param count {2 bytes}
+ * @param batch_hash {32 bytes}
+ * @returns
+ */
+#define APDU_GENERATE_SIGNATURES_START 0x57
+
+/**
+ * The next 1 - 4 digests of the approved batch along with the batch hash of
+ * the digests that follow them (all zero after the last digest). The chunk
+ * is only signed if it hashes back to the batch hash left by the previous
+ * chunk, any chunk that does not ends the batch
+ *
+ * @param message_digests {32 bytes * 1 - 4}
+ * @param next_batch_hash {32 bytes}
+ * @returns signatures {64 bytes * 1 - 4}
+ */
+#define APDU_GENERATE_SIGNATURES 0x58
+
+/**
+ * Checks 1 - 4 signatures of the same message digest
+ *
+ * Input payload of 32 + (96 bytes * count)
+ *
+ * @param message_digest {32 bytes}
+ * @param public_keys {32 bytes * count}
+ * @param signatures {64 bytes * count}
+ * @returns valid {1 byte} (bit i is set if signature i is valid)
+ */
+#define APDU_CHECK_SIGNATURES 0x59
+
 /**
  * @param tx_public_key
  * @returns key_derivation {32 bytes}
@@ -211,7 +304,20 @@
 #define APDU_DERIVE_SECRET_KEY 0x62
 
 /**
- * @returns state {1 byte}
+ * Every TX_* APDU selects the transaction slot it operates on with the low
+ * nibble of P2 (0 - TX_SLOT_COUNT - 1), so that the next transaction can be
+ * loaded while the previous one awaits approval, is signed or is dumped.
+ * While a transaction is in progress in any slot the read-only APDUs (keys and
+ * address, derivations, public ephemerals, key images and the checks) are still
+ * served; signing, exporting a private spend key or ephemeral and resetting the
+ * keys are refused.
+ *
+ * P1 = 0x01 additionally reports the construction and signing progress so that
+ * the host can continue a transaction restored after the application restarted
+ *
+ * @returns state {1 byte} || signed_input_count {1 byte} || input_count {1 byte}
+ *          || received_input_count {1 byte} || received_output_count {1 byte} || output_count {1 byte}
+ *          || sign_status {1 byte} (idle, awaiting approval, signing, rejected, failed)
  */
 #define APDU_TX_STATE 0x70
 
@@ -261,6 +367,22 @@
 #define APDU_TX_FINALIZE_PREFIX 0x76
 
 /**
+ * Signs the inputs one per ticker event. By default the reply is held until
+ * signing completes; with P2 | 0x80 the reply is sent as soon as the approval
+ * is displayed and the host polls APDU_TX_STATE, loading the next transaction
+ * into another slot in the meantime. Only one transaction can await approval
+ * or be signed at a time. Sending this again while in the signing state
+ * resumes from the last signed input without asking for approval again, and
+ * once complete it returns the result again.
+ *
+ * While the approval is displayed the inputs are already signed in the
+ * background; the signatures are only released once approved and are wiped
+ * if the transaction is rejected.
+ *
+ * In builds with COMPACT_PRESIG the rings are not kept, so the reply is always
+ * sent right away and nothing is signed until the host supplies every ring
+ * with APDU_TX_SIGN_RING once approved.
+ *
  * @returns tx_hash || tx_size {34 bytes}
  */
 #define APDU_TX_SIGN 0x77
@@ -276,6 +398,74 @@
  */
 #define APDU_TX_RESET 0x79
 
+/**
+ * Starts a transaction whose serialized prefix is streamed in with
+ * APDU_TX_STREAM_PREFIX instead of being built by APDU_TX_START through
+ * APDU_TX_FINALIZE_PREFIX
+ *
+ * @returns
+ */
+#define APDU_TX_STREAM_START 0x7a
+
+/**
+ * The secrets hint for the next input of a streamed prefix; it must arrive
+ * before the prefix bytes of the input it belongs to
+ *
+ * Input payload of 162 bytes
+ *
+ * @param input_tx_public_key {32 bytes}
+ * @param input_output_index {1 byte}
+ * @param public_keys {32 bytes * 4} (ring participant public keys)
+ * @param real_output_index {1 byte}
+ */
+#define APDU_TX_STREAM_HINT 0x7b
+
+/**
+ * The next chunk of the serialized prefix, a chunk may end anywhere in the
+ * prefix. The key image of each input must match its hint. Once the extra
+ * field has been received the transaction is ready to be signed
+ *
+ * @param prefix {1 - 255 bytes}
+ */
+#define APDU_TX_STREAM_PREFIX 0x7c
+
+/**
+ * Checks the ring signatures of every input of the completed transaction
+ * against its prefix, key images and ring members
+ *
+ * @returns valid {(input_count + 7) / 8 bytes} (bit i is set if the ring signatures of input i are valid)
+ */
+#define APDU_TX_VERIFY 0x7d
+
+/**
+ * Signs the given input of the approved transaction with its ring members,
+ * which must be the ones the input was loaded with. The inputs are signed in
+ * order and an input that is already signed is skipped, so a request can be
+ * retried. This is the only way to sign in builds with COMPACT_PRESIG, where
+ * only a commitment to each ring is kept (and APDU_TX_VERIFY is refused);
+ * otherwise it signs alongside the ticker
+ *
+ * Input payload of 129 bytes
+ *
+ * @param input_index {1 byte}
+ * @param public_keys {32 bytes * 4} (ring participant public keys)
+ * @returns signed_input_count {1 byte}
+ */
+#define APDU_TX_SIGN_RING 0x7e
+
+/**
+ * Dumps the completed transaction from a cursor kept on the device, so the
+ * host simply repeats the request until it has every byte; nothing is shown
+ * for each chunk. P1 = 0x01 rewinds the cursor to the start, adding 0x02
+ * (P1 = 0x03) follows the last byte of the transaction with its hash. Each
+ * response is a full chunk except the last, which is shorter (and empty if
+ * the stream ends on a chunk boundary). Continuing a stream that was never
+ * started, or whose slot was reset since, is refused
+ *
+ * @returns raw_transaction || tx_hash (if requested) {0 - 448 bytes per response}
+ */
+#define APDU_TX_DUMP_STREAM 0x7f
+
 /**
  * @returns nothing
  */
@@ -16,7 +16,6 @@
 
 #include <apdu_address.h>
 #include <keys.h>
-#include <transaction.h>
 #include <utils.h>
 
 #define APDU_ADDRESS WORKING_SET
@@ -61,17 +60,8 @@ void handle_address(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volati
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
-    {
-        return sendError(ERR_TRANSACTION_STATE);
-    }
-
-    const uint16_t status = generate_public_address(PTR_SPEND_PUBLIC, PTR_VIEW_PUBLIC, APDU_ADDRESS);
-
-    if (status != OP_OK)
-    {
-        return sendError(status);
-    }
+    // computed once by init_keys
+    os_memmove(APDU_ADDRESS, PTR_ADDRESS, BASE58_ADDRESS_SIZE);
 
     /**
      * If the APDU was sent requesting confirmation then
@@ -17,7 +17,7 @@
 #include "apdu_check_key.h"
 
 #include <keys.h>
-#include <transaction.h>
+#include <session.h>
 #include <utils.h>
 
 #define APDU_CK_SCALAR WORKING_SET
@@ -59,11 +59,7 @@ void handle_check_key(
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
-    {
-        return sendError(ERR_TRANSACTION_STATE);
-    }
-    else if (dataLength != KEY_SIZE)
+    if (dataLength != KEY_SIZE)
     {
         return sendError(ERR_WRONG_INPUT_LENGTH);
     }
@@ -71,7 +67,5 @@ void handle_check_key(
     // copy the data buffer into the working set
     os_memmove(WORKING_SET, dataBuffer, dataLength);
 
-    ux_flow_init(0, ux_check_key_flow, NULL);
-
-    *flags |= IO_ASYNCH_REPLY;
+    session_dispatch(SESSION_SCOPE_SYNC, ux_check_key_flow, do_check_key, flags);
 }
\ No newline at end of file
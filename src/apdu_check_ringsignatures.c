@@ -17,7 +17,6 @@
 #include "apdu_check_ringsignatures.h"
 
 #include <keys.h>
-#include <transaction.h>
 #include <utils.h>
 
 #define APDU_CHRS_SIZE KEY_SIZE + KEY_SIZE + (KEY_SIZE * RING_PARTICIPANTS) + (SIG_SIZE * RING_PARTICIPANTS)
@@ -68,11 +67,7 @@ void handle_check_ring_signatures(
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
-    {
-        return sendError(ERR_TRANSACTION_STATE);
-    }
-    else if (dataLength != APDU_CHRS_SIZE)
+    if (dataLength != APDU_CHRS_SIZE)
     {
         return sendError(ERR_WRONG_INPUT_LENGTH);
     }
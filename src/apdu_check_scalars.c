@@ -0,0 +1,84 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "apdu_check_scalars.h"
+
+#include <keys.h>
+#include <session.h>
+#include <utils.h>
+
+#define APDU_CSC_SCALARS WORKING_SET
+#define APDU_CSC_RESULTS APDU_CSC_SCALARS + (CHECK_SCALARS_MAX * KEY_SIZE)
+
+// the number of scalars in the current request
+static uint8_t L_count;
+
+static void do_check_scalars()
+{
+    BEGIN_TRY
+    {
+        TRY
+        {
+            const uint16_t status = hw_check_scalars(APDU_CSC_RESULTS, APDU_CSC_SCALARS, L_count);
+
+            if (status != OP_OK)
+            {
+                THROW(status);
+            }
+
+            CLOSE_TRY;
+
+            sendResponse(write_io_hybrid(APDU_CSC_RESULTS, (L_count + 7) / 8, APDU_CHECK_SCALARS_NAME, true), true);
+        }
+        CATCH_OTHER(e)
+        {
+            sendError(ERR_CHECK_SCALAR);
+        }
+        FINALLY
+        {
+            // Explicitly clear the working memory
+            explicit_bzero(WORKING_SET, WORKING_SET_SIZE);
+        };
+    }
+    END_TRY;
+}
+
+UX_STEP_SPLASH(ux_check_scalars_1_step, pnn, do_check_scalars(), {&C_icon_turtlecoin, "Checking", "Scalars"});
+
+UX_FLOW(ux_check_scalars_flow, &ux_check_scalars_1_step);
+
+void handle_check_scalars(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *dataBuffer,
+    uint16_t dataLength,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx)
+{
+    UNUSED(p2);
+
+    if (dataLength == 0 || dataLength % KEY_SIZE != 0 || dataLength > CHECK_SCALARS_MAX * KEY_SIZE)
+    {
+        return sendError(ERR_WRONG_INPUT_LENGTH);
+    }
+
+    L_count = dataLength / KEY_SIZE;
+
+    // copy the data buffer into the working set
+    os_memmove(WORKING_SET, dataBuffer, dataLength);
+
+    session_dispatch(SESSION_SCOPE_SYNC, ux_check_scalars_flow, do_check_scalars, flags);
+}
\ No newline at end of file
@@ -17,7 +17,6 @@
 #include "apdu_check_signature.h"
 
 #include <keys.h>
-#include <transaction.h>
 #include <utils.h>
 
 #define APDU_CS_SIZE KEY_SIZE + KEY_SIZE + SIG_SIZE
@@ -62,11 +61,7 @@ void handle_check_signature(
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
-    {
-        return sendError(ERR_TRANSACTION_STATE);
-    }
-    else if (dataLength != APDU_CS_SIZE)
+    if (dataLength != APDU_CS_SIZE)
     {
         return sendError(ERR_WRONG_INPUT_LENGTH);
     }
@@ -0,0 +1,91 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "apdu_check_signatures.h"
+
+#include <keys.h>
+#include <session.h>
+#include <utils.h>
+
+#define APDU_CSS_ITEM_SIZE KEY_SIZE + SIG_SIZE
+#define APDU_CSS_MESSAGE_DIGEST WORKING_SET
+#define APDU_CSS_PUBLIC_KEYS APDU_CSS_MESSAGE_DIGEST + KEY_SIZE
+#define APDU_CSS_SIGNATURES APDU_CSS_PUBLIC_KEYS + (L_count * KEY_SIZE)
+
+// the number of signatures in the current request
+static uint8_t L_count;
+
+static void do_check_signatures()
+{
+    BEGIN_TRY
+    {
+        TRY
+        {
+            unsigned char results = 0;
+
+            const uint16_t status = hw_check_signatures(
+                &results, APDU_CSS_MESSAGE_DIGEST, L_count, APDU_CSS_PUBLIC_KEYS, APDU_CSS_SIGNATURES);
+
+            if (status != OP_OK)
+            {
+                THROW(status);
+            }
+
+            CLOSE_TRY;
+
+            sendResponse(write_io_hybrid(&results, sizeof(results), APDU_CHECK_SIGNATURES_NAME, true), true);
+        }
+        CATCH_OTHER(e)
+        {
+            sendError(ERR_CHECK_SIGNATURE);
+        }
+        FINALLY
+        {
+            // Explicitly clear the working memory
+            explicit_bzero(WORKING_SET, WORKING_SET_SIZE);
+        }
+    }
+    END_TRY;
+}
+
+UX_STEP_SPLASH(ux_check_signatures_1_step, pnn, do_check_signatures(), {&C_icon_turtlecoin, "Checking", "Signatures"});
+
+UX_FLOW(ux_check_signatures_flow, &ux_check_signatures_1_step);
+
+void handle_check_signatures(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *dataBuffer,
+    uint16_t dataLength,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx)
+{
+    UNUSED(p2);
+
+    if (
+        dataLength < KEY_SIZE + APDU_CSS_ITEM_SIZE || (dataLength - KEY_SIZE) % (APDU_CSS_ITEM_SIZE) != 0
+        || (dataLength - KEY_SIZE) / (APDU_CSS_ITEM_SIZE) > CHECK_SIGNATURES_MAX)
+    {
+        return sendError(ERR_WRONG_INPUT_LENGTH);
+    }
+
+    L_count = (dataLength - KEY_SIZE) / (APDU_CSS_ITEM_SIZE);
+
+    // copy the data buffer into the working set
+    os_memmove(WORKING_SET, dataBuffer, dataLength);
+
+    session_dispatch(SESSION_SCOPE_SYNC, ux_check_signatures_flow, do_check_signatures, flags);
+}
\ No newline at end of file
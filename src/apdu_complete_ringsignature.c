@@ -116,7 +116,7 @@ void handle_complete_ring_signature(
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
+    if (tx_in_progress())
     {
         return sendError(ERR_TRANSACTION_STATE);
     }
@@ -16,12 +16,46 @@
 
 #include "apdu_debug.h"
 
+#include <profile.h>
+#include <transaction.h>
 #include <utils.h>
 
-void handle_debug()
+void handle_debug(uint8_t p1)
 {
     unsigned char status = DEBUG_BUILD == 1;
 
+#if PROFILE_BUILD == 1
+    if (p1 == P1_DEBUG_PROFILE)
+    {
+        unsigned char profile[PROFILE_SIZE];
+
+        const uint16_t length = profile_dump(profile);
+
+        return sendResponse(write_io_hybrid(profile, length, APDU_DEBUG_PROFILE_NAME, true), true);
+    }
+
+    if (p1 == P1_DEBUG_PROFILE_RESET)
+    {
+        profile_reset();
+
+        return sendResponse(0, true);
+    }
+
+    if (p1 == P1_DEBUG_NVM)
+    {
+        unsigned char nvm[PROFILE_NVM_SIZE];
+
+        const uint16_t length = profile_nvm_dump(nvm);
+
+        return sendResponse(write_io_hybrid(nvm, length, APDU_DEBUG_NVM_NAME, true), true);
+    }
+#endif
+
+    if (p1 != P1_DEBUG_STATUS)
+    {
+        return sendError(ERR_OP_NOT_PERMITTED);
+    }
+
     /**
      * This is static non-privileged information and as thus
      * can be returned without any additional checking
@@ -17,8 +17,17 @@
 #ifndef APDU_DEBUG_H
 #define APDU_DEBUG_H
 
+#include <stdint.h>
+
 #define APDU_DEBUG_NAME ((unsigned char *)"DEBUG")
+#define APDU_DEBUG_PROFILE_NAME ((unsigned char *)"PROFILE")
+#define APDU_DEBUG_NVM_NAME ((unsigned char *)"NVM")
+
+#define P1_DEBUG_STATUS 0x00
+#define P1_DEBUG_PROFILE 0x01 // PROFILE=1 builds only
+#define P1_DEBUG_PROFILE_RESET 0x02 // PROFILE=1 builds only
+#define P1_DEBUG_NVM 0x03 // PROFILE=1 builds only
 
-void handle_debug();
+void handle_debug(uint8_t p1);
 
 #endif // APDU_DEBUG_H
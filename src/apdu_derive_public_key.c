@@ -17,7 +17,7 @@
 #include "apdu_derive_public_key.h"
 
 #include <keys.h>
-#include <transaction.h>
+#include <session.h>
 #include <utils.h>
 
 #define APDU_DPK_SIZE KEY_SIZE + sizeof(uint32_t)
@@ -60,6 +60,11 @@ static void do_derive_public_key(const size_t approve_all_this_session)
     END_TRY;
 }
 
+static void do_derive_public_key_session()
+{
+    do_derive_public_key(pre_approved);
+}
+
 UX_STEP_SPLASH(
     ux_display_derive_public_key_manual_flow_1_step,
     pnn,
@@ -109,11 +114,7 @@ void handle_derive_public_key(
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
-    {
-        return sendError(ERR_TRANSACTION_STATE);
-    }
-    else if (dataLength != APDU_DPK_SIZE)
+    if (dataLength != APDU_DPK_SIZE)
     {
         return sendError(ERR_WRONG_INPUT_LENGTH);
     }
@@ -128,11 +129,13 @@ void handle_derive_public_key(
      * async and will be completed shortly unless approval
      * was already provided in this application "session"
      */
-    if (pre_approved == 1)
+    if (pre_approved == 1 || session_active(SESSION_SCOPE_SYNC))
     {
-        ux_flow_init(0, ux_display_derive_public_key_auto_flow, NULL);
-
-        *flags |= IO_ASYNCH_REPLY;
+        session_dispatch(
+            SESSION_SCOPE_SYNC,
+            ux_display_derive_public_key_auto_flow,
+            do_derive_public_key_session,
+            flags);
     }
     else if (p1 == P1_CONFIRM)
     {
@@ -99,7 +99,7 @@ void handle_derive_secret_key(
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
+    if (tx_in_progress())
     {
         return sendError(ERR_TRANSACTION_STATE);
     }
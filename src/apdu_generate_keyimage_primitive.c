@@ -17,7 +17,7 @@
 #include "apdu_generate_keyimage_primitive.h"
 
 #include <keys.h>
-#include <transaction.h>
+#include <session.h>
 #include <utils.h>
 
 #define APDU_GKIP_SIZE KEY_SIZE + sizeof(uint32_t) + KEY_SIZE
@@ -71,6 +71,11 @@ static void do_generate_key_image_primitive(const size_t approve_all_this_sessio
     END_TRY;
 }
 
+static void do_generate_key_image_primitive_session()
+{
+    do_generate_key_image_primitive(pre_approved);
+}
+
 UX_STEP_SPLASH(
     ux_display_generate_keyimage_primitive_manual_flow_1_step,
     pnn,
@@ -126,11 +131,7 @@ void handle_generate_keyimage_primitive(
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
-    {
-        return sendError(ERR_TRANSACTION_STATE);
-    }
-    else if (dataLength != APDU_GKIP_SIZE)
+    if (dataLength != APDU_GKIP_SIZE)
     {
         return sendError(ERR_WRONG_INPUT_LENGTH);
     }
@@ -147,11 +148,13 @@ void handle_generate_keyimage_primitive(
      * async and will be completed shortly unless approval
      * was already provided in this application "session"
      */
-    if (pre_approved == 1)
+    if (pre_approved == 1 || session_active(SESSION_SCOPE_SYNC))
     {
-        ux_flow_init(0, ux_display_generate_keyimage_primitive_auto_flow, NULL);
-
-        *flags |= IO_ASYNCH_REPLY;
+        session_dispatch(
+            SESSION_SCOPE_SYNC,
+            ux_display_generate_keyimage_primitive_auto_flow,
+            do_generate_key_image_primitive_session,
+            flags);
     }
     else if (p1 == P1_CONFIRM)
     {
@@ -118,7 +118,7 @@ void handle_generate_ring_signatures(
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
+    if (tx_in_progress())
     {
         return sendError(ERR_TRANSACTION_STATE);
     }
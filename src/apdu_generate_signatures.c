@@ -0,0 +1,306 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "apdu_generate_signatures.h"
+
+#include <keys.h>
+#include <transaction.h>
+#include <utils.h>
+
+#define APDU_GSS_SIZE sizeof(uint8_t) + sizeof(uint16_t) + KEY_SIZE
+#define APDU_GSS_KEY_IDX WORKING_SET
+#define APDU_GSS_KEY readUint8(APDU_GSS_KEY_IDX)
+#define APDU_GSS_COUNT_IDX APDU_GSS_KEY_IDX + sizeof(uint8_t)
+#define APDU_GSS_COUNT readUint16BE(APDU_GSS_COUNT_IDX)
+#define APDU_GSS_BATCH_HASH APDU_GSS_COUNT_IDX + sizeof(uint16_t)
+#define APDU_GSS_BATCH_HASH_HEX APDU_GSS_BATCH_HASH + KEY_SIZE
+#define APDU_GSS_SUMMARY APDU_GSS_BATCH_HASH_HEX + KEY_HEXSTR_SIZE
+
+#define APDU_GS_MESSAGE_DIGESTS WORKING_SET
+#define APDU_GS_NEXT_LINK(count) (APDU_GS_MESSAGE_DIGESTS + ((count) * KEY_SIZE))
+#define APDU_GS_SIGNATURES APDU_GS_NEXT_LINK(SIGNATURES_CHUNK_SIZE + 1)
+
+// locally stored state of the user approved signature batch (if any)
+static signature_batch_t L_batch;
+
+// the number of digests in the current chunk
+static uint8_t L_chunk_count;
+
+void generate_signatures_clear()
+{
+    explicit_bzero(&L_batch, sizeof(L_batch));
+}
+
+/**
+ * Walks the hash chain of the current chunk back from the link the host
+ * supplied for the digests that follow it, such that
+ * link = H(digest || next_link), and checks that it ends at the link the
+ * user approved (or the last approved chunk left behind)
+ * @return OP_OK if the chunk belongs to the batch, ERR_SIGNATURE_BATCH if it does not
+ */
+static uint16_t check_chunk()
+{
+    unsigned char pair[KEY_SIZE * 2];
+
+    unsigned char link[KEY_SIZE];
+
+    os_memmove(link, APDU_GS_NEXT_LINK(L_chunk_count), KEY_SIZE);
+
+    // the last digest of the batch is chained to an all zero link
+    if (L_chunk_count == L_batch.remaining && !cx_math_is_zero(link, KEY_SIZE))
+    {
+        return ERR_SIGNATURE_BATCH;
+    }
+
+    uint8_t i;
+
+    for (i = L_chunk_count; i > 0; i--)
+    {
+        os_memmove(pair, APDU_GS_MESSAGE_DIGESTS + ((i - 1) * KEY_SIZE), KEY_SIZE);
+
+        os_memmove(pair + KEY_SIZE, link, KEY_SIZE);
+
+        const uint16_t status = hw_keccak(pair, sizeof(pair), link);
+
+        if (status != OP_OK)
+        {
+            return status;
+        }
+    }
+
+    if (os_memcmp(link, L_batch.link, KEY_SIZE) != 0)
+    {
+        return ERR_SIGNATURE_BATCH;
+    }
+
+    return OP_OK;
+}
+
+static void do_generate_signatures()
+{
+    BEGIN_TRY
+    {
+        TRY
+        {
+            uint16_t status = check_chunk();
+
+            if (status != OP_OK)
+            {
+                THROW(status);
+            }
+
+            if (L_batch.key == SIGNATURES_KEY_VIEW)
+            {
+                status = hw_generate_signatures(
+                    APDU_GS_SIGNATURES, APDU_GS_MESSAGE_DIGESTS, L_chunk_count, PTR_VIEW_PUBLIC, PTR_VIEW_PRIVATE);
+            }
+            else
+            {
+                status = hw_generate_signatures(
+                    APDU_GS_SIGNATURES, APDU_GS_MESSAGE_DIGESTS, L_chunk_count, PTR_SPEND_PUBLIC, PTR_SPEND_PRIVATE);
+            }
+
+            if (status != OP_OK)
+            {
+                THROW(status);
+            }
+
+            // the next chunk picks up from the link the host sent with this one
+            os_memmove(L_batch.link, APDU_GS_NEXT_LINK(L_chunk_count), KEY_SIZE);
+
+            L_batch.remaining -= L_chunk_count;
+
+            if (L_batch.remaining == 0)
+            {
+                generate_signatures_clear();
+            }
+
+            CLOSE_TRY;
+
+            sendResponse(
+                write_io_hybrid(APDU_GS_SIGNATURES, L_chunk_count * SIG_SIZE, APDU_GENERATE_SIGNATURES_NAME, true),
+                true);
+        }
+        CATCH_OTHER(e)
+        {
+            // a chunk that does not belong to the batch ends it
+            generate_signatures_clear();
+
+            sendError(e);
+        }
+        FINALLY
+        {
+            // Explicitly clear the working memory
+            explicit_bzero(WORKING_SET, WORKING_SET_SIZE);
+        };
+    }
+    END_TRY;
+}
+
+static void do_generate_signatures_start()
+{
+    L_batch.key = APDU_GSS_KEY;
+
+    L_batch.remaining = APDU_GSS_COUNT;
+
+    os_memmove(L_batch.link, APDU_GSS_BATCH_HASH, KEY_SIZE);
+
+    L_batch.approved = 1;
+
+    // Explicitly clear the working memory
+    explicit_bzero(WORKING_SET, WORKING_SET_SIZE);
+
+    sendResponse(0, true);
+}
+
+UX_STEP_SPLASH(
+    ux_generate_signatures_start_splash_1_step,
+    pnn,
+    do_generate_signatures_start(),
+    {&C_icon_turtlecoin, "Starting", "Batch..."});
+
+UX_FLOW(ux_generate_signatures_start_splash, &ux_generate_signatures_start_splash_1_step);
+
+UX_STEP_NOCB(
+    ux_generate_signatures_start_flow_1_step,
+    bnnn_paging,
+    {.title = "Sign Batch?", .text = (char *)APDU_GSS_SUMMARY});
+
+UX_STEP_NOCB(
+    ux_generate_signatures_start_flow_2_step,
+    bnnn_paging,
+    {.title = "Batch Hash", .text = (char *)APDU_GSS_BATCH_HASH_HEX});
+
+UX_STEP_VALID(
+    ux_generate_signatures_start_flow_3_step,
+    pb,
+    ux_flow_init(0, ux_generate_signatures_start_splash, NULL),
+    {&C_icon_validate_14, "Approve"});
+
+UX_STEP_VALID(ux_generate_signatures_start_flow_4_step, pb, do_deny(), {&C_icon_crossmark, "Reject"});
+
+UX_FLOW(
+    ux_generate_signatures_start_flow,
+    &ux_generate_signatures_start_flow_1_step,
+    &ux_generate_signatures_start_flow_2_step,
+    &ux_generate_signatures_start_flow_3_step,
+    &ux_generate_signatures_start_flow_4_step);
+
+void handle_generate_signatures_start(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *dataBuffer,
+    uint16_t dataLength,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx)
+{
+    UNUSED(p2);
+
+    // whatever happens to this request, the previous batch is over
+    generate_signatures_clear();
+
+    if (tx_in_progress())
+    {
+        return sendError(ERR_TRANSACTION_STATE);
+    }
+    else if (dataLength != APDU_GSS_SIZE)
+    {
+        return sendError(ERR_WRONG_INPUT_LENGTH);
+    }
+
+    // copy the data buffer into the working set
+    os_memmove(WORKING_SET, dataBuffer, dataLength);
+
+    if (APDU_GSS_COUNT == 0 || (APDU_GSS_KEY != SIGNATURES_KEY_SPEND && APDU_GSS_KEY != SIGNATURES_KEY_VIEW))
+    {
+        return sendError(ERR_SIGNATURE_BATCH);
+    }
+
+    toHexString(APDU_GSS_BATCH_HASH, KEY_SIZE, APDU_GSS_BATCH_HASH_HEX, KEY_HEXSTR_SIZE);
+
+    SPRINTF(
+        (char *)APDU_GSS_SUMMARY,
+        "%u digests, %s key",
+        (unsigned int)APDU_GSS_COUNT,
+        (APDU_GSS_KEY == SIGNATURES_KEY_VIEW) ? "view" : "spend");
+
+    /**
+     * The user approves the count and the batch hash once, after
+     * which the digests are signed as they are streamed in without
+     * any further confirmation
+     */
+    if (p1 == P1_CONFIRM)
+    {
+        ux_flow_init(0, ux_generate_signatures_start_flow, NULL);
+
+        *flags |= IO_ASYNCH_REPLY;
+    }
+    else if (p1 == P1_NON_CONFIRM && DEBUG_BUILD == 1)
+    {
+        ux_flow_init(0, ux_generate_signatures_start_splash, NULL);
+
+        *flags |= IO_ASYNCH_REPLY;
+    }
+    else
+    {
+        sendError(ERR_OP_USER_REQUIRED);
+    }
+}
+
+void handle_generate_signatures(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *dataBuffer,
+    uint16_t dataLength,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx)
+{
+    UNUSED(p1);
+
+    UNUSED(p2);
+
+    if (tx_in_progress())
+    {
+        return sendError(ERR_TRANSACTION_STATE);
+    }
+    else if (L_batch.approved != 1)
+    {
+        return sendError(ERR_OP_USER_REQUIRED);
+    }
+    else if (
+        dataLength % KEY_SIZE != 0 || dataLength < 2 * KEY_SIZE
+        || dataLength > (SIGNATURES_CHUNK_SIZE + 1) * KEY_SIZE)
+    {
+        return sendError(ERR_WRONG_INPUT_LENGTH);
+    }
+
+    L_chunk_count = (dataLength / KEY_SIZE) - 1;
+
+    if (L_chunk_count > L_batch.remaining)
+    {
+        generate_signatures_clear();
+
+        return sendError(ERR_SIGNATURE_BATCH);
+    }
+
+    // copy the data buffer into the working set
+    os_memmove(WORKING_SET, dataBuffer, dataLength);
+
+    // the batch was approved as a whole so each chunk is signed straight away
+    do_generate_signatures();
+
+    *flags |= IO_ASYNCH_REPLY;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#ifndef APDU_GENERATE_SIGNATURES_H
+#define APDU_GENERATE_SIGNATURES_H
+
+#include <common.h>
+#include <stdint.h>
+
+#define APDU_GENERATE_SIGNATURES_START_NAME ((unsigned char *)"GENSIGS_START")
+#define APDU_GENERATE_SIGNATURES_NAME ((unsigned char *)"GENSIGS")
+
+#define SIGNATURES_KEY_SPEND 0x00
+#define SIGNATURES_KEY_VIEW 0x01
+
+#define SIGNATURES_CHUNK_SIZE 4 // digests per APDU, their signatures take 256 bytes of the working set
+
+typedef struct signature_batch_s // 36-bytes
+{
+    unsigned char link[KEY_SIZE]; // 32-bytes, the batch hash of the digests still to be signed
+
+    uint16_t remaining; // 2-bytes
+
+    uint8_t key; // 1-byte
+
+    uint8_t approved; // 1-byte
+} signature_batch_t;
+
+void generate_signatures_clear();
+
+void handle_generate_signatures_start(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *dataBuffer,
+    uint16_t dataLength,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx);
+
+void handle_generate_signatures(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *dataBuffer,
+    uint16_t dataLength,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx);
+
+#endif // APDU_GENERATE_SIGNATURES_H
\ No newline at end of file
@@ -17,7 +17,6 @@
 #include "apdu_private_to_public.h"
 
 #include <keys.h>
-#include <transaction.h>
 #include <utils.h>
 
 #define APDU_PTP_SIZE KEY_SIZE
@@ -72,11 +71,7 @@ void handle_private_to_public(
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
-    {
-        return sendError(ERR_TRANSACTION_STATE);
-    }
-    else if (dataLength != APDU_PTP_SIZE)
+    if (dataLength != APDU_PTP_SIZE)
     {
         return sendError(ERR_WRONG_INPUT_LENGTH);
     }
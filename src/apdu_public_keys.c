@@ -17,7 +17,6 @@
 #include "apdu_public_keys.h"
 
 #include <keys.h>
-#include <transaction.h>
 #include <utils.h>
 
 #define APDU_PK_KEYS WORKING_SET
@@ -67,11 +66,6 @@ void handle_public_keys(uint8_t p1, uint8_t p2, volatile unsigned int *flags, vo
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
-    {
-        return sendError(ERR_TRANSACTION_STATE);
-    }
-
     toHexString(PTR_SPEND_PUBLIC, KEY_SIZE, APDU_PK_SPEND, KEY_HEXSTR_SIZE);
 
     toHexString(PTR_VIEW_PUBLIC, KEY_SIZE, APDU_PK_VIEW, KEY_HEXSTR_SIZE);
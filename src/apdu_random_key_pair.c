@@ -17,7 +17,6 @@
 #include "apdu_random_key_pair.h"
 
 #include <keys.h>
-#include <transaction.h>
 #include <utils.h>
 
 static void do_generate_random_key_pair()
@@ -64,11 +63,6 @@ UX_FLOW(ux_generate_random_key_pair_flow, &ux_generate_random_key_pair_flow_1_st
 
 void handle_generate_random_key_pair(volatile unsigned int *flags)
 {
-    if (tx_state() != TX_UNUSED)
-    {
-        return sendError(ERR_TRANSACTION_STATE);
-    }
-
     ux_flow_init(0, ux_generate_random_key_pair_flow, NULL);
 
     *flags |= IO_ASYNCH_REPLY;
@@ -16,6 +16,7 @@
 
 #include "apdu_reset_keys.h"
 
+#include <apdu_generate_signatures.h>
 #include <keys.h>
 #include <transaction.h>
 #include <utils.h>
@@ -26,6 +27,9 @@ static void do_reset_keys()
     {
         TRY
         {
+            // an approved signature batch was approved for the old keys
+            generate_signatures_clear();
+
             const uint16_t status = reset_keys();
 
             if (status != OP_OK)
@@ -70,7 +74,7 @@ void handle_reset(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volatile
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
+    if (tx_in_progress())
     {
         return sendError(ERR_TRANSACTION_STATE);
     }
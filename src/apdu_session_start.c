@@ -0,0 +1,121 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "apdu_session_start.h"
+
+#include <apdu_tx_sign.h>
+#include <session.h>
+#include <transaction.h>
+#include <utils.h>
+
+#define APDU_SESSION_START_SIZE sizeof(uint8_t)
+
+#define APDU_SS_SCOPE_IDX WORKING_SET
+#define APDU_SS_SCOPE readUint8(APDU_SS_SCOPE_IDX)
+
+static void do_session_start()
+{
+    session_start(APDU_SS_SCOPE);
+
+    // Explicitly clear any display information
+    explicit_bzero(DISPLAY_KEY_HEX, KEY_HEXSTR_SIZE);
+
+    sendResponse(0, true);
+}
+
+UX_STEP_SPLASH(ux_session_start_splash_1_step, pnn, do_session_start(), {&C_icon_turtlecoin, "Starting", "Session..."});
+
+UX_FLOW(ux_session_start_splash, &ux_session_start_splash_1_step);
+
+UX_STEP_NOCB(ux_session_start_flow_1_step, pnn, {&C_icon_turtlecoin, "Start", "Session?"});
+
+UX_STEP_NOCB(ux_session_start_flow_2_step, bnnn_paging, {.title = "Scope", .text = (char *)DISPLAY_KEY_HEX});
+
+UX_STEP_VALID(
+    ux_session_start_flow_3_step,
+    pb,
+    ux_flow_init(0, ux_session_start_splash, NULL),
+    {&C_icon_validate_14, "Approve"});
+
+UX_STEP_VALID(ux_session_start_flow_4_step, pb, do_deny(), {&C_icon_crossmark, "Reject"});
+
+UX_FLOW(
+    ux_session_start_flow,
+    &ux_session_start_flow_1_step,
+    &ux_session_start_flow_2_step,
+    &ux_session_start_flow_3_step,
+    &ux_session_start_flow_4_step);
+
+void handle_session_start(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *dataBuffer,
+    uint16_t dataLength,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx)
+{
+    UNUSED(p2);
+
+    // the session confirmation would take the display from a transaction awaiting approval or being signed
+    if (tx_sign_ui_pending())
+    {
+        return sendError(ERR_TRANSACTION_STATE);
+    }
+    else if (dataLength != APDU_SESSION_START_SIZE)
+    {
+        return sendError(ERR_WRONG_INPUT_LENGTH);
+    }
+
+    // copy the data buffer into the working set
+    os_memmove(WORKING_SET, dataBuffer, dataLength);
+
+    switch (APDU_SS_SCOPE)
+    {
+        case SESSION_SCOPE_TX:
+            os_memmove(DISPLAY_KEY_HEX, "Transactions", 13);
+            break;
+        case SESSION_SCOPE_SYNC:
+            os_memmove(DISPLAY_KEY_HEX, "Wallet Sync", 12);
+            break;
+        case SESSION_SCOPE_ALL:
+            os_memmove(DISPLAY_KEY_HEX, "Transactions & Wallet Sync", 27);
+            break;
+        default:
+            return sendError(ERR_SESSION_SCOPE);
+    }
+
+    /**
+     * A session is only ever started with the explicit approval
+     * of the user as it removes the per request approval of the
+     * operations that fall within its scope
+     */
+    if (p1 == P1_CONFIRM)
+    {
+        ux_flow_init(0, ux_session_start_flow, NULL);
+
+        *flags |= IO_ASYNCH_REPLY;
+    }
+    else if (p1 == P1_NON_CONFIRM && DEBUG_BUILD == 1)
+    {
+        ux_flow_init(0, ux_session_start_splash, NULL);
+
+        *flags |= IO_ASYNCH_REPLY;
+    }
+    else
+    {
+        sendError(ERR_OP_USER_REQUIRED);
+    }
+}
\ No newline at end of file
@@ -97,7 +97,7 @@ void handle_spend_secret_key(uint8_t p1, uint8_t p2, volatile unsigned int *flag
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
+    if (tx_in_progress())
     {
         return sendError(ERR_TRANSACTION_STATE);
     }
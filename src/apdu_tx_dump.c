@@ -16,6 +16,7 @@
 
 #include "apdu_tx_dump.h"
 
+#include <session.h>
 #include <transaction.h>
 #include <utils.h>
 
@@ -78,7 +79,12 @@ void handle_tx_dump(
 {
     UNUSED(p1);
 
-    UNUSED(p2);
+    const uint16_t slot_status = tx_select(p2 & P2_TX_SLOT_MASK);
+
+    if (slot_status != OP_OK)
+    {
+        return sendError(slot_status);
+    }
 
     if (tx_state() != TX_COMPLETE)
     {
@@ -92,7 +98,5 @@ void handle_tx_dump(
     // copy the data buffer into the working set
     os_memmove(WORKING_SET, dataBuffer, dataLength);
 
-    ux_flow_init(0, ux_tx_dump_flow, NULL);
-
-    *flags |= IO_ASYNCH_REPLY;
+    session_dispatch(SESSION_SCOPE_TX, ux_tx_dump_flow, do_tx_dump, flags);
 }
\ No newline at end of file
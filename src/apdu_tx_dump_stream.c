@@ -0,0 +1,139 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "apdu_tx_dump_stream.h"
+
+#include <transaction.h>
+#include <utils.h>
+
+#define APDU_TXDS_RESPONSE WORKING_SET
+#define APDU_TXDS_HASH APDU_TXDS_RESPONSE + TX_MAX_DUMP_SIZE
+
+// the position in the stream of the next byte to send for each slot
+static uint16_t stream_cursor[TX_SLOT_COUNT];
+
+// set when the transaction hash follows the transaction in the stream of a slot
+static uint8_t stream_hash[TX_SLOT_COUNT];
+
+// set once the stream of a slot was started, for the generation of the transaction in stream_generation
+static uint8_t stream_started[TX_SLOT_COUNT];
+
+static uint16_t stream_generation[TX_SLOT_COUNT];
+
+static void do_tx_dump_stream()
+{
+    BEGIN_TRY
+    {
+        TRY
+        {
+            const uint16_t size = tx_size();
+
+            const uint16_t cursor = stream_cursor[tx_slot()];
+
+            const uint16_t total = size + (stream_hash[tx_slot()] == 1 ? KEY_SIZE : 0);
+
+            if (cursor > total)
+            {
+                THROW(ERR_OUT_OF_RANGE);
+            }
+
+            uint16_t length = total - cursor;
+
+            if (length > TX_MAX_DUMP_SIZE)
+            {
+                length = TX_MAX_DUMP_SIZE;
+            }
+
+            if (cursor < size)
+            {
+                const uint16_t status =
+                    tx_dump(APDU_TXDS_RESPONSE, cursor, (cursor + length > size) ? size - cursor : length);
+
+                if (status != OP_OK)
+                {
+                    THROW(status);
+                }
+            }
+
+            // the hash may be split over two responses, each takes its own part
+            if (cursor + length > size)
+            {
+                const uint16_t start = (cursor > size) ? cursor : size;
+
+                const uint16_t status = tx_hash(APDU_TXDS_HASH);
+
+                if (status != OP_OK)
+                {
+                    THROW(status);
+                }
+
+                os_memmove(
+                    APDU_TXDS_RESPONSE + (start - cursor), APDU_TXDS_HASH + (start - size), cursor + length - start);
+            }
+
+            stream_cursor[tx_slot()] += length;
+
+            CLOSE_TRY;
+
+            // the host pulls the chunks back to back, redrawing the display for each would only slow it down
+            sendResponseQuiet(write_io_hybrid(APDU_TXDS_RESPONSE, length, APDU_TX_DUMP_STREAM_NAME, true));
+        }
+        CATCH_OTHER(e)
+        {
+            sendError(e);
+        }
+        FINALLY
+        {
+            // Explicitly clear the working memory
+            explicit_bzero(WORKING_SET, WORKING_SET_SIZE);
+        }
+    }
+    END_TRY;
+}
+
+void handle_tx_dump_stream(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volatile unsigned int *tx)
+{
+    const uint16_t slot_status = tx_select(p2 & P2_TX_SLOT_MASK);
+
+    if (slot_status != OP_OK)
+    {
+        return sendError(slot_status);
+    }
+
+    if (tx_state() != TX_COMPLETE)
+    {
+        return sendError(ERR_TRANSACTION_STATE);
+    }
+
+    if ((p1 & P1_TX_DUMP_STREAM_START) != 0)
+    {
+        stream_cursor[tx_slot()] = 0;
+
+        stream_hash[tx_slot()] = ((p1 & P1_TX_DUMP_STREAM_HASH) != 0) ? 1 : 0;
+
+        stream_started[tx_slot()] = 1;
+
+        stream_generation[tx_slot()] = tx_generation();
+    }
+    else if (stream_started[tx_slot()] == 0 || stream_generation[tx_slot()] != tx_generation())
+    {
+        // the slot was reset (or the stream never started), the cursor would point into another transaction
+        return sendError(ERR_TRANSACTION_STATE);
+    }
+
+    // a completed transaction is public, so the chunks are sent without any display
+    do_tx_dump_stream();
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#ifndef APDU_TX_DUMP_STREAM_H
+#define APDU_TX_DUMP_STREAM_H
+
+#include <stdint.h>
+
+#define APDU_TX_DUMP_STREAM_NAME ((unsigned char *)"TX_DUMP_STREAM")
+
+#define P1_TX_DUMP_STREAM_START 0x01 // rewinds the stream to the first byte of the transaction
+#define P1_TX_DUMP_STREAM_HASH 0x02 // with P1_TX_DUMP_STREAM_START, the transaction hash follows its last byte
+
+void handle_tx_dump_stream(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volatile unsigned int *tx);
+
+#endif // APDU_TX_DUMP_STREAM_H
\ No newline at end of file
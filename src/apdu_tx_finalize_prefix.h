@@ -17,6 +17,8 @@
 #ifndef APDU_TX_FINALIZE_PREFIX_H
 #define APDU_TX_FINALIZE_PREFIX_H
 
-void handle_tx_finalize_prefix(volatile unsigned int *flags);
+#include <stdint.h>
+
+void handle_tx_finalize_prefix(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volatile unsigned int *tx);
 
 #endif // APDU_TX_FINALIZE_PREFIX_H
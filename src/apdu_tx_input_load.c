@@ -16,6 +16,7 @@
 
 #include "apdu_tx_input_load.h"
 
+#include <session.h>
 #include <transaction.h>
 #include <utils.h>
 
@@ -91,7 +92,12 @@ void handle_tx_input_load(
     volatile unsigned int *flags,
     volatile unsigned int *tx)
 {
-    UNUSED(p2);
+    const uint16_t slot_status = tx_select(p2 & P2_TX_SLOT_MASK);
+
+    if (slot_status != OP_OK)
+    {
+        return sendError(slot_status);
+    }
 
     if (tx_state() != TX_RECEIVING_INPUTS)
     {
@@ -105,7 +111,5 @@ void handle_tx_input_load(
     // copy the data buffer into the working set
     os_memmove(WORKING_SET, dataBuffer, dataLength);
 
-    ux_flow_init(0, ux_tx_input_load_flow, NULL);
-
-    *flags |= IO_ASYNCH_REPLY;
+    session_dispatch(SESSION_SCOPE_TX, ux_tx_input_load_flow, do_tx_input_load, flags);
 }
\ No newline at end of file
@@ -16,6 +16,7 @@
 
 #include "apdu_tx_output_load.h"
 
+#include <session.h>
 #include <transaction.h>
 #include <utils.h>
 
@@ -64,7 +65,12 @@ void handle_tx_output_load(
     volatile unsigned int *flags,
     volatile unsigned int *tx)
 {
-    UNUSED(p2);
+    const uint16_t slot_status = tx_select(p2 & P2_TX_SLOT_MASK);
+
+    if (slot_status != OP_OK)
+    {
+        return sendError(slot_status);
+    }
 
     if (tx_state() != TX_RECEIVING_OUTPUTS)
     {
@@ -78,7 +84,5 @@ void handle_tx_output_load(
     // copy the data buffer into the working set
     os_memmove(WORKING_SET, dataBuffer, dataLength);
 
-    ux_flow_init(0, ux_tx_output_load_flow, NULL);
-
-    *flags |= IO_ASYNCH_REPLY;
+    session_dispatch(SESSION_SCOPE_TX, ux_tx_output_load_flow, do_tx_output_load, flags);
 }
\ No newline at end of file
@@ -16,6 +16,7 @@
 
 #include "apdu_tx_reset.h"
 
+#include <session.h>
 #include <transaction.h>
 #include <utils.h>
 
@@ -51,7 +52,12 @@ UX_FLOW(ux_tx_reset_flow, &ux_tx_reset_1_step);
 
 void handle_tx_reset(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volatile unsigned int *tx)
 {
-    UNUSED(p2);
+    const uint16_t slot_status = tx_select(p2 & P2_TX_SLOT_MASK);
+
+    if (slot_status != OP_OK)
+    {
+        return sendError(slot_status);
+    }
 
     // if we are not currently in a transaction construction state then we can return quickly
     if (tx_state() == TX_UNUSED)
@@ -59,7 +65,5 @@ void handle_tx_reset(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volat
         return sendResponse(0, true);
     }
 
-    ux_flow_init(0, ux_tx_reset_flow, NULL);
-
-    *flags |= IO_ASYNCH_REPLY;
+    session_dispatch(SESSION_SCOPE_TX, ux_tx_reset_flow, do_tx_reset, flags);
 }
\ No newline at end of file
@@ -21,26 +21,77 @@
 
 #define APDU_TSIGN_HASH WORKING_SET
 #define APDU_TSIGN_END_OFFSET APDU_TSIGN_HASH + KEY_SIZE
-#define APDU_TSIGN_AMOUNT APDU_TSIGN_END_OFFSET + sizeof(uint16_t)
-#define APDU_TSIGN_FEE APDU_TSIGN_AMOUNT + KEY_SIZE // give the amount plenty of room to breath
 
 #define APDU_TSIGN_RESPONSE APDU_TSIGN_HASH
 #define APDU_TSIGN_RESPONSE_SIZE KEY_SIZE + sizeof(uint16_t)
 
-static void do_tx_sign()
+#define TX_SIGN_PROGRESS_SIZE 12
+#define TX_SIGN_NO_SLOT 0xFF
+
+// the slot whose confirmation flow is displayed (if any)
+static uint8_t approval_slot = TX_SIGN_NO_SLOT;
+
+// the slot the ticker is driving tx_sign_step() for (if any)
+static uint8_t signing_slot = TX_SIGN_NO_SLOT;
+
+// set when the host is waiting on the reply to APDU_TX_SIGN until signing completes
+static uint8_t reply_pending = 0;
+
+// set when signing ahead of the approval failed, the approved signing retries and reports it
+static uint8_t presign_failed = 0;
+
+// the outcome of the last approval or signing attempt in each slot
+static uint8_t sign_status[TX_SLOT_COUNT];
+
+static char sign_progress[TX_SIGN_PROGRESS_SIZE];
+
+// the amounts are kept out of the working set as other APDUs may arrive while awaiting approval
+static char sign_amount[KEY_SIZE];
+
+static char sign_fee[KEY_SIZE]; // give the amount plenty of room to breath
+
+UX_STEP_NOCB(ux_tx_signing_1_step, pnn, {&C_icon_turtlecoin, "Signing Tx", sign_progress});
+
+UX_FLOW(ux_tx_signing_flow, &ux_tx_signing_1_step);
+
+/**
+ * Returns the state of the transaction in the given slot without
+ * disturbing the slot selected by the APDU being handled
+ */
+static unsigned int slot_state(const uint8_t slot)
+{
+    const uint8_t previous = tx_slot();
+
+    tx_select(slot);
+
+    const unsigned int state = tx_state();
+
+    tx_select(previous);
+
+    return state;
+}
+
+static void clear_tx_sign_amounts()
+{
+    explicit_bzero(sign_amount, sizeof(sign_amount));
+
+    explicit_bzero(sign_fee, sizeof(sign_fee));
+}
+
+static void display_tx_sign_progress()
+{
+    SPRINTF(sign_progress, "%u of %u", tx_signed_input_count(), tx_input_count());
+
+    ux_flow_init(0, ux_tx_signing_flow, NULL);
+}
+
+static void send_tx_sign_result()
 {
     BEGIN_TRY
     {
         TRY
         {
-            uint16_t status = tx_sign();
-
-            if (status != OP_OK)
-            {
-                THROW(status);
-            }
-
-            status = tx_hash(APDU_TSIGN_HASH);
+            const uint16_t status = tx_hash(APDU_TSIGN_HASH);
 
             if (status != OP_OK)
             {
@@ -57,24 +108,275 @@ static void do_tx_sign()
         {
             sendError(e);
         }
-        FINALLY {}
+        FINALLY
+        {
+            // Explicitly clear the working memory
+            explicit_bzero(WORKING_SET, WORKING_SET_SIZE);
+        }
     }
     END_TRY;
 }
 
+/**
+ * Begins (or resumes) signing the transaction in the given slot and
+ * hands it over to the ticker
+ * @param slot
+ * @return
+ */
+static uint16_t start_tx_sign(const uint8_t slot)
+{
+    const uint8_t previous = tx_slot();
+
+    uint16_t status = OP_OK;
+
+    tx_select(slot);
+
+    // any inputs signed while the approval was displayed are kept
+    if (tx_state() == TX_PREFIX_READY || tx_state() == TX_PRESIGNING)
+    {
+        status = tx_sign_begin();
+    }
+
+    if (status == OP_OK)
+    {
+        signing_slot = slot;
+
+        sign_status[slot] = TX_SIGN_STATUS_SIGNING;
+
+        display_tx_sign_progress();
+    }
+    else
+    {
+        sign_status[slot] = TX_SIGN_STATUS_FAILED;
+    }
+
+    tx_select(previous);
+
+    return status;
+}
+
+static void do_tx_sign()
+{
+    const uint8_t slot = approval_slot;
+
+    approval_slot = TX_SIGN_NO_SLOT;
+
+    clear_tx_sign_amounts();
+
+    const uint16_t status = start_tx_sign(slot);
+
+    if (status != OP_OK)
+    {
+        if (reply_pending == 1)
+        {
+            reply_pending = 0;
+
+            return sendError(status);
+        }
+
+        return ui_idle();
+    }
+}
+
+static void do_tx_sign_deny()
+{
+    const uint8_t previous = tx_slot();
+
+    tx_select(approval_slot);
+
+    // nothing signed ahead of the approval may outlive the rejection
+    if (tx_state() == TX_PRESIGNING && tx_presign_abort() != OP_OK)
+    {
+        // should the wipe fail, a reset of the slot is the only way forward
+        tx_reset();
+    }
+
+    tx_select(previous);
+
+    sign_status[approval_slot] = TX_SIGN_STATUS_REJECTED;
+
+    approval_slot = TX_SIGN_NO_SLOT;
+
+    clear_tx_sign_amounts();
+
+    // in the background mode the host already has its reply and polls APDU_TX_STATE for the outcome
+    if (reply_pending == 0)
+    {
+        return ui_idle();
+    }
+
+    reply_pending = 0;
+
+    do_deny();
+}
+
+/**
+ * Returns whether the transaction awaiting approval has inputs left to sign
+ * ahead of the approval
+ */
+static bool presign_pending()
+{
+    // without the rings there is nothing to sign ahead of the approval
+    if (approval_slot == TX_SIGN_NO_SLOT || presign_failed == 1 || TX_COMPACT_PRESIG == 1)
+    {
+        return false;
+    }
+
+    const uint8_t previous = tx_slot();
+
+    tx_select(approval_slot);
+
+    const bool pending = tx_state() == TX_PREFIX_READY
+                         || (tx_state() == TX_PRESIGNING && tx_signed_input_count() < tx_input_count());
+
+    tx_select(previous);
+
+    return pending;
+}
+
+/**
+ * Signs one input of the transaction awaiting approval while the user reads
+ * the confirmation screens, so that most (often all) of the work is done by
+ * the time they approve. The signatures stay in the TX_PRESIGNING state, which
+ * cannot be dumped, until the approval and are wiped if it is rejected
+ */
+static void presign_step()
+{
+    if (!presign_pending())
+    {
+        return;
+    }
+
+    const uint8_t previous = tx_slot();
+
+    tx_select(approval_slot);
+
+    const uint16_t status = (tx_state() == TX_PREFIX_READY) ? tx_presign_begin() : tx_sign_step();
+
+    if (status != OP_OK)
+    {
+        presign_failed = 1;
+    }
+
+    tx_select(previous);
+}
+
+static bool signer_display();
+
+/**
+ * Called on every ticker event, signs (at most) one input per tick so that
+ * the device keeps servicing i/o and the display between inputs. Other
+ * APDUs may have selected a different slot in the meantime so the signing
+ * slot is selected for the step and the previous selection restored after
+ *
+ * A step neither touches the APDU buffer nor the working set, so an APDU
+ * that is only partially received (or waiting on its splash screen) when
+ * the step runs is left intact
+ */
+void tx_sign_ticker()
+{
+    // the transaction awaiting approval was reset (or otherwise moved on) underneath us
+    if (approval_slot != TX_SIGN_NO_SLOT && slot_state(approval_slot) != TX_PREFIX_READY
+        && slot_state(approval_slot) != TX_PRESIGNING && slot_state(approval_slot) != TX_SIGNING)
+    {
+        approval_slot = TX_SIGN_NO_SLOT;
+
+        clear_tx_sign_amounts();
+
+        if (signer_display())
+        {
+            ui_idle();
+        }
+    }
+
+    if (signing_slot == TX_SIGN_NO_SLOT)
+    {
+        return presign_step();
+    }
+
+    const uint8_t previous = tx_slot();
+
+    tx_select(signing_slot);
+
+    // the transaction was reset (or otherwise moved on) underneath us; if every input was presigned it is complete
+    if (tx_state() != TX_SIGNING && tx_state() != TX_COMPLETE)
+    {
+        signing_slot = TX_SIGN_NO_SLOT;
+
+        reply_pending = 0;
+
+        tx_select(previous);
+
+        if (signer_display())
+        {
+            ui_idle();
+        }
+
+        return;
+    }
+
+    // the host signs each input with APDU_TX_SIGN_RING when the rings are not kept, the ticker only follows along
+    const uint16_t status = (tx_state() == TX_SIGNING && TX_COMPACT_PRESIG == 0) ? tx_sign_step() : OP_OK;
+
+    if (status != OP_OK || tx_state() == TX_COMPLETE)
+    {
+        sign_status[signing_slot] = (status == OP_OK) ? TX_SIGN_STATUS_IDLE : TX_SIGN_STATUS_FAILED;
+
+        signing_slot = TX_SIGN_NO_SLOT;
+
+        if (reply_pending == 1)
+        {
+            reply_pending = 0;
+
+            if (status != OP_OK)
+            {
+                sendError(status);
+            }
+            else
+            {
+                send_tx_sign_result();
+            }
+        }
+        else
+        {
+            /**
+             * If this was a background sign and it failed, the transaction stays in
+             * the TX_SIGNING state and another APDU_TX_SIGN resumes from the input
+             * that failed
+             */
+            if (signer_display())
+            {
+                ui_idle();
+            }
+        }
+
+        tx_select(previous);
+
+        return;
+    }
+
+    // an APDU served in the meantime keeps its flow on screen, its ui_idle() brings the progress back
+    if (signer_display())
+    {
+        display_tx_sign_progress();
+    }
+
+    tx_select(previous);
+}
+
 UX_STEP_SPLASH(ux_tx_sign_1_step, pnn, do_tx_sign(), {&C_icon_turtlecoin, "Signing", "Transaction..."});
 
 UX_FLOW(ux_tx_sign_flow, &ux_tx_sign_1_step);
 
 UX_STEP_NOCB(ux_tx_sign_2_step, pnn, {&C_icon_turtlecoin, "Sign", "Transaction?"});
 
-UX_STEP_NOCB(ux_tx_sign_3_step, bnnn_paging, {.title = "Amount to Spend", .text = (char *)APDU_TSIGN_AMOUNT});
+UX_STEP_NOCB(ux_tx_sign_3_step, bnnn_paging, {.title = "Amount to Spend", .text = sign_amount});
 
-UX_STEP_NOCB(ux_tx_sign_4_step, bnnn_paging, {.title = "Network Fee", .text = (char *)APDU_TSIGN_FEE});
+UX_STEP_NOCB(ux_tx_sign_4_step, bnnn_paging, {.title = "Network Fee", .text = sign_fee});
 
-UX_STEP_VALID(ux_tx_sign_5_step, pb, ux_flow_init(0, ux_tx_sign_flow, NULL), {&C_icon_validate_14, "Approve"});
+UX_STEP_VALID(ux_tx_sign_5_step, pb, do_tx_sign(), {&C_icon_validate_14, "Approve"});
 
-UX_STEP_VALID(ux_tx_sign_6_step, pb, do_deny(), {&C_icon_crossmark, "Reject"});
+UX_STEP_VALID(ux_tx_sign_6_step, pb, do_tx_sign_deny(), {&C_icon_crossmark, "Reject"});
 
 UX_FLOW(
     ux_tx_sign_confirm_flow,
@@ -84,49 +386,218 @@ UX_FLOW(
     &ux_tx_sign_5_step,
     &ux_tx_sign_6_step);
 
+/**
+ * Returns whether the display shows the approval or the signing progress
+ * rather than the flow of an APDU served while the transaction is signed,
+ * which the ticker must leave alone until that APDU has its reply
+ */
+static bool signer_display()
+{
+    const ux_flow_step_t *current = ux_flow_get_current();
+
+    return current == &ux_tx_signing_1_step || current == &ux_tx_sign_1_step || current == &ux_tx_sign_2_step
+           || current == &ux_tx_sign_3_step || current == &ux_tx_sign_4_step || current == &ux_tx_sign_5_step
+           || current == &ux_tx_sign_6_step;
+}
+
+/**
+ * Redisplays the confirmation flow of the transaction awaiting approval,
+ * or the progress of the transaction being signed, after another APDU
+ * has replaced it on screen
+ */
+void tx_sign_display()
+{
+    if (signing_slot != TX_SIGN_NO_SLOT)
+    {
+        const uint8_t previous = tx_slot();
+
+        tx_select(signing_slot);
+
+        display_tx_sign_progress();
+
+        tx_select(previous);
+    }
+    else if (approval_slot != TX_SIGN_NO_SLOT)
+    {
+        ux_flow_init(0, ux_tx_sign_confirm_flow, NULL);
+    }
+}
+
+/**
+ * Returns the approval and signing status of the transaction in the given slot
+ * @param slot
+ * @return
+ */
+uint8_t tx_sign_status(const uint8_t slot)
+{
+    if (slot == approval_slot)
+    {
+        return TX_SIGN_STATUS_AWAITING_APPROVAL;
+    }
+    else if (slot == signing_slot)
+    {
+        return TX_SIGN_STATUS_SIGNING;
+    }
+
+    // a rejection or failure only applies to the transaction it happened to
+    if (slot_state(slot) != TX_PREFIX_READY && slot_state(slot) != TX_PRESIGNING && slot_state(slot) != TX_SIGNING)
+    {
+        return TX_SIGN_STATUS_IDLE;
+    }
+
+    return sign_status[slot];
+}
+
+/**
+ * Returns whether a transaction is awaiting approval or being signed,
+ * in which case its display takes precedence over the idle menu
+ */
+bool tx_sign_ui_pending()
+{
+    return approval_slot != TX_SIGN_NO_SLOT || signing_slot != TX_SIGN_NO_SLOT;
+}
+
+/**
+ * Returns whether a transaction is being signed on ticker events, either
+ * approved or ahead of its approval
+ */
+bool tx_sign_busy()
+{
+    return (signing_slot != TX_SIGN_NO_SLOT && TX_COMPACT_PRESIG == 0) || presign_pending();
+}
+
 void handle_tx_sign(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volatile unsigned int *tx)
 {
-    UNUSED(p2);
+    const uint16_t slot_status = tx_select(p2 & P2_TX_SLOT_MASK);
+
+    if (slot_status != OP_OK)
+    {
+        return sendError(slot_status);
+    }
+
+    // once signed, the result can be fetched again without any further approval
+    if (tx_state() == TX_COMPLETE)
+    {
+        return send_tx_sign_result();
+    }
+    else if (tx_state() != TX_PREFIX_READY && tx_state() != TX_PRESIGNING && tx_state() != TX_SIGNING)
+    {
+        return sendError(ERR_TRANSACTION_STATE);
+    }
 
-    if (tx_state() != TX_PREFIX_READY)
+    /**
+     * This transaction is already awaiting approval or being signed;
+     * a foreground request waits on the outcome of that instead
+     */
+    if (tx_slot() == approval_slot || tx_slot() == signing_slot)
+    {
+        if ((p2 & P2_TX_SIGN_BACKGROUND) != 0 || TX_COMPACT_PRESIG == 1)
+        {
+            return sendResponse(0, true);
+        }
+
+        reply_pending = 1;
+
+        *flags |= IO_ASYNCH_REPLY;
+
+        return;
+    }
+
+    // the display can only be given to one transaction at a time
+    if (tx_sign_ui_pending())
     {
         return sendError(ERR_TRANSACTION_STATE);
     }
 
+    // the host has to be free to send APDU_TX_SIGN_RING when the rings are not kept, so it never waits on the reply
+    reply_pending = ((p2 & P2_TX_SIGN_BACKGROUND) != 0 || TX_COMPACT_PRESIG == 1) ? 0 : 1;
+
+    /**
+     * Signing was already approved for the transaction in this slot
+     * and was interrupted; resume from the last completed input
+     * without asking again
+     */
+    if (tx_state() == TX_SIGNING)
+    {
+        const uint16_t status = start_tx_sign(tx_slot());
+
+        if (status != OP_OK)
+        {
+            reply_pending = 0;
+
+            return sendError(status);
+        }
+
+        // in the background mode the host is told that signing started and polls APDU_TX_STATE for progress
+        if (reply_pending == 0)
+        {
+            return sendResponse(0, true);
+        }
+
+        *flags |= IO_ASYNCH_REPLY;
+
+        return;
+    }
+
+    sign_status[tx_slot()] = TX_SIGN_STATUS_IDLE;
+
+    presign_failed = 0;
+
     {
-        unsigned int offset = amountToString(APDU_TSIGN_AMOUNT, tx_input_amount(), KEY_SIZE);
+        unsigned int offset = amountToString((unsigned char *)sign_amount, tx_input_amount(), sizeof(sign_amount));
 
         // copy the ticker on to the end of the amount
-        os_memmove(APDU_TSIGN_AMOUNT + offset - 1, TICKER, TICKER_SIZE);
+        os_memmove(sign_amount + offset - 1, TICKER, TICKER_SIZE);
     }
 
     {
-        unsigned int offset = amountToString(APDU_TSIGN_FEE, tx_fee(), KEY_SIZE);
+        unsigned int offset = amountToString((unsigned char *)sign_fee, tx_fee(), sizeof(sign_fee));
 
         // copy the ticker on to the end of the amount
-        os_memmove(APDU_TSIGN_FEE + offset - 1, TICKER, TICKER_SIZE);
+        os_memmove(sign_fee + offset - 1, TICKER, TICKER_SIZE);
     }
 
     /**
      * If the APDU was sent requesting confirmation then
      * we need to start the UX flow and set the flags
      * to let the i/o handler know that the request is
-     * async and will be completed shortly
+     * async and will be completed shortly. In the background
+     * mode the host is told right away that the transaction
+     * awaits approval, and can load the next transaction into
+     * another slot while the user reviews this one
      */
     if (p1 == P1_CONFIRM)
     {
-        ux_flow_init(0, ux_tx_sign_confirm_flow, NULL);
+        approval_slot = tx_slot();
 
-        *flags |= IO_ASYNCH_REPLY;
+        ux_flow_init(0, ux_tx_sign_confirm_flow, NULL);
     }
     else if (p1 == P1_NON_CONFIRM && DEBUG_BUILD == 1)
     {
-        ux_flow_init(0, ux_tx_sign_flow, NULL);
+        approval_slot = tx_slot();
 
-        *flags |= IO_ASYNCH_REPLY;
+        if (reply_pending == 0)
+        {
+            do_tx_sign();
+
+            return sendResponse(0, true);
+        }
+
+        ux_flow_init(0, ux_tx_sign_flow, NULL);
     }
     else
     {
-        sendError(ERR_OP_USER_REQUIRED);
+        clear_tx_sign_amounts();
+
+        reply_pending = 0;
+
+        return sendError(ERR_OP_USER_REQUIRED);
     }
+
+    if (reply_pending == 0)
+    {
+        return sendResponse(0, true);
+    }
+
+    *flags |= IO_ASYNCH_REPLY;
 }
\ No newline at end of file
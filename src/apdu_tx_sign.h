@@ -17,10 +17,29 @@
 #ifndef APDU_TX_SIGN_H
 #define APDU_TX_SIGN_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #define APDU_TX_SIGN_NAME ((unsigned char *)"TX_SIGN")
 
+#define P2_TX_SIGN_BACKGROUND 0x80 // the low nibble of P2 is the transaction slot
+
+#define TX_SIGN_STATUS_IDLE 0x00
+#define TX_SIGN_STATUS_AWAITING_APPROVAL 0x01
+#define TX_SIGN_STATUS_SIGNING 0x02
+#define TX_SIGN_STATUS_REJECTED 0x03
+#define TX_SIGN_STATUS_FAILED 0x04
+
 void handle_tx_sign(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volatile unsigned int *tx);
 
+void tx_sign_display();
+
+uint8_t tx_sign_status(const uint8_t slot);
+
+void tx_sign_ticker();
+
+bool tx_sign_busy();
+
+bool tx_sign_ui_pending();
+
 #endif // APDU_TX_SIGN_H
@@ -0,0 +1,99 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "apdu_tx_sign_ring.h"
+
+#include <session.h>
+#include <transaction.h>
+#include <utils.h>
+
+#define APDU_TX_SIGN_RING_SIZE sizeof(uint8_t) + (KEY_SIZE * RING_PARTICIPANTS)
+
+#define APDU_TSR_INDEX_IDX WORKING_SET
+#define APDU_TSR_INDEX readUint8(APDU_TSR_INDEX_IDX)
+
+#define APDU_TSR_PUBLIC_KEYS APDU_TSR_INDEX_IDX + sizeof(uint8_t)
+
+static void do_tx_sign_ring()
+{
+    BEGIN_TRY
+    {
+        TRY
+        {
+            const uint16_t status = tx_sign_ring(APDU_TSR_INDEX, APDU_TSR_PUBLIC_KEYS);
+
+            if (status != OP_OK)
+            {
+                THROW(status);
+            }
+
+            const uint8_t signed_input_count = tx_signed_input_count();
+
+            CLOSE_TRY;
+
+            sendResponse(
+                write_io_hybrid((unsigned char *)&signed_input_count, sizeof(uint8_t), APDU_TX_SIGN_RING_NAME, true),
+                true);
+        }
+        CATCH_OTHER(e)
+        {
+            sendError(e);
+        }
+        FINALLY
+        {
+            // Explicitly clear the working memory
+            explicit_bzero(WORKING_SET, WORKING_SET_SIZE);
+        }
+    }
+    END_TRY;
+}
+
+UX_STEP_SPLASH(ux_tx_sign_ring_1_step, pnn, do_tx_sign_ring(), {&C_icon_turtlecoin, "Signing Tx", "Input..."});
+
+UX_FLOW(ux_tx_sign_ring_flow, &ux_tx_sign_ring_1_step);
+
+void handle_tx_sign_ring(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *dataBuffer,
+    uint16_t dataLength,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx)
+{
+    UNUSED(p1);
+
+    const uint16_t slot_status = tx_select(p2 & P2_TX_SLOT_MASK);
+
+    if (slot_status != OP_OK)
+    {
+        return sendError(slot_status);
+    }
+
+    // the transaction must have been approved, the ring alone never starts signing
+    if (tx_state() != TX_SIGNING && tx_state() != TX_COMPLETE)
+    {
+        return sendError(ERR_TRANSACTION_STATE);
+    }
+    else if (dataLength != APDU_TX_SIGN_RING_SIZE)
+    {
+        return sendError(ERR_WRONG_INPUT_LENGTH);
+    }
+
+    // copy the data buffer into the working set
+    os_memmove(WORKING_SET, dataBuffer, dataLength);
+
+    session_dispatch(SESSION_SCOPE_TX, ux_tx_sign_ring_flow, do_tx_sign_ring, flags);
+}
\ No newline at end of file
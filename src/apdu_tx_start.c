@@ -16,6 +16,7 @@
 
 #include "apdu_tx_start.h"
 
+#include <session.h>
 #include <transaction.h>
 #include <utils.h>
 
@@ -82,7 +83,12 @@ void handle_tx_start(
     volatile unsigned int *flags,
     volatile unsigned int *tx)
 {
-    UNUSED(p2);
+    const uint16_t slot_status = tx_select(p2 & P2_TX_SLOT_MASK);
+
+    if (slot_status != OP_OK)
+    {
+        return sendError(slot_status);
+    }
 
     if (tx_state() != TX_UNUSED)
     {
@@ -96,7 +102,5 @@ void handle_tx_start(
     // copy the data buffer into the working set
     os_memmove(WORKING_SET, dataBuffer, dataLength);
 
-    ux_flow_init(0, ux_tx_start_flow, NULL);
-
-    *flags |= IO_ASYNCH_REPLY;
+    session_dispatch(SESSION_SCOPE_TX, ux_tx_start_flow, do_tx_start, flags);
 }
\ No newline at end of file
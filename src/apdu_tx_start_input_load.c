@@ -16,6 +16,7 @@
 
 #include "apdu_tx_start_input_load.h"
 
+#include <session.h>
 #include <transaction.h>
 #include <utils.h>
 
@@ -53,14 +54,21 @@ UX_STEP_SPLASH(
 
 UX_FLOW(ux_tx_start_input_load_flow, &ux_tx_start_input_load_1_step);
 
-void handle_tx_start_input_load(volatile unsigned int *flags)
+void handle_tx_start_input_load(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volatile unsigned int *tx)
 {
+    UNUSED(p1);
+
+    const uint16_t slot_status = tx_select(p2 & P2_TX_SLOT_MASK);
+
+    if (slot_status != OP_OK)
+    {
+        return sendError(slot_status);
+    }
+
     if (tx_state() != TX_READY)
     {
         return sendError(ERR_TRANSACTION_STATE);
     }
 
-    ux_flow_init(0, ux_tx_start_input_load_flow, NULL);
-
-    *flags |= IO_ASYNCH_REPLY;
+    session_dispatch(SESSION_SCOPE_TX, ux_tx_start_input_load_flow, do_tx_start_input_load, flags);
 }
\ No newline at end of file
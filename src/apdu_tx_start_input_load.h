@@ -17,6 +17,8 @@
 #ifndef APDU_TX_START_INPUT_LOAD_H
 #define APDU_TX_START_INPUT_LOAD_H
 
-void handle_tx_start_input_load(volatile unsigned int *flags);
+#include <stdint.h>
+
+void handle_tx_start_input_load(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volatile unsigned int *tx);
 
 #endif // APDU_TX_START_INPUT_LOAD_H
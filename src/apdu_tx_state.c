@@ -16,16 +16,38 @@
 
 #include "apdu_tx_state.h"
 
+#include <apdu_tx_sign.h>
 #include <transaction.h>
 #include <utils.h>
 
-void handle_tx_state()
+void handle_tx_state(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volatile unsigned int *tx)
 {
-    unsigned char state = tx_state();
+    const uint16_t slot_status = tx_select(p2 & P2_TX_SLOT_MASK);
+
+    if (slot_status != OP_OK)
+    {
+        return sendError(slot_status);
+    }
+
+    // signing ahead of the approval is invisible to the host, the transaction still awaits approval
+    const bool presigning = tx_state() == TX_PRESIGNING;
+
+    unsigned char state[7] = {presigning ? TX_PREFIX_READY : tx_state(),
+                              presigning ? 0 : tx_signed_input_count(),
+                              tx_input_count(),
+                              tx_received_input_count(),
+                              tx_received_output_count(),
+                              tx_output_count(),
+                              tx_sign_status(tx_slot())};
 
     /**
      * This is static non-privileged information and as thus
      * can be returned without any additional checking
      */
-    sendResponse(write_io_hybrid(&state, 1, APDU_TX_STATE_NAME, true), true);
+    if (p1 == P1_TX_STATE_PROGRESS)
+    {
+        return sendResponse(write_io_hybrid(state, sizeof(state), APDU_TX_STATE_NAME, true), true);
+    }
+
+    sendResponse(write_io_hybrid(state, 1, APDU_TX_STATE_NAME, true), true);
 }
\ No newline at end of file
@@ -17,8 +17,12 @@
 #ifndef APDU_TX_STATE_H
 #define APDU_TX_STATE_H
 
+#include <stdint.h>
+
 #define APDU_TX_STATE_NAME ((unsigned char *)"TX_STATE")
 
-void handle_tx_state();
+#define P1_TX_STATE_PROGRESS 0x01
+
+void handle_tx_state(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volatile unsigned int *tx);
 
 #endif // APDU_TX_STATE_H
@@ -0,0 +1,99 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+
+#include "apdu_tx_stream_hint.h"
+
+#include <session.h>
+#include <transaction.h>
+#include <utils.h>
+
+#define APDU_TX_STREAM_HINT_SIZE KEY_SIZE + sizeof(uint8_t) + (KEY_SIZE * RING_PARTICIPANTS) + sizeof(uint8_t)
+
+#define APDU_TSH_TX_PUBLIC_KEY WORKING_SET
+
+#define APDU_TSH_OUTPUT_INDEX_IDX APDU_TSH_TX_PUBLIC_KEY + KEY_SIZE
+#define APDU_TSH_OUTPUT_INDEX readUint8(APDU_TSH_OUTPUT_INDEX_IDX)
+
+#define APDU_TSH_PUBLIC_KEYS APDU_TSH_OUTPUT_INDEX_IDX + sizeof(uint8_t)
+
+#define APDU_TSH_REAL_OUTPUT_INDEX_IDX APDU_TSH_PUBLIC_KEYS + (KEY_SIZE * RING_PARTICIPANTS)
+#define APDU_TSH_REAL_OUTPUT_INDEX readUint8(APDU_TSH_REAL_OUTPUT_INDEX_IDX)
+
+static void do_tx_stream_hint()
+{
+    BEGIN_TRY
+    {
+        TRY
+        {
+            const uint16_t status = tx_stream_hint(
+                APDU_TSH_TX_PUBLIC_KEY, APDU_TSH_OUTPUT_INDEX, APDU_TSH_PUBLIC_KEYS, APDU_TSH_REAL_OUTPUT_INDEX);
+
+            if (status != OP_OK)
+            {
+                THROW(status);
+            }
+
+            CLOSE_TRY;
+
+            sendResponse(0, true);
+        }
+        CATCH_OTHER(e)
+        {
+            sendError(e);
+        }
+        FINALLY
+        {
+            // Explicitly clear the working memory
+            explicit_bzero(WORKING_SET, WORKING_SET_SIZE);
+        }
+    }
+    END_TRY;
+}
+
+UX_STEP_SPLASH(ux_tx_stream_hint_1_step, pnn, do_tx_stream_hint(), {&C_icon_turtlecoin, "Loading Tx", "Input..."});
+
+UX_FLOW(ux_tx_stream_hint_flow, &ux_tx_stream_hint_1_step);
+
+void handle_tx_stream_hint(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *dataBuffer,
+    uint16_t dataLength,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx)
+{
+    const uint16_t slot_status = tx_select(p2 & P2_TX_SLOT_MASK);
+
+    if (slot_status != OP_OK)
+    {
+        return sendError(slot_status);
+    }
+
+    if (tx_state() != TX_STREAMING)
+    {
+        return sendError(ERR_TRANSACTION_STATE);
+    }
+    else if (dataLength != APDU_TX_STREAM_HINT_SIZE)
+    {
+        return sendError(ERR_WRONG_INPUT_LENGTH);
+    }
+
+    // copy the data buffer into the working set
+    os_memmove(WORKING_SET, dataBuffer, dataLength);
+
+    session_dispatch(SESSION_SCOPE_TX, ux_tx_stream_hint_flow, do_tx_stream_hint, flags);
+}
\ No newline at end of file
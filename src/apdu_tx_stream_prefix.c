@@ -0,0 +1,95 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+
+#include "apdu_tx_stream_prefix.h"
+
+#include <session.h>
+#include <transaction.h>
+#include <utils.h>
+
+#define APDU_TX_STREAM_PREFIX_MAX_SIZE WORKING_SET_SIZE - sizeof(uint16_t)
+
+#define APDU_TSP_LENGTH_IDX WORKING_SET
+#define APDU_TSP_LENGTH readUint16BE(APDU_TSP_LENGTH_IDX)
+
+#define APDU_TSP_DATA APDU_TSP_LENGTH_IDX + sizeof(uint16_t)
+
+static void do_tx_stream_prefix()
+{
+    BEGIN_TRY
+    {
+        TRY
+        {
+            const uint16_t status = tx_stream_prefix(APDU_TSP_DATA, APDU_TSP_LENGTH);
+
+            if (status != OP_OK)
+            {
+                THROW(status);
+            }
+
+            CLOSE_TRY;
+
+            sendResponse(0, true);
+        }
+        CATCH_OTHER(e)
+        {
+            sendError(e);
+        }
+        FINALLY
+        {
+            // Explicitly clear the working memory
+            explicit_bzero(WORKING_SET, WORKING_SET_SIZE);
+        }
+    }
+    END_TRY;
+}
+
+UX_STEP_SPLASH(ux_tx_stream_prefix_1_step, pnn, do_tx_stream_prefix(), {&C_icon_turtlecoin, "Loading Tx", "Prefix..."});
+
+UX_FLOW(ux_tx_stream_prefix_flow, &ux_tx_stream_prefix_1_step);
+
+void handle_tx_stream_prefix(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *dataBuffer,
+    uint16_t dataLength,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx)
+{
+    const uint16_t slot_status = tx_select(p2 & P2_TX_SLOT_MASK);
+
+    if (slot_status != OP_OK)
+    {
+        return sendError(slot_status);
+    }
+
+    if (tx_state() != TX_STREAMING)
+    {
+        return sendError(ERR_TRANSACTION_STATE);
+    }
+    else if (dataLength == 0 || dataLength > APDU_TX_STREAM_PREFIX_MAX_SIZE)
+    {
+        return sendError(ERR_WRONG_INPUT_LENGTH);
+    }
+
+    // copy the length and the data buffer into the working set
+    uint16ToChar(APDU_TSP_LENGTH_IDX, dataLength);
+
+    os_memmove(APDU_TSP_DATA, dataBuffer, dataLength);
+
+    session_dispatch(SESSION_SCOPE_TX, ux_tx_stream_prefix_flow, do_tx_stream_prefix, flags);
+}
\ No newline at end of file
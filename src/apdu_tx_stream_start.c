@@ -0,0 +1,75 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+
+#include "apdu_tx_stream_start.h"
+
+#include <session.h>
+#include <transaction.h>
+#include <utils.h>
+
+static void do_tx_stream_start()
+{
+    BEGIN_TRY
+    {
+        TRY
+        {
+            const uint16_t status = tx_stream_start();
+
+            if (status != OP_OK)
+            {
+                THROW(status);
+            }
+
+            CLOSE_TRY;
+
+            sendResponse(0, true);
+        }
+        CATCH_OTHER(e)
+        {
+            sendError(e);
+        }
+        FINALLY {}
+    }
+    END_TRY;
+}
+
+UX_STEP_SPLASH(
+    ux_tx_stream_start_1_step,
+    pnn,
+    do_tx_stream_start(),
+    {&C_icon_turtlecoin, "Starting", "Transaction..."});
+
+UX_FLOW(ux_tx_stream_start_flow, &ux_tx_stream_start_1_step);
+
+void handle_tx_stream_start(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volatile unsigned int *tx)
+{
+    UNUSED(p1);
+
+    const uint16_t slot_status = tx_select(p2 & P2_TX_SLOT_MASK);
+
+    if (slot_status != OP_OK)
+    {
+        return sendError(slot_status);
+    }
+
+    if (tx_state() != TX_UNUSED)
+    {
+        return sendError(ERR_TRANSACTION_STATE);
+    }
+
+    session_dispatch(SESSION_SCOPE_TX, ux_tx_stream_start_flow, do_tx_stream_start, flags);
+}
\ No newline at end of file
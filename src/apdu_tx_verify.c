@@ -0,0 +1,79 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "apdu_tx_verify.h"
+
+#include <session.h>
+#include <transaction.h>
+#include <utils.h>
+
+#define APDU_TXV_RESULTS WORKING_SET
+#define APDU_TXV_RESULTS_SIZE ((TX_MAX_INPUTS + 7) / 8)
+#define APDU_TXV_HP_CACHE ((hp_cache_t *)(APDU_TXV_RESULTS + APDU_TXV_RESULTS_SIZE))
+
+static void do_tx_verify()
+{
+    BEGIN_TRY
+    {
+        TRY
+        {
+            const uint16_t status = tx_verify(APDU_TXV_RESULTS, APDU_TXV_HP_CACHE);
+
+            if (status != OP_OK)
+            {
+                THROW(status);
+            }
+
+            CLOSE_TRY;
+
+            sendResponse(
+                write_io_hybrid(APDU_TXV_RESULTS, (tx_input_count() + 7) / 8, APDU_TX_VERIFY_NAME, true), true);
+        }
+        CATCH_OTHER(e)
+        {
+            sendError(e);
+        }
+        FINALLY
+        {
+            // Explicitly clear the working memory
+            explicit_bzero(WORKING_SET, WORKING_SET_SIZE);
+        }
+    }
+    END_TRY;
+}
+
+UX_STEP_SPLASH(ux_tx_verify_1_step, pnn, do_tx_verify(), {&C_icon_turtlecoin, "Verifying", "Transaction..."});
+
+UX_FLOW(ux_tx_verify_flow, &ux_tx_verify_1_step);
+
+void handle_tx_verify(uint8_t p1, uint8_t p2, volatile unsigned int *flags, volatile unsigned int *tx)
+{
+    UNUSED(p1);
+
+    const uint16_t slot_status = tx_select(p2 & P2_TX_SLOT_MASK);
+
+    if (slot_status != OP_OK)
+    {
+        return sendError(slot_status);
+    }
+
+    if (tx_state() != TX_COMPLETE)
+    {
+        return sendError(ERR_TRANSACTION_STATE);
+    }
+
+    session_dispatch(SESSION_SCOPE_TX, ux_tx_verify_flow, do_tx_verify, flags);
+}
\ No newline at end of file
@@ -17,7 +17,6 @@
 #include "apdu_view_secret_key.h"
 
 #include <keys.h>
-#include <transaction.h>
 #include <utils.h>
 
 #define APDU_VSK WORKING_SET
@@ -62,11 +61,6 @@ void handle_view_secret_key(uint8_t p1, uint8_t p2, volatile unsigned int *flags
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
-    {
-        return sendError(ERR_TRANSACTION_STATE);
-    }
-
     toHexString(PTR_VIEW_PRIVATE, KEY_SIZE, APDU_VSK, KEY_HEXSTR_SIZE);
 
     /**
@@ -17,7 +17,6 @@
 #include "apdu_view_wallet_keys.h"
 
 #include <keys.h>
-#include <transaction.h>
 #include <utils.h>
 
 #define APDU_WK_KEYS WORKING_SET
@@ -73,11 +72,6 @@ void handle_view_wallet_keys(uint8_t p1, uint8_t p2, volatile unsigned int *flag
 {
     UNUSED(p2);
 
-    if (tx_state() != TX_UNUSED)
-    {
-        return sendError(ERR_TRANSACTION_STATE);
-    }
-
     toHexString(PTR_SPEND_PUBLIC, KEY_SIZE, APDU_WK_SPEND_PUBLIC, KEY_HEXSTR_SIZE);
 
     toHexString(PTR_VIEW_PRIVATE, KEY_SIZE, APDU_WK_VIEW_PRIVATE, KEY_HEXSTR_SIZE);
@@ -101,6 +101,8 @@ uint16_t base58_encode(const unsigned char *rawAddress, unsigned char *str_b58)
                     &str_b58[full_block_count * FULL_ENCODED_BLOCK_SIZE]);
             }
 
+            CLOSE_TRY;
+
             return OP_OK;
         }
         CATCH_OTHER(e)
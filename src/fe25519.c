@@ -0,0 +1,388 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "fe25519.h"
+
+#include <string.h>
+
+// limb i holds 26 bits when i is even and 25 bits when i is odd
+#define LIMB_BITS(i) (((i) & 1) ? 25 : 26)
+
+/**
+ * Carries the limbs back into range, rounding so that each limb ends up
+ * signed and no larger than half its radix (plus a little for limb 1)
+ * @param h the result
+ * @param t the uncarried limbs
+ */
+static void fe25519_carry(fe25519 h, int64_t *t)
+{
+    int64_t carry;
+
+    unsigned int i;
+
+    for (i = 0; i < 10; i++)
+    {
+        carry = (t[i] + ((int64_t)1 << (LIMB_BITS(i) - 1))) >> LIMB_BITS(i);
+
+        t[i] -= carry * ((int64_t)1 << LIMB_BITS(i));
+
+        // 2^255 = 19 mod p
+        if (i == 9)
+        {
+            t[0] += carry * 19;
+        }
+        else
+        {
+            t[i + 1] += carry;
+        }
+    }
+
+    carry = (t[0] + ((int64_t)1 << 25)) >> 26;
+
+    t[0] -= carry * ((int64_t)1 << 26);
+
+    t[1] += carry;
+
+    for (i = 0; i < 10; i++)
+    {
+        h[i] = (int32_t)t[i];
+    }
+}
+
+void fe25519_0(fe25519 h)
+{
+    memset(h, 0, sizeof(fe25519));
+}
+
+void fe25519_1(fe25519 h)
+{
+    fe25519_0(h);
+
+    h[0] = 1;
+}
+
+void fe25519_copy(fe25519 h, const fe25519 f)
+{
+    memmove(h, f, sizeof(fe25519));
+}
+
+void fe25519_frombytes(fe25519 h, const unsigned char *s)
+{
+    unsigned int bit = 0;
+
+    unsigned int i, j;
+
+    for (i = 0; i < 10; i++)
+    {
+        uint32_t value = 0;
+
+        // a limb starts at most 7 bits into a byte so 4 bytes always cover it
+        for (j = 0; j < 4 && (bit / 8) + j < 32; j++)
+        {
+            value |= (uint32_t)s[(bit / 8) + j] << (8 * j);
+        }
+
+        h[i] = (int32_t)((value >> (bit % 8)) & ((1u << LIMB_BITS(i)) - 1));
+
+        bit += LIMB_BITS(i);
+    }
+
+    // the limbs cover 255 bits, the top bit is worth 2^255 = 19 mod p
+    h[0] += 19 * (s[31] >> 7);
+}
+
+void fe25519_tobytes(unsigned char *s, const fe25519 h)
+{
+    int64_t t[10];
+
+    int64_t q;
+
+    uint64_t acc = 0;
+
+    unsigned int bits = 0, pos = 0;
+
+    unsigned int i;
+
+    for (i = 0; i < 10; i++)
+    {
+        t[i] = h[i];
+    }
+
+    /**
+     * With h carried, q = floor((h + 19) / 2^255) is 1 exactly when h >= p,
+     * so h - q * p is canonical: add 19 * q then drop bit 255
+     */
+    q = (19 * t[9] + ((int64_t)1 << 24)) >> 25;
+
+    for (i = 0; i < 10; i++)
+    {
+        q = (t[i] + q) >> LIMB_BITS(i);
+    }
+
+    t[0] += 19 * q;
+
+    for (i = 0; i < 9; i++)
+    {
+        const int64_t carry = t[i] >> LIMB_BITS(i);
+
+        t[i + 1] += carry;
+
+        t[i] -= carry * ((int64_t)1 << LIMB_BITS(i));
+    }
+
+    t[9] &= ((int64_t)1 << 25) - 1;
+
+    for (i = 0; i < 10; i++)
+    {
+        acc |= (uint64_t)t[i] << bits;
+
+        bits += LIMB_BITS(i);
+
+        while (bits >= 8)
+        {
+            s[pos++] = (unsigned char)acc;
+
+            acc >>= 8;
+
+            bits -= 8;
+        }
+    }
+
+    s[pos] = (unsigned char)acc;
+}
+
+void fe25519_add(fe25519 h, const fe25519 f, const fe25519 g)
+{
+    int64_t t[10];
+
+    unsigned int i;
+
+    for (i = 0; i < 10; i++)
+    {
+        t[i] = (int64_t)f[i] + g[i];
+    }
+
+    fe25519_carry(h, t);
+}
+
+void fe25519_sub(fe25519 h, const fe25519 f, const fe25519 g)
+{
+    int64_t t[10];
+
+    unsigned int i;
+
+    for (i = 0; i < 10; i++)
+    {
+        t[i] = (int64_t)f[i] - g[i];
+    }
+
+    fe25519_carry(h, t);
+}
+
+void fe25519_neg(fe25519 h, const fe25519 f)
+{
+    int64_t t[10];
+
+    unsigned int i;
+
+    for (i = 0; i < 10; i++)
+    {
+        t[i] = -(int64_t)f[i];
+    }
+
+    fe25519_carry(h, t);
+}
+
+void fe25519_mul(fe25519 h, const fe25519 f, const fe25519 g)
+{
+    int64_t t[10] = {0};
+
+    unsigned int i, j;
+
+    for (i = 0; i < 10; i++)
+    {
+        for (j = 0; j < 10; j++)
+        {
+            /**
+             * Two odd limbs sit half a bit further up than their product's
+             * position accounts for, and anything past limb 9 wraps around
+             * as 2^255 = 19
+             */
+            int64_t product = (int64_t)f[i] * g[j];
+
+            if (i & j & 1)
+            {
+                product *= 2;
+            }
+
+            if (i + j >= 10)
+            {
+                t[i + j - 10] += product * 19;
+            }
+            else
+            {
+                t[i + j] += product;
+            }
+        }
+    }
+
+    fe25519_carry(h, t);
+}
+
+void fe25519_sq(fe25519 h, const fe25519 f)
+{
+    fe25519_mul(h, f, f);
+}
+
+/**
+ * h = f^(2^n)
+ */
+static void fe25519_sqn(fe25519 h, const fe25519 f, unsigned int n)
+{
+    fe25519_sq(h, f);
+
+    while (--n)
+    {
+        fe25519_sq(h, h);
+    }
+}
+
+void fe25519_invert(fe25519 h, const fe25519 f)
+{
+    fe25519 t0, t1, t2, t3;
+
+    // the ref10 addition chain for 2^255 - 21
+    fe25519_sq(t0, f);
+
+    fe25519_sqn(t1, t0, 2);
+
+    fe25519_mul(t1, f, t1);
+
+    fe25519_mul(t0, t0, t1);
+
+    fe25519_sq(t2, t0);
+
+    fe25519_mul(t1, t1, t2); // 2^5 - 1
+
+    fe25519_sqn(t2, t1, 5);
+
+    fe25519_mul(t1, t2, t1); // 2^10 - 1
+
+    fe25519_sqn(t2, t1, 10);
+
+    fe25519_mul(t2, t2, t1); // 2^20 - 1
+
+    fe25519_sqn(t3, t2, 20);
+
+    fe25519_mul(t2, t3, t2); // 2^40 - 1
+
+    fe25519_sqn(t2, t2, 10);
+
+    fe25519_mul(t1, t2, t1); // 2^50 - 1
+
+    fe25519_sqn(t2, t1, 50);
+
+    fe25519_mul(t2, t2, t1); // 2^100 - 1
+
+    fe25519_sqn(t3, t2, 100);
+
+    fe25519_mul(t2, t3, t2); // 2^200 - 1
+
+    fe25519_sqn(t2, t2, 50);
+
+    fe25519_mul(t1, t2, t1); // 2^250 - 1
+
+    fe25519_sqn(t1, t1, 5);
+
+    fe25519_mul(h, t1, t0); // 2^255 - 21
+}
+
+void fe25519_pow22523(fe25519 h, const fe25519 f)
+{
+    fe25519 t0, t1, t2;
+
+    // the ref10 addition chain for 2^252 - 3
+    fe25519_sq(t0, f);
+
+    fe25519_sqn(t1, t0, 2);
+
+    fe25519_mul(t1, f, t1);
+
+    fe25519_mul(t0, t0, t1);
+
+    fe25519_sq(t0, t0);
+
+    fe25519_mul(t0, t1, t0); // 2^5 - 1
+
+    fe25519_sqn(t1, t0, 5);
+
+    fe25519_mul(t0, t1, t0); // 2^10 - 1
+
+    fe25519_sqn(t1, t0, 10);
+
+    fe25519_mul(t1, t1, t0); // 2^20 - 1
+
+    fe25519_sqn(t2, t1, 20);
+
+    fe25519_mul(t1, t2, t1); // 2^40 - 1
+
+    fe25519_sqn(t1, t1, 10);
+
+    fe25519_mul(t0, t1, t0); // 2^50 - 1
+
+    fe25519_sqn(t1, t0, 50);
+
+    fe25519_mul(t1, t1, t0); // 2^100 - 1
+
+    fe25519_sqn(t2, t1, 100);
+
+    fe25519_mul(t1, t2, t1); // 2^200 - 1
+
+    fe25519_sqn(t1, t1, 50);
+
+    fe25519_mul(t0, t1, t0); // 2^250 - 1
+
+    fe25519_sqn(t0, t0, 2);
+
+    fe25519_mul(h, t0, f); // 2^252 - 3
+}
+
+int fe25519_isnonzero(const fe25519 f)
+{
+    unsigned char s[32];
+
+    unsigned char r = 0;
+
+    unsigned int i;
+
+    fe25519_tobytes(s, f);
+
+    for (i = 0; i < sizeof(s); i++)
+    {
+        r |= s[i];
+    }
+
+    return r != 0;
+}
+
+int fe25519_isnegative(const fe25519 f)
+{
+    unsigned char s[32];
+
+    fe25519_tobytes(s, f);
+
+    return s[0] & 1;
+}
\ No newline at end of file
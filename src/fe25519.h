@@ -0,0 +1,71 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#ifndef FE25519_H
+#define FE25519_H
+
+#include <stdint.h>
+
+/**
+ * Portable arithmetic mod p = 2^255 - 19 in radix 2^25.5 (ten limbs of
+ * alternately 26 and 25 bits, as in ref10) for the software field backend.
+ * The limb products fit in 64 bits so this only needs 32x32 -> 64 bit
+ * multiplication, which the Cortex-M cores have. Every result is carried so
+ * any output may be fed to any input. Bytes are little endian
+ */
+typedef int32_t fe25519[10];
+
+void fe25519_0(fe25519 h);
+
+void fe25519_1(fe25519 h);
+
+void fe25519_copy(fe25519 h, const fe25519 f);
+
+/**
+ * Loads all 256 bits of s, reduced mod p
+ */
+void fe25519_frombytes(fe25519 h, const unsigned char *s);
+
+/**
+ * Stores the canonical (fully reduced) encoding of h
+ */
+void fe25519_tobytes(unsigned char *s, const fe25519 h);
+
+void fe25519_add(fe25519 h, const fe25519 f, const fe25519 g);
+
+void fe25519_sub(fe25519 h, const fe25519 f, const fe25519 g);
+
+void fe25519_neg(fe25519 h, const fe25519 f);
+
+void fe25519_mul(fe25519 h, const fe25519 f, const fe25519 g);
+
+void fe25519_sq(fe25519 h, const fe25519 f);
+
+/**
+ * h = f^(p - 2) = 1 / f
+ */
+void fe25519_invert(fe25519 h, const fe25519 f);
+
+/**
+ * h = f^((p - 5) / 8)
+ */
+void fe25519_pow22523(fe25519 h, const fe25519 f);
+
+int fe25519_isnonzero(const fe25519 f);
+
+int fe25519_isnegative(const fe25519 f);
+
+#endif // FE25519_H
\ No newline at end of file
@@ -20,6 +20,8 @@
 
 unsigned char G_working_set[WORKING_SET_SIZE] = {0};
 
+unsigned char G_tx_working_set[TX_WORKING_SET_SIZE] = {0};
+
 unsigned char G_display_key_hex[KEY_HEXSTR_SIZE] = {0};
 
 ux_state_t G_ux;
@@ -44,6 +44,16 @@ extern unsigned char G_working_set[WORKING_SET_SIZE];
 
 #define WORKING_SET ((unsigned char *)G_working_set)
 
+/**
+ * Scratch for the transaction signer, which runs from the ticker between APDUs
+ * and must leave the working set of whichever APDU is in flight alone
+ */
+#define TX_WORKING_SET_SIZE SIG_SET_SIZE
+
+extern unsigned char G_tx_working_set[TX_WORKING_SET_SIZE];
+
+#define TX_WORKING_SET ((unsigned char *)G_tx_working_set)
+
 extern unsigned char G_display_key_hex[KEY_HEXSTR_SIZE];
 
 #define DISPLAY_KEY_HEX ((unsigned char *)G_display_key_hex)
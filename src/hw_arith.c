@@ -0,0 +1,338 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "hw_arith.h"
+
+#include <profile.h>
+#include <sc25519.h>
+
+// q
+const unsigned char C_ED25519_ORDER[KEY_SIZE] = {0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                                 0x00, 0x00, 0x00, 0x00, 0x00, 0x14, 0xDE, 0xF9, 0xDE, 0xA2, 0xF7,
+                                                 0x9C, 0xD6, 0x58, 0x12, 0x63, 0x1A, 0x5C, 0xF5, 0xD3, 0xED};
+
+// p
+const unsigned char C_ED25519_FIELD[KEY_SIZE] = {0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                                 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                                 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xed};
+
+void reverse32(unsigned char *result, const unsigned char *source)
+{
+    unsigned char x;
+
+    unsigned int i;
+
+    for (i = 0; i < 16; i++)
+    {
+        x = source[i];
+
+        result[i] = source[31 - i];
+
+        result[31 - i] = x;
+    }
+}
+
+#if FIELD_BACKEND == CRYPTO_BACKEND_SOFTWARE
+
+void hw_fe_frombytes(hw_fe_t h, const unsigned char *s)
+{
+    fe25519_frombytes(h, s);
+}
+
+void hw_fe_frombytes_be(hw_fe_t h, const unsigned char *s)
+{
+    unsigned char _s[KEY_SIZE];
+
+    reverse32(_s, s);
+
+    fe25519_frombytes(h, _s);
+}
+
+void hw_fe_tobytes(unsigned char *s, const hw_fe_t h)
+{
+    fe25519_tobytes(s, h);
+}
+
+void hw_fe_1(hw_fe_t h)
+{
+    fe25519_1(h);
+}
+
+void hw_fe_add(hw_fe_t h, const hw_fe_t f, const hw_fe_t g)
+{
+    fe25519_add(h, f, g);
+}
+
+void hw_fe_sub(hw_fe_t h, const hw_fe_t f, const hw_fe_t g)
+{
+    fe25519_sub(h, f, g);
+}
+
+void hw_fe_neg(hw_fe_t h, const hw_fe_t f)
+{
+    fe25519_neg(h, f);
+}
+
+void hw_fe_mul(hw_fe_t h, const hw_fe_t f, const hw_fe_t g)
+{
+    fe25519_mul(h, f, g);
+}
+
+void hw_fe_invert(hw_fe_t h, const hw_fe_t f)
+{
+    fe25519_invert(h, f);
+}
+
+void hw_fe_pow22523(hw_fe_t h, const hw_fe_t f)
+{
+    fe25519_pow22523(h, f);
+}
+
+int hw_fe_isnonzero(const hw_fe_t f)
+{
+    return fe25519_isnonzero(f);
+}
+
+int hw_fe_isnegative(const hw_fe_t f)
+{
+    return fe25519_isnegative(f);
+}
+
+#else
+
+#define MOD (unsigned char *)C_ED25519_FIELD, KEY_SIZE
+
+// (p - 5) / 8
+static const unsigned char C_fe_qm5div8[32] = {0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                               0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                               0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfd};
+
+void hw_fe_frombytes(hw_fe_t h, const unsigned char *s)
+{
+    // ledger cx calls work in BE
+    reverse32(h, s);
+
+    cx_math_modm(h, KEY_SIZE, (unsigned char *)C_ED25519_FIELD, KEY_SIZE);
+}
+
+void hw_fe_frombytes_be(hw_fe_t h, const unsigned char *s)
+{
+    os_memmove(h, s, KEY_SIZE);
+}
+
+void hw_fe_tobytes(unsigned char *s, const hw_fe_t h)
+{
+    reverse32(s, h);
+}
+
+void hw_fe_1(hw_fe_t h)
+{
+    explicit_bzero(h, KEY_SIZE);
+
+    h[KEY_SIZE - 1] = 1;
+}
+
+void hw_fe_add(hw_fe_t h, const hw_fe_t f, const hw_fe_t g)
+{
+    cx_math_addm(h, f, g, MOD);
+}
+
+void hw_fe_sub(hw_fe_t h, const hw_fe_t f, const hw_fe_t g)
+{
+    cx_math_subm(h, f, g, MOD);
+}
+
+void hw_fe_neg(hw_fe_t h, const hw_fe_t f)
+{
+    cx_math_sub(h, (unsigned char *)C_ED25519_FIELD, f, KEY_SIZE);
+}
+
+void hw_fe_mul(hw_fe_t h, const hw_fe_t f, const hw_fe_t g)
+{
+    cx_math_multm(h, f, g, MOD);
+}
+
+void hw_fe_invert(hw_fe_t h, const hw_fe_t f)
+{
+    PROFILE_OP(PROFILE_OP_INVPRIMEM);
+
+    cx_math_invprimem(h, f, MOD);
+}
+
+void hw_fe_pow22523(hw_fe_t h, const hw_fe_t f)
+{
+    PROFILE_OP(PROFILE_OP_POWM);
+
+    cx_math_powm(h, f, (unsigned char *)C_fe_qm5div8, KEY_SIZE, MOD);
+}
+
+int hw_fe_isnonzero(const hw_fe_t f)
+{
+    return !cx_math_is_zero(f, KEY_SIZE);
+}
+
+int hw_fe_isnegative(const hw_fe_t f)
+{
+    return f[KEY_SIZE - 1] & 1;
+}
+
+#undef MOD
+
+#endif // FIELD_BACKEND
+
+#if SCALAR_BACKEND == CRYPTO_BACKEND_SOFTWARE
+
+void hw_sc_reduce32(unsigned char *r, const unsigned char *s)
+{
+    sc25519_reduce32(r, s);
+}
+
+void hw_sc_add(unsigned char *r, const unsigned char *a, const unsigned char *b)
+{
+    sc25519_add(r, a, b);
+}
+
+void hw_sc_sub(unsigned char *r, const unsigned char *a, const unsigned char *b)
+{
+    sc25519_sub(r, a, b);
+}
+
+void hw_sc_mul(unsigned char *r, const unsigned char *a, const unsigned char *b)
+{
+    sc25519_mul(r, a, b);
+}
+
+void hw_sc_mulsub(unsigned char *r, const unsigned char *a, const unsigned char *b, const unsigned char *c)
+{
+    sc25519_mulsub(r, a, b, c);
+}
+
+#else
+
+/**
+ * Creates a private key point within the correct curve order
+ * r = s mod q
+ * @param result the resulting scalar
+ * @param source the value to reduce
+ */
+void hw_sc_reduce32(unsigned char *r, const unsigned char *s)
+{
+    unsigned char _s[KEY_SIZE];
+
+    // Load the data for reduction
+    reverse32(_s, s);
+
+    // Put it on the curve in the proper order
+    cx_math_modm(_s, KEY_SIZE, (unsigned char *)C_ED25519_ORDER, KEY_SIZE);
+
+    // Unload the resulting scalar
+    reverse32(r, _s);
+}
+
+/**
+ * Performs scalar addition such that
+ * r = (a + b) mod q
+ * @param r the result
+ * @param a the first scalar
+ * @param b the second scalar
+ */
+void hw_sc_add(unsigned char *r, const unsigned char *a, const unsigned char *b)
+{
+    unsigned char _a[KEY_SIZE];
+
+    unsigned char _b[KEY_SIZE];
+
+    // Load scalar a
+    reverse32(_a, a);
+
+    // Load scalar b
+    reverse32(_b, b);
+
+    // Add the scalars together
+    cx_math_addm(r, _a, _b, (unsigned char *)C_ED25519_ORDER, KEY_SIZE);
+
+    // Unload the resulting scalar
+    reverse32(r, r);
+}
+
+/**
+ * Performs scalar subtraction such that
+ * r = (a - b) mod q
+ * @param r the result
+ * @param a the first scalar
+ * @param b the second scalar
+ */
+void hw_sc_sub(unsigned char *r, const unsigned char *a, const unsigned char *b)
+{
+    unsigned char _a[KEY_SIZE];
+
+    unsigned char _b[KEY_SIZE];
+
+    // Load scalar a
+    reverse32(_a, a);
+
+    // Load scalar b
+    reverse32(_b, b);
+
+    // (a - b) mod q
+    cx_math_subm(r, _a, _b, (unsigned char *)C_ED25519_ORDER, KEY_SIZE);
+
+    // Unload the resulting scalar
+    reverse32(r, r);
+}
+
+/**
+ * Performs scalar multiplication such that
+ * r = (a * b) mod q
+ * @param r the result
+ * @param a the first scalar
+ * @param b the second scalar
+ */
+void hw_sc_mul(unsigned char *r, const unsigned char *a, const unsigned char *b)
+{
+    unsigned char _a[KEY_SIZE];
+
+    unsigned char _b[KEY_SIZE];
+
+    reverse32(_a, a);
+
+    reverse32(_b, b);
+
+    cx_math_multm(r, _a, _b, (unsigned char *)C_ED25519_ORDER, KEY_SIZE);
+
+    reverse32(r, r);
+}
+
+/**
+ * Performs scalar subtraction and multiplication such that
+ * r = (c - (a * b)) mod q
+ * @param r the result
+ * @param a the first scalar
+ * @param b the second scalar
+ * @param c the third scalar
+ */
+void hw_sc_mulsub(unsigned char *r, const unsigned char *a, const unsigned char *B, const unsigned char *c)
+{
+    unsigned char aB[KEY_SIZE] = {0};
+
+    // a_b = (a * B) mod q
+    hw_sc_mul(aB, a, B);
+
+    // r = (c - (a * B) mod q
+    hw_sc_sub(r, c, aB);
+}
+
+#endif // SCALAR_BACKEND
\ No newline at end of file
@@ -0,0 +1,130 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#ifndef HW_ARITH_H
+#define HW_ARITH_H
+
+#include <common.h>
+#include <fe25519.h>
+
+/**
+ * The field (mod p) and scalar (mod q) arithmetic used by hw_crypto.c, each
+ * with two interchangeable backends chosen at build time:
+ *
+ * CRYPTO_BACKEND_CX        the cx_math_* syscalls, on 32-byte big endian values
+ * CRYPTO_BACKEND_SOFTWARE  the portable kernels in fe25519.c and sc25519.c
+ *
+ * A syscall costs far more than a limb multiplication, so for short chains of
+ * small operations (the field arithmetic of hash to point in particular) the
+ * software kernels can win even without hardware acceleration. Compare both
+ * with the host benchmark and PROFILE=1 before changing a default
+ */
+
+#define CRYPTO_BACKEND_CX 0
+#define CRYPTO_BACKEND_SOFTWARE 1
+
+#ifndef FIELD_BACKEND
+#define FIELD_BACKEND CRYPTO_BACKEND_CX
+#endif
+
+#ifndef SCALAR_BACKEND
+#define SCALAR_BACKEND CRYPTO_BACKEND_CX
+#endif
+
+/**
+ * hw_keccak hashes inputs shorter than one block with keccak_short (keccak.c)
+ * under the software backend, and everything else with cx_hash
+ */
+#ifndef HASH_BACKEND
+#define HASH_BACKEND CRYPTO_BACKEND_SOFTWARE
+#endif
+
+// q, big endian
+extern const unsigned char C_ED25519_ORDER[KEY_SIZE];
+
+// p, big endian
+extern const unsigned char C_ED25519_FIELD[KEY_SIZE];
+
+/**
+ * Loads a scalar to BE format so that the cx math methods can handle
+ * any math functions correctly
+ * @param result the result
+ * @param source the value to reverse
+ */
+void reverse32(unsigned char *result, const unsigned char *source);
+
+#if FIELD_BACKEND == CRYPTO_BACKEND_SOFTWARE
+typedef fe25519 hw_fe_t;
+#else
+typedef unsigned char hw_fe_t[KEY_SIZE]; // big endian and fully reduced, as cx_math_* expects
+#endif
+
+/**
+ * Loads 32 little endian bytes, all 256 bits, reduced mod p
+ */
+void hw_fe_frombytes(hw_fe_t h, const unsigned char *s);
+
+/**
+ * Loads a 32 byte big endian constant below p
+ */
+void hw_fe_frombytes_be(hw_fe_t h, const unsigned char *s);
+
+/**
+ * Stores the canonical little endian encoding of h
+ */
+void hw_fe_tobytes(unsigned char *s, const hw_fe_t h);
+
+void hw_fe_1(hw_fe_t h);
+
+void hw_fe_add(hw_fe_t h, const hw_fe_t f, const hw_fe_t g);
+
+void hw_fe_sub(hw_fe_t h, const hw_fe_t f, const hw_fe_t g);
+
+void hw_fe_neg(hw_fe_t h, const hw_fe_t f);
+
+void hw_fe_mul(hw_fe_t h, const hw_fe_t f, const hw_fe_t g);
+
+/**
+ * h = 1 / f
+ */
+void hw_fe_invert(hw_fe_t h, const hw_fe_t f);
+
+/**
+ * h = f^((p - 5) / 8)
+ */
+void hw_fe_pow22523(hw_fe_t h, const hw_fe_t f);
+
+int hw_fe_isnonzero(const hw_fe_t f);
+
+int hw_fe_isnegative(const hw_fe_t f);
+
+/**
+ * Scalars are 32 little endian bytes in either backend
+ */
+void hw_sc_reduce32(unsigned char *r, const unsigned char *s);
+
+void hw_sc_add(unsigned char *r, const unsigned char *a, const unsigned char *b);
+
+void hw_sc_sub(unsigned char *r, const unsigned char *a, const unsigned char *b);
+
+void hw_sc_mul(unsigned char *r, const unsigned char *a, const unsigned char *b);
+
+/**
+ * r = (c - (a * b)) mod q
+ */
+void hw_sc_mulsub(unsigned char *r, const unsigned char *a, const unsigned char *b, const unsigned char *c);
+
+#endif // HW_ARITH_H
\ No newline at end of file
@@ -18,8 +18,17 @@
 
 #include "hw_crypto.h"
 
-#define BUFFER G_io_apdu_buffer
-#define BUFFER_SIZE KEY_SIZE + SIG_SET_SIZE
+#include <hw_arith.h>
+#include <keccak.h>
+#include <nonce_pool.h>
+#include <profile.h>
+#include <scratch.h>
+
+// every routine that needs scratch space names its region scratch
+#define BUFFER scratch.ptr
+
+// the prefix hash followed by the L and R of every ring member, hashed as one
+#define RING_SCRATCH_SIZE KEY_SIZE + SIG_SET_SIZE
 
 static const uint32_t HARDENED_OFFSET = 0x80000000;
 
@@ -32,15 +41,6 @@ static const unsigned char WIDE C_ED25519_G[65] = {
     0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
     0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x58};
 
-// q
-static const unsigned char C_ED25519_ORDER[32] = {0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                                                  0x00, 0x00, 0x00, 0x00, 0x00, 0x14, 0xDE, 0xF9, 0xDE, 0xA2, 0xF7,
-                                                  0x9C, 0xD6, 0x58, 0x12, 0x63, 0x1A, 0x5C, 0xF5, 0xD3, 0xED};
-
-static const unsigned char C_ED25519_FIELD[32] = {0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-                                                  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-                                                  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xed};
-
 static const unsigned char C_fe_fffb1[32] = {0x7e, 0x71, 0xfb, 0xef, 0xda, 0xd6, 0x1b, 0x17, 0x20, 0xa9, 0xc5,
                                              0x37, 0x41, 0xfb, 0x19, 0xe3, 0xd1, 0x94, 0x04, 0xa8, 0xb9, 0x2a,
                                              0x73, 0x8d, 0x22, 0xa7, 0x69, 0x75, 0x32, 0x1c, 0x41, 0xee};
@@ -65,36 +65,10 @@ static const unsigned char C_fe_ma2[32] = {0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0
                                            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
                                            0xff, 0xff, 0xff, 0xff, 0xff, 0xc8, 0xdb, 0x3d, 0xe3, 0xc9};
 
-static const unsigned char C_fe_qm5div8[32] = {0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-                                               0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-                                               0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfd};
-
 static const unsigned char C_fe_sqrtm1[32] = {0x2b, 0x83, 0x24, 0x80, 0x4f, 0xc1, 0xdf, 0x0b, 0x2b, 0x4d, 0x00,
                                               0x99, 0x3d, 0xfb, 0xd7, 0xa7, 0x2f, 0x43, 0x18, 0x06, 0xad, 0x2f,
                                               0xe4, 0x78, 0xc4, 0xee, 0x1b, 0x27, 0x4a, 0x0e, 0xa0, 0xb0};
 
-/**
- * Loads a scalar to BE format so that the cx math methods can handle
- * any math functions correctly
- * @param result the result
- * @param source the value to reverse
- */
-static void reverse32(unsigned char *result, const unsigned char *source)
-{
-    unsigned char x;
-
-    unsigned int i;
-
-    for (i = 0; i < 16; i++)
-    {
-        x = source[i];
-
-        result[i] = source[31 - i];
-
-        result[31 - i] = x;
-    }
-}
-
 /**
  * Loads the public key into a raw point for further cx manipulation
  * @param point the raw point
@@ -115,6 +89,8 @@ static uint16_t hw_ge_frombytes_vartime(unsigned char *point, const unsigned cha
 
                 os_memmove(&aB[1], public, KEY_SIZE);
 
+                PROFILE_OP(PROFILE_OP_DECOMPRESS);
+
                 cx_edward_decompress_point(CX_CURVE_Ed25519, aB, SIG_STR_SIZE);
             }
 
@@ -149,26 +125,6 @@ static void hw_ge_tobytes(unsigned char *public, const unsigned char *point)
     os_memmove(public, &aB[1], KEY_SIZE);
 }
 
-/**
- * Creates a private key point within the correct curve order
- * r = s mod q
- * @param result the resulting scalar
- * @param source the value to reduce
- */
-static void hw_sc_reduce32(unsigned char *r, const unsigned char *s)
-{
-    unsigned char _s[KEY_SIZE];
-
-    // Load the data for reduction
-    reverse32(_s, s);
-
-    // Put it on the curve in the proper order
-    cx_math_modm(_s, KEY_SIZE, (unsigned char *)C_ED25519_ORDER, KEY_SIZE);
-
-    // Unload the resulting scalar
-    reverse32(r, _s);
-}
-
 /**
  * Turns a derivation into a scalar such that
  * r = H(d || n) mod q
@@ -205,99 +161,6 @@ static uint16_t hw_derivation_to_scalar(unsigned char *r, const unsigned char *d
     return OP_OK;
 }
 
-/**
- * Performs scalar addition such that
- * r = (a + b) mod q
- * @param r the result
- * @param a the first scalar
- * @param b the second scalar
- */
-static void hw_sc_add(unsigned char *r, const unsigned char *a, const unsigned char *b)
-{
-    unsigned char _a[KEY_SIZE];
-
-    unsigned char _b[KEY_SIZE];
-
-    // Load scalar a
-    reverse32(_a, a);
-
-    // Load scalar b
-    reverse32(_b, b);
-
-    // Add the scalars together
-    cx_math_addm(r, _a, _b, (unsigned char *)C_ED25519_ORDER, KEY_SIZE);
-
-    // Unload the resulting scalar
-    reverse32(r, r);
-}
-
-/**
- * Performs scalar subtraction such that
- * r = (a - b) mod q
- * @param r the result
- * @param a the first scalar
- * @param b the second scalar
- */
-static void hw_sc_sub(unsigned char *r, const unsigned char *a, const unsigned char *b)
-{
-    unsigned char _a[KEY_SIZE];
-
-    unsigned char _b[KEY_SIZE];
-
-    // Load scalar a
-    reverse32(_a, a);
-
-    // Load scalar b
-    reverse32(_b, b);
-
-    // (a - b) mod q
-    cx_math_subm(r, _a, _b, (unsigned char *)C_ED25519_ORDER, KEY_SIZE);
-
-    // Unload the resulting scalar
-    reverse32(r, r);
-}
-
-/**
- * Performs scalar multiplication such that
- * r = (a * b) mod q
- * @param r the result
- * @param a the first scalar
- * @param b the second scalar
- */
-static void hw_sc_mul(unsigned char *r, const unsigned char *a, const unsigned char *b)
-{
-    unsigned char _a[KEY_SIZE];
-
-    unsigned char _b[KEY_SIZE];
-
-    reverse32(_a, a);
-
-    reverse32(_b, b);
-
-    cx_math_multm(r, _a, _b, (unsigned char *)C_ED25519_ORDER, KEY_SIZE);
-
-    reverse32(r, r);
-}
-
-/**
- * Performs scalar subtraction and multiplication such that
- * r = (c - (a * b)) mod q
- * @param r the result
- * @param a the first scalar
- * @param b the second scalar
- * @param c the third scalar
- */
-static void hw_sc_mulsub(unsigned char *r, const unsigned char *a, const unsigned char *B, const unsigned char *c)
-{
-    unsigned char aB[KEY_SIZE] = {0};
-
-    // a_b = (a * B) mod q
-    hw_sc_mul(aB, a, B);
-
-    // r = (c - (a * B) mod q
-    hw_sc_sub(r, c, aB);
-}
-
 /**
  * Adds two points together
  * r = p + q
@@ -355,6 +218,8 @@ static void hw_ge_scalarmult_base(unsigned char *A, const unsigned char *a)
     os_memmove(aG, C_ED25519_G, SIG_STR_SIZE);
 
     // Multiply the private key by G
+    PROFILE_OP(PROFILE_OP_SCALAR_MULT);
+
     cx_ecfp_scalar_mult(CX_CURVE_Ed25519, aG, SIG_STR_SIZE, _a, KEY_SIZE);
 
     // compress the point back to bytes
@@ -387,6 +252,8 @@ static int hw_ge_scalarmult(unsigned char *r, const unsigned char *B, const unsi
     }
 
     // multiply them together
+    PROFILE_OP(PROFILE_OP_SCALAR_MULT);
+
     cx_ecfp_scalar_mult(CX_CURVE_Ed25519, aB, SIG_STR_SIZE, _a, KEY_SIZE);
 
     // compress the point back to bytes
@@ -426,121 +293,95 @@ static int hw_ge_mul8(unsigned char *r, const unsigned char *A)
     return OP_OK;
 }
 
-#define MOD (unsigned char *)C_ED25519_FIELD, KEY_SIZE
-#define fe_isnegative(f) (f[31] & 1)
-
 /**
  * Loads the input bytes into a point on the ED25519 curve
  * Thanks to knacc and moneromoo help on IRC #monero-research-lab via
  * https://github.com/LedgerHQ/app-monero/blob/master/src/monero_crypto.c
+ * The field arithmetic goes through hw_arith.h so that it runs on either
+ * backend
  * @param ge the resulting point on the ED25519 curve
  * @param bytes the bytes to load
  */
 static void hw_ge_fromfe_frombytes_vartime(unsigned char *ge, const unsigned char *bytes)
 {
-    unsigned char u[KEY_SIZE] = {0};
-
-    unsigned char v[KEY_SIZE] = {0};
-
-    unsigned char w[KEY_SIZE] = {0};
-
-    unsigned char x[KEY_SIZE] = {0};
-
-    unsigned char y[KEY_SIZE] = {0};
-
-    unsigned char z[KEY_SIZE] = {0};
-
-    unsigned char rX[KEY_SIZE] = {0};
+    hw_fe_t u, v, w, x, y, z, rX, rY, rZ;
 
-    unsigned char rY[KEY_SIZE] = {0};
-
-    unsigned char rZ[KEY_SIZE] = {0};
-
-    union
-    {
-        struct
-        {
-            unsigned char _uv7[KEY_SIZE];
-
-            unsigned char _v3[KEY_SIZE];
-        };
-
-        unsigned char _Pxy[SIG_STR_SIZE];
-    } uv;
+    // holds whichever constant is needed next
+    hw_fe_t c;
 
     unsigned char sign;
 
-    // ledger cx calls work in BE
-    reverse32(u, bytes);
-
-    cx_math_modm(u, KEY_SIZE, (unsigned char *)C_ED25519_FIELD, KEY_SIZE);
+    hw_fe_frombytes(u, bytes);
 
-    cx_math_multm(v, u, u, MOD); // (2 * u^2)
+    hw_fe_mul(v, u, u); // (2 * u^2)
 
-    cx_math_addm(v, v, v, MOD);
+    hw_fe_add(v, v, v);
 
-    explicit_bzero(w, KEY_SIZE);
+    hw_fe_1(w);
 
-    w[31] = 1; // w = 1
+    hw_fe_add(w, v, w); // w = (2 * u^2 + 1)
 
-    cx_math_addm(w, v, w, MOD); // w = (2 * u^2 + 1)
+    hw_fe_mul(x, w, w); // w^2
 
-    cx_math_multm(x, w, w, MOD); // w^2
+    hw_fe_frombytes_be(c, C_fe_ma2);
 
-    cx_math_multm(y, (unsigned char *)C_fe_ma2, v, MOD); // -2 * A^2 * u^2
+    hw_fe_mul(y, c, v); // -2 * A^2 * u^2
 
-    cx_math_addm(x, x, y, MOD); // x = w^2 - 2 * A^2 * u^2
+    hw_fe_add(x, x, y); // x = w^2 - 2 * A^2 * u^2
 
     // inline fe_divpowm1(r->X, w, x);     // (w / x)^(m + 1) =>
     // fe_divpowm1(r,u,v)
     {
-        cx_math_multm(uv._v3, x, x, MOD);
+        hw_fe_t uv7, v3;
+
+        hw_fe_mul(v3, x, x);
 
-        cx_math_multm(uv._v3, uv._v3, x, MOD); // v3 = v^3
+        hw_fe_mul(v3, v3, x); // v3 = v^3
 
-        cx_math_multm(uv._uv7, uv._v3, uv._v3, MOD);
+        hw_fe_mul(uv7, v3, v3);
 
-        cx_math_multm(uv._uv7, uv._uv7, x, MOD);
+        hw_fe_mul(uv7, uv7, x);
 
-        cx_math_multm(uv._uv7, uv._uv7, w, MOD); // uv7 = uv^7
+        hw_fe_mul(uv7, uv7, w); // uv7 = uv^7
 
-        cx_math_powm(uv._uv7, uv._uv7, (unsigned char *)C_fe_qm5div8, KEY_SIZE,
-                     MOD); // (uv^7)^((q-5)/8)
+        hw_fe_pow22523(uv7, uv7); // (uv^7)^((q-5)/8)
 
-        cx_math_multm(uv._uv7, uv._uv7, uv._v3, MOD);
+        hw_fe_mul(uv7, uv7, v3);
 
-        cx_math_multm(rX, uv._uv7, w, MOD); // u^(m+1)v^(-(m+1))
+        hw_fe_mul(rX, uv7, w); // u^(m+1)v^(-(m+1))
     }
 
-    cx_math_multm(y, rX, rX, MOD);
+    hw_fe_mul(y, rX, rX);
 
-    cx_math_multm(x, y, x, MOD);
+    hw_fe_mul(x, y, x);
 
-    cx_math_subm(y, w, x, MOD);
+    hw_fe_sub(y, w, x);
 
-    os_memmove(z, C_fe_ma, KEY_SIZE);
+    hw_fe_frombytes_be(z, C_fe_ma);
 
-    if (!cx_math_is_zero(y, KEY_SIZE))
+    if (hw_fe_isnonzero(y))
     {
-        cx_math_addm(y, w, x, MOD);
+        hw_fe_add(y, w, x);
 
-        if (!cx_math_is_zero(y, KEY_SIZE))
+        if (hw_fe_isnonzero(y))
         {
             goto negative;
         }
         else
         {
-            cx_math_multm(rX, rX, (unsigned char *)C_fe_fffb1, MOD);
+            hw_fe_frombytes_be(c, C_fe_fffb1);
         }
     }
     else
     {
-        cx_math_multm(rX, rX, (unsigned char *)C_fe_fffb2, MOD);
+        hw_fe_frombytes_be(c, C_fe_fffb2);
     }
 
-    cx_math_multm(rX, rX, u, MOD); // u * sqrt(2 * A * (A + 2) * w / x)
+    hw_fe_mul(rX, rX, c);
 
-    cx_math_multm(z, z, v, MOD); // -2 * A * u^2
+    hw_fe_mul(rX, rX, u); // u * sqrt(2 * A * (A + 2) * w / x)
+
+    hw_fe_mul(z, z, v); // -2 * A * u^2
 
     sign = 0;
 
@@ -549,46 +390,50 @@ static void hw_ge_fromfe_frombytes_vartime(unsigned char *ge, const unsigned cha
     // clang-format off
     negative:
     {
-        cx_math_multm(x, x, (unsigned char *)C_fe_sqrtm1, MOD);
+        hw_fe_frombytes_be(c, C_fe_sqrtm1);
 
-        cx_math_subm(y, w, x, MOD);
+        hw_fe_mul(x, x, c);
 
-        if (!cx_math_is_zero(y, KEY_SIZE))
-        {
-            cx_math_addm(y, w, x, MOD);
+        hw_fe_sub(y, w, x);
 
-            cx_math_multm(rX, rX, (unsigned char *)C_fe_fffb3, MOD);
+        if (hw_fe_isnonzero(y))
+        {
+            hw_fe_frombytes_be(c, C_fe_fffb3);
         }
         else
         {
-            cx_math_multm(rX, rX, (unsigned char *)C_fe_fffb4, MOD);
+            hw_fe_frombytes_be(c, C_fe_fffb4);
         }
 
+        hw_fe_mul(rX, rX, c);
+
         sign = 1;
     }
 
     setsign:
     {
-        if (fe_isnegative(rX) != sign)
+        if (hw_fe_isnegative(rX) != sign)
         {
-            cx_math_sub(rX, (unsigned char *)C_ED25519_FIELD, rX, KEY_SIZE);
+            hw_fe_neg(rX, rX);
         }
 
-        cx_math_addm(rZ, z, w, MOD);
+        hw_fe_add(rZ, z, w);
 
-        cx_math_subm(rY, z, w, MOD);
+        hw_fe_sub(rY, z, w);
 
-        cx_math_multm(rX, rX, rZ, MOD);
+        hw_fe_mul(rX, rX, rZ);
 
-        cx_math_invprimem(u, rZ, MOD);
+        // affine x = X / Z and y = Y / Z
+        hw_fe_invert(u, rZ);
 
-        uv._Pxy[0] = 0x04;
+        hw_fe_mul(rX, rX, u);
 
-        cx_math_multm(&uv._Pxy[1], rX, u, MOD);
+        hw_fe_mul(rY, rY, u);
 
-        cx_math_multm(&uv._Pxy[1 + KEY_SIZE], rY, u, MOD);
+        // compress: y with the sign of x in the top bit
+        hw_fe_tobytes(ge, rY);
 
-        hw_ge_tobytes(ge, uv._Pxy);
+        ge[KEY_SIZE - 1] |= hw_fe_isnegative(rX) << 7;
     }
     // clang-format on
 }
@@ -613,6 +458,52 @@ static int hw_hash_to_ec(unsigned char *ec, const unsigned char *A)
     return hw_ge_mul8(ec, ec);
 }
 
+/**
+ * Hp(A) through the cache (if any), computing and remembering it on a miss
+ * @param ec the resulting elliptic curve point
+ * @param A the key to perform the operation on
+ * @param cache the cache to look in, may be NULL
+ */
+static int hw_hash_to_ec_cached(unsigned char *ec, const unsigned char *A, hp_cache_t *cache)
+{
+    if (cache == NULL)
+    {
+        return hw_hash_to_ec(ec, A);
+    }
+
+    uint8_t i;
+
+    for (i = 0; i < cache->count; i++)
+    {
+        if (os_memcmp(cache->keys[i], A, KEY_SIZE) == 0)
+        {
+            os_memmove(ec, cache->points[i], KEY_SIZE);
+
+            return OP_OK;
+        }
+    }
+
+    const uint16_t status = hw_hash_to_ec(ec, A);
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+
+    const uint8_t slot = (cache->count < HP_CACHE_SIZE) ? cache->count++ : cache->next;
+
+    if (cache->count == HP_CACHE_SIZE)
+    {
+        cache->next = (slot + 1) % HP_CACHE_SIZE;
+    }
+
+    os_memmove(cache->keys[slot], A, KEY_SIZE);
+
+    os_memmove(cache->points[slot], ec, KEY_SIZE);
+
+    return OP_OK;
+}
+
 /**
  * r = (a * P) + (b * G)
  * @param r the result
@@ -706,6 +597,8 @@ static void hw_random_scalar(unsigned char *private)
 {
     unsigned char random[KEY_SIZE + 8];
 
+    PROFILE_OP(PROFILE_OP_RNG);
+
     cx_rng(random, KEY_SIZE + 8);
 
     cx_math_modm(random, KEY_SIZE + 8, (unsigned char *)C_ED25519_ORDER, KEY_SIZE);
@@ -770,22 +663,33 @@ static uint16_t hw__prepare_ring_signatures(
     const unsigned char *public_keys,
     const size_t real_output_index)
 {
+    scratch_t scratch = SCRATCH_INIT;
+
     BEGIN_TRY
     {
 #define REAL_SIG_POSITION signatures + (real_output_index * SIG_SIZE)
         TRY
         {
+            scratch_acquire(&scratch, RING_SCRATCH_SIZE);
+
             // clear the buffer to make sure that it's not polluted
-            explicit_bzero(BUFFER, BUFFER_SIZE);
+            explicit_bzero(BUFFER, RING_SCRATCH_SIZE);
 
             // copy the transaction prefix hash into the buffer
             os_memmove(BUFFER, tx_prefix_hash, KEY_SIZE);
 
-            // generate a random scalar
-            hw_random_scalar(k);
+            // a random scalar k and L = k * G for the real output
+            uint16_t status = nonce_pool_take(k, BUFFER + KEY_SIZE + (real_output_index * SIG_SIZE));
+
+            if (status != OP_OK)
+            {
+                THROW(status);
+            }
 
             unsigned char sum[KEY_SIZE] = {0};
 
+            unsigned char LP[KEY_SIZE];
+
             size_t i;
 
             /**
@@ -808,11 +712,8 @@ static uint16_t hw__prepare_ring_signatures(
                  */
                 if (i == real_output_index)
                 {
-                    // L = k * G
-                    hw_ge_scalarmult_base(BL, k);
-
                     // Hp(P)
-                    uint16_t status = hw_hash_to_ec(BR, PUBLIC_KEY);
+                    status = hw_hash_to_ec(BR, PUBLIC_KEY);
 
                     if (status != OP_OK)
                     {
@@ -836,11 +737,23 @@ static uint16_t hw__prepare_ring_signatures(
                     // generate a new random scalar
                     hw_random_scalar(L);
 
-                    // generate a new random scalar
-                    hw_random_scalar(R);
+                    // generate a new random scalar k2 along with k2 * G
+                    status = nonce_pool_take(R, BL);
+
+                    if (status != OP_OK)
+                    {
+                        THROW(status);
+                    }
+
+                    status = hw_ge_scalarmult(LP, PUBLIC_KEY, L);
+
+                    if (status != OP_OK)
+                    {
+                        THROW(status);
+                    }
 
                     // L = (k1 * P) + (k2 * G)
-                    uint16_t status = hw_ge_double_scalarmult_base(BL, L, PUBLIC_KEY, R);
+                    status = hw_ge_add(BL, LP, BL);
 
                     if (status != OP_OK)
                     {
@@ -877,7 +790,7 @@ static uint16_t hw__prepare_ring_signatures(
             unsigned char hash[32] = {0};
 
             // Hs(prefix + L's + R's)
-            const uint16_t status = hw_hash_to_scalar(hash, BUFFER, BUFFER_SIZE);
+            status = hw_hash_to_scalar(hash, BUFFER, RING_SCRATCH_SIZE);
 
             if (status != OP_OK)
             {
@@ -892,16 +805,19 @@ static uint16_t hw__prepare_ring_signatures(
 
             CLOSE_TRY;
 
+            // wipe the region as we don't want that leaking
+            scratch_release(&scratch);
+
             return OP_OK;
         }
         CATCH_OTHER(e)
         {
+            scratch_release(&scratch);
+
             return e;
         }
         FINALLY
         {
-            // wipe the buffer as we don't want that leaking
-            explicit_bzero(BUFFER, BUFFER_SIZE);
 #undef REAL_SIG_POSITION
         }
     }
@@ -912,22 +828,30 @@ static uint16_t hw__prepare_ring_signatures(
  * END OF STATIC METHODS
  */
 
-uint16_t hw_check_signature(
-    const unsigned char *message_digest,
-    const unsigned char *public_key,
-    const unsigned char *signature)
-{
 #define S_COMM_SIZE KEY_SIZE + KEY_SIZE + KEY_SIZE
-#define MESSAGE_DIGEST BUFFER
+#define MESSAGE_DIGEST buffer
 #define KEY MESSAGE_DIGEST + KEY_SIZE
 #define COMM KEY + KEY_SIZE
 #define SCALAR COMM + KEY_SIZE
+#define CHECK_SCRATCH_SIZE S_COMM_SIZE + KEY_SIZE
+
+/**
+ * Checks a signature of the message digest already loaded at the start of
+ * the buffer, the caller wipes the buffer afterwards
+ * @param buffer the scratch region of the caller {128 bytes}
+ * @param public_key the public key of the signer
+ * @param signature the signature
+ * @return 1 if the signature is valid
+ */
+static uint16_t hw__check_signature(
+    unsigned char *buffer,
+    const unsigned char *public_key,
+    const unsigned char *signature)
+{
     BEGIN_TRY
     {
         TRY
         {
-            os_memmove(MESSAGE_DIGEST, message_digest, KEY_SIZE);
-
             os_memmove(KEY, public_key, KEY_SIZE);
 
             uint16_t status = hw_ge_double_scalarmult_base(COMM, signature, public_key, signature + 32);
@@ -937,7 +861,7 @@ uint16_t hw_check_signature(
                 THROW(status);
             }
 
-            status = hw_hash_to_scalar(SCALAR, BUFFER, S_COMM_SIZE);
+            status = hw_hash_to_scalar(SCALAR, buffer, S_COMM_SIZE);
 
             if (status != OP_OK)
             {
@@ -956,19 +880,110 @@ uint16_t hw_check_signature(
         {
             return e;
         }
-        FINALLY
+        FINALLY {}
+    }
+    END_TRY;
+}
+
+uint16_t hw_check_signature(
+    const unsigned char *message_digest,
+    const unsigned char *public_key,
+    const unsigned char *signature)
+{
+    scratch_t scratch = SCRATCH_INIT;
+
+    BEGIN_TRY
+    {
+        TRY
         {
-            // wipe the buffer as we don't want that leaking
-            explicit_bzero(BUFFER, BUFFER_SIZE);
+            unsigned char *buffer = scratch_acquire(&scratch, CHECK_SCRATCH_SIZE);
+
+            os_memmove(MESSAGE_DIGEST, message_digest, KEY_SIZE);
+
+            const uint16_t status = hw__check_signature(buffer, public_key, signature);
+
+            CLOSE_TRY;
+
+            // wipe the region as we don't want that leaking
+            scratch_release(&scratch);
+
+            return status;
+        }
+        CATCH_OTHER(e)
+        {
+            scratch_release(&scratch);
+
+            return e;
+        }
+        FINALLY {}
+    }
+    END_TRY;
+}
+
+/**
+ * Checks count signatures of the same message digest, which is loaded into
+ * the buffer once for all of them
+ * @param results bit i is set if signature i is valid {(count + 7) / 8 bytes}
+ * @param message_digest the message digest
+ * @param count the number of signatures
+ * @param public_keys the public keys of the signers {32 bytes * count}
+ * @param signatures the signatures {64 bytes * count}
+ * @return
+ */
+uint16_t hw_check_signatures(
+    unsigned char *results,
+    const unsigned char *message_digest,
+    const size_t count,
+    const unsigned char *public_keys,
+    const unsigned char *signatures)
+{
+    scratch_t scratch = SCRATCH_INIT;
+
+    explicit_bzero(results, (count + 7) / 8);
+
+    BEGIN_TRY
+    {
+        TRY
+        {
+            unsigned char *buffer = scratch_acquire(&scratch, CHECK_SCRATCH_SIZE);
+
+            os_memmove(MESSAGE_DIGEST, message_digest, KEY_SIZE);
+
+            size_t i;
+
+            for (i = 0; i < count; i++)
+            {
+                // an error (ie. a key that is not a point) fails only its own signature
+                if (hw__check_signature(buffer, public_keys + (i * KEY_SIZE), signatures + (i * SIG_SIZE)) == 1)
+                {
+                    results[i / 8] |= 1 << (i % 8);
+                }
+            }
+
+            CLOSE_TRY;
+
+            // wipe the region as we don't want that leaking
+            scratch_release(&scratch);
+
+            return OP_OK;
+        }
+        CATCH_OTHER(e)
+        {
+            scratch_release(&scratch);
+
+            return e;
+        }
+        FINALLY {}
+    }
+    END_TRY;
+}
+
+#undef CHECK_SCRATCH_SIZE
 #undef SCALAR
 #undef COMM
 #undef KEY
 #undef MESSAGE_DIGEST
 #undef S_COMM_SIZE
-        }
-    }
-    END_TRY;
-}
 
 uint16_t hw_check_ring_signatures(
     const unsigned char *tx_prefix_hash,
@@ -976,14 +991,35 @@ uint16_t hw_check_ring_signatures(
     const unsigned char *public_keys,
     const unsigned char *signatures)
 {
+    return hw_check_ring_signatures_cached(tx_prefix_hash, key_image, public_keys, signatures, NULL);
+}
+
+/**
+ * Checks a set of ring signatures, looking up Hp(P) of the ring members in
+ * the cache (if any) that is carried from one ring to the next
+ * @param tx_prefix_hash the transaction prefix hash
+ * @param key_image the key image
+ * @param public_keys the public keys of the ring members
+ * @param signatures the ring signatures
+ * @param cache the Hp(P) cache, may be NULL
+ * @return 1 if the ring signatures are valid
+ */
+uint16_t hw_check_ring_signatures_cached(
+    const unsigned char *tx_prefix_hash,
+    const unsigned char *key_image,
+    const unsigned char *public_keys,
+    const unsigned char *signatures,
+    hp_cache_t *cache)
+{
+    scratch_t scratch = SCRATCH_INIT;
+
     BEGIN_TRY
     {
         TRY
         {
-            // clear the buffer to make sure that it's not polluted
-            explicit_bzero(BUFFER, BUFFER_SIZE);
+            scratch_acquire(&scratch, RING_SCRATCH_SIZE);
 
-            // copy the transaction prefix hash into the buffer
+            // every L and R below is written before it is hashed so the prefix hash is all that is loaded
             os_memmove(BUFFER, tx_prefix_hash, KEY_SIZE);
 
             unsigned char sum[KEY_SIZE] = {0};
@@ -1007,7 +1043,7 @@ uint16_t hw_check_ring_signatures(
                 }
 
                 // Hp(P)
-                status = hw_hash_to_ec(BR, PUBLIC_KEY);
+                status = hw_hash_to_ec_cached(BR, PUBLIC_KEY, cache);
 
                 if (status != OP_OK)
                 {
@@ -1035,7 +1071,7 @@ uint16_t hw_check_ring_signatures(
             unsigned char hash[KEY_SIZE] = {0};
 
             // Hs(prefix + L's + R's)
-            const uint16_t status = hw_hash_to_scalar(hash, BUFFER, BUFFER_SIZE);
+            const uint16_t status = hw_hash_to_scalar(hash, BUFFER, RING_SCRATCH_SIZE);
 
             if (status != OP_OK)
             {
@@ -1049,18 +1085,19 @@ uint16_t hw_check_ring_signatures(
 
             CLOSE_TRY;
 
+            // wipe the region as we don't want that leaking
+            scratch_release(&scratch);
+
             return cx_math_is_zero(hash, KEY_SIZE);
         }
         CATCH_OTHER(e)
         {
             // this would be (false) to mere humans
+            scratch_release(&scratch);
+
             return e;
         }
-        FINALLY
-        {
-            // wipe the buffer as we don't want that leaking
-            explicit_bzero(BUFFER, BUFFER_SIZE);
-        }
+        FINALLY {}
     }
     END_TRY;
 }
@@ -1079,10 +1116,14 @@ uint16_t hw_complete_ring_signature(
 #define PUBLIC_EPHEMERAL DERIVATION + KEY_SIZE
 #define PRIVATE_EPHEMERAL PUBLIC_EPHEMERAL + KEY_SIZE
 
+    scratch_t scratch = SCRATCH_INIT;
+
     BEGIN_TRY
     {
         TRY
         {
+            scratch_acquire(&scratch, 3 * KEY_SIZE);
+
             // Generate the transaction key derivation D = (rA)
             uint16_t status = hw_generate_key_derivation(DERIVATION, tx_public_key, privateView);
 
@@ -1125,16 +1166,19 @@ uint16_t hw_complete_ring_signature(
 
             CLOSE_TRY;
 
+            // wipe the region as we don't want that leaking
+            scratch_release(&scratch);
+
             return OP_OK;
         }
         CATCH_OTHER(e)
         {
+            scratch_release(&scratch);
+
             return e;
         }
         FINALLY
         {
-            // wipe the buffer as we don't want that leaking
-            explicit_bzero(BUFFER, BUFFER_SIZE);
 #undef PRIVATE_EPHEMERAL
 #undef PUBLIC_EPHEMERAL
 #undef DERIVATION
@@ -1252,20 +1296,18 @@ uint16_t hw_generate_ring_signatures(
     const unsigned char *privateSpend,
     const unsigned char *publicSpend)
 {
-    /**
-     * We have to use a local buffer here to avoid running into issues in using
-     * the shared working space that hw__generate_ring_signatures() will use
-     */
-    unsigned char buffer[KEY_SIZE * 2] = {0};
-
-#define LOCAL_BUFFER ((unsigned char *)buffer)
-#define DERIVATION LOCAL_BUFFER
+#define DERIVATION BUFFER
 #define EPHEMERAL DERIVATION + KEY_SIZE
 
+    // hw__generate_ring_signatures() takes its own region on top of this one
+    scratch_t scratch = SCRATCH_INIT;
+
     BEGIN_TRY
     {
         TRY
         {
+            scratch_acquire(&scratch, 2 * KEY_SIZE);
+
             // Generate the transaction key derivation D = (rA)
             uint16_t status = hw_generate_key_derivation(DERIVATION, tx_public_key, privateView);
 
@@ -1322,48 +1364,88 @@ uint16_t hw_generate_ring_signatures(
 
             CLOSE_TRY;
 
+            // wipe the region as we don't want that leaking
+            scratch_release(&scratch);
+
             return OP_OK;
         }
         CATCH_OTHER(e)
         {
+            scratch_release(&scratch);
+
             return e;
         }
         FINALLY
         {
-            // wipe the buffer as we don't want that leaking
-            explicit_bzero(buffer, sizeof(buffer));
-#undef PRIVATE_EPHEMERAL
-#undef PUBLIC_EPHEMERAL
+#undef EPHEMERAL
 #undef DERIVATION
-#undef LOCAL_BUFFER
         }
     }
     END_TRY;
 }
 
+/**
+ * Calculates the key derivation D = 8 * (a * P) with a single multiplication
+ * by the integer k = 8 * (a mod q). Every point on the curve has an order
+ * dividing 8 * q, so k * P = 8 * a * P for any P, including one with a small
+ * order component, and no separate multiplication by 8 is needed
+ * @param derivation the resulting key derivation
+ * @param public the public key
+ * @param private the private key
+ */
 uint16_t
     hw_generate_key_derivation(unsigned char *derivation, const unsigned char *public, const unsigned char *private)
 {
+    unsigned char k[KEY_SIZE];
+
+    unsigned char aP[SIG_STR_SIZE];
+
+    unsigned int i;
+
     BEGIN_TRY
     {
         TRY
         {
-            const uint16_t status = hw_ge_scalarmult(derivation, public, private);
+            // Load the public key
+            const uint16_t status = hw_ge_frombytes_vartime(aP, public);
 
             if (status != OP_OK)
             {
                 THROW(status);
             }
 
+            hw_sc_reduce32(k, private);
+
+            // a mod q < 2^253, so shifting in the factor of 8 cannot overflow
+            for (i = KEY_SIZE - 1; i > 0; i--)
+            {
+                k[i] = (k[i] << 3) | (k[i - 1] >> 5);
+            }
+
+            k[0] <<= 3;
+
+            // cx works in BE
+            reverse32(k, k);
+
+            PROFILE_OP(PROFILE_OP_SCALAR_MULT);
+
+            cx_ecfp_scalar_mult(CX_CURVE_Ed25519, aP, SIG_STR_SIZE, k, KEY_SIZE);
+
+            // compress the point back to bytes
+            hw_ge_tobytes(derivation, aP);
+
             CLOSE_TRY;
 
-            return hw_ge_mul8(derivation, derivation);
+            return OP_OK;
         }
         CATCH_OTHER(e)
         {
             return e;
         }
-        FINALLY {}
+        FINALLY
+        {
+            explicit_bzero(k, sizeof(k));
+        }
     }
     END_TRY;
 }
@@ -1377,6 +1459,8 @@ uint16_t hw_generate_key_image(
     const unsigned char *privateSpend,
     const unsigned char *publicSpend)
 {
+    scratch_t scratch = SCRATCH_INIT;
+
     BEGIN_TRY
     {
 #define DERIVATION BUFFER
@@ -1384,6 +1468,8 @@ uint16_t hw_generate_key_image(
 #define PRIVATE_EPHEMERAL PUBLIC_EPHEMERAL + KEY_SIZE
         TRY
         {
+            scratch_acquire(&scratch, 3 * KEY_SIZE);
+
             // Generate the transaction key derivation D = (rA)
             uint16_t status = hw_generate_key_derivation(DERIVATION, tx_public_key, privateView);
 
@@ -1420,19 +1506,24 @@ uint16_t hw_generate_key_image(
                 THROW(status);
             }
 
+            // Generate the key image I = Hp(P)x
+            status = hw__generate_key_image(key_image, PUBLIC_EPHEMERAL, PRIVATE_EPHEMERAL);
+
             CLOSE_TRY;
 
-            // Generate the key image I = Hp(P)x
-            return hw__generate_key_image(key_image, PUBLIC_EPHEMERAL, PRIVATE_EPHEMERAL);
+            // wipe the region as we don't want that leaking
+            scratch_release(&scratch);
+
+            return status;
         }
         CATCH_OTHER(e)
         {
+            scratch_release(&scratch);
+
             return e;
         }
         FINALLY
         {
-            // wipe the buffer as we don't want that leaking
-            explicit_bzero(BUFFER, BUFFER_SIZE);
 #undef PRIVATE_EPHEMERAL
 #undef PUBLIC_EPHEMERAL
 #undef DERIVATION
@@ -1449,12 +1540,16 @@ uint16_t hw_generate_key_image_primitive(
     const unsigned char *privateSpend,
     const unsigned char *publicSpend)
 {
+    scratch_t scratch = SCRATCH_INIT;
+
     BEGIN_TRY
     {
 #define PUBLIC_EPHEMERAL BUFFER
 #define PRIVATE_EPHEMERAL PUBLIC_EPHEMERAL + KEY_SIZE
         TRY
         {
+            scratch_acquire(&scratch, 2 * KEY_SIZE);
+
             // Generate the public ephemeral for the given output P = H(D || n)G + B
             uint16_t status = hw_derive_public_key(PUBLIC_EPHEMERAL, derivation, output_index, publicSpend);
 
@@ -1483,19 +1578,24 @@ uint16_t hw_generate_key_image_primitive(
                 THROW(status);
             }
 
+            // Generate the key image I = Hp(P)x
+            status = hw__generate_key_image(key_image, PUBLIC_EPHEMERAL, PRIVATE_EPHEMERAL);
+
             CLOSE_TRY;
 
-            // Generate the key image I = Hp(P)x
-            return hw__generate_key_image(key_image, PUBLIC_EPHEMERAL, PRIVATE_EPHEMERAL);
+            // wipe the region as we don't want that leaking
+            scratch_release(&scratch);
+
+            return status;
         }
         CATCH_OTHER(e)
         {
+            scratch_release(&scratch);
+
             return e;
         }
         FINALLY
         {
-            // wipe the buffer as we don't want that leaking
-            explicit_bzero(BUFFER, BUFFER_SIZE);
 #undef PRIVATE_EPHEMERAL
 #undef PUBLIC_EPHEMERAL
         }
@@ -1513,45 +1613,92 @@ uint16_t hw_generate_signature(
     const unsigned char *message_digest,
     const unsigned char *public_key,
     const unsigned char *private_key)
+{
+    return hw_generate_signatures(signature, message_digest, 1, public_key, private_key);
+}
+
+/**
+ * Signs count message digests with the same key pair. The private key is
+ * read once into RAM and the public key is loaded into the hash input once
+ * for the whole batch; every signature draws its own k from the nonce pool
+ * @param signatures the resulting signatures {64 bytes * count}
+ * @param message_digests the message digests {32 bytes * count}
+ * @param count the number of digests to sign
+ * @param public_key the public key of the signer
+ * @param private_key the private key of the signer
+ * @return
+ */
+uint16_t hw_generate_signatures(
+    unsigned char *signatures,
+    const unsigned char *message_digests,
+    const size_t count,
+    const unsigned char *public_key,
+    const unsigned char *private_key)
 {
 #define S_COMM_SIZE KEY_SIZE + KEY_SIZE + KEY_SIZE
 #define MESSAGE_DIGEST BUFFER
 #define KEY MESSAGE_DIGEST + KEY_SIZE
 #define COMM KEY + KEY_SIZE
 #define K COMM + SIG_SIZE
+    unsigned char secret[KEY_SIZE];
+
+    scratch_t scratch = SCRATCH_INIT;
+
     BEGIN_TRY
     {
         TRY
         {
-            os_memmove(MESSAGE_DIGEST, message_digest, KEY_SIZE);
+            scratch_acquire(&scratch, S_COMM_SIZE + SIG_SIZE);
+
+            os_memmove(secret, private_key, KEY_SIZE);
 
             os_memmove(KEY, public_key, KEY_SIZE);
 
-            hw_random_scalar(K);
+            size_t i;
 
-            hw_ge_scalarmult_base(COMM, K);
+            for (i = 0; i < count; i++)
+            {
+                unsigned char *signature = signatures + (i * SIG_SIZE);
 
-            const uint16_t status = hw_hash_to_scalar(signature, BUFFER, S_COMM_SIZE);
+                os_memmove(MESSAGE_DIGEST, message_digests + (i * KEY_SIZE), KEY_SIZE);
 
-            if (status != OP_OK)
-            {
-                THROW(status);
-            }
+                // k and k * G, from the nonce pool when it has one ready
+                uint16_t status = nonce_pool_take(K, COMM);
+
+                if (status != OP_OK)
+                {
+                    THROW(status);
+                }
 
-            hw_sc_mulsub(signature + KEY_SIZE, signature, private_key, K);
+                status = hw_hash_to_scalar(signature, BUFFER, S_COMM_SIZE);
+
+                if (status != OP_OK)
+                {
+                    THROW(status);
+                }
+
+                hw_sc_mulsub(signature + KEY_SIZE, signature, secret, K);
+            }
 
             CLOSE_TRY;
 
+            // wipe the region and the key as we don't want that leaking
+            scratch_release(&scratch);
+
+            explicit_bzero(secret, KEY_SIZE);
+
             return OP_OK;
         }
         CATCH_OTHER(e)
         {
+            scratch_release(&scratch);
+
+            explicit_bzero(secret, KEY_SIZE);
+
             return e;
         }
         FINALLY
         {
-            // wipe the buffer as we don't want that leaking
-            explicit_bzero(BUFFER, BUFFER_SIZE);
 #undef K
 #undef COMM
 #undef KEY
@@ -1565,6 +1712,16 @@ uint16_t hw_generate_signature(
 // cn_fast_hash
 uint16_t hw_keccak(const unsigned char *in, size_t length, unsigned char *out)
 {
+#if HASH_BACKEND == CRYPTO_BACKEND_SOFTWARE
+    // a single permutation is cheaper than the context setup and syscall of cx_hash
+    if (length < KECCAK_RATE)
+    {
+        keccak_short(in, length, out);
+
+        return OP_OK;
+    }
+#endif
+
     BEGIN_TRY
     {
         TRY
@@ -1573,6 +1730,8 @@ uint16_t hw_keccak(const unsigned char *in, size_t length, unsigned char *out)
 
             cx_keccak_init(&hw_keccak_context, KECCAK_BITS);
 
+            PROFILE_OP(PROFILE_OP_HASH);
+
             cx_hash((cx_hash_t *)&hw_keccak_context, CX_LAST, in, length, out, KEY_SIZE);
 
             CLOSE_TRY;
@@ -1611,6 +1770,8 @@ uint16_t hw_private_key_to_public_key(unsigned char *public, const unsigned char
 
 uint16_t hw_retrieve_private_spend_key(unsigned char *private)
 {
+    scratch_t scratch = SCRATCH_INIT;
+
     BEGIN_TRY
     {
 #define SEED BUFFER
@@ -1618,6 +1779,8 @@ uint16_t hw_retrieve_private_spend_key(unsigned char *private)
 #define CHAIN KEY + KEY_SIZE
         TRY
         {
+            scratch_acquire(&scratch, 4 * KEY_SIZE);
+
             uint32_t bip32Path[BIP32_PATH];
 
             os_memmove(bip32Path, derivePath, sizeof(derivePath));
@@ -1638,16 +1801,19 @@ uint16_t hw_retrieve_private_spend_key(unsigned char *private)
 
             CLOSE_TRY;
 
+            // wipe the region as we don't want that leaking
+            scratch_release(&scratch);
+
             return OP_OK;
         }
         CATCH_OTHER(e)
         {
+            scratch_release(&scratch);
+
             return e;
         }
         FINALLY
         {
-            // wipe the buffer as we don't want that leaking
-            explicit_bzero(BUFFER, BUFFER_SIZE);
 #undef CHAIN
 #undef KEY
 #undef SEED
@@ -1688,6 +1854,30 @@ uint16_t hw_check_key(const unsigned char *key)
     END_TRY;
 }
 
+/**
+ * Checks count keys, see hw_check_key()
+ * @param results bit i is set if key i is valid {(count + 7) / 8 bytes}
+ * @param keys the keys {32 bytes * count}
+ * @param count the number of keys
+ * @return
+ */
+uint16_t hw_check_keys(unsigned char *results, const unsigned char *keys, const size_t count)
+{
+    explicit_bzero(results, (count + 7) / 8);
+
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (hw_check_key(keys + (i * KEY_SIZE)) == OP_NOK)
+        {
+            results[i / 8] |= 1 << (i % 8);
+        }
+    }
+
+    return OP_OK;
+}
+
 uint16_t hw_check_scalar(const unsigned char *scalar)
 {
     unsigned char reduced[KEY_SIZE] = {0};
@@ -1721,6 +1911,30 @@ uint16_t hw_check_scalar(const unsigned char *scalar)
     END_TRY;
 }
 
+/**
+ * Checks count scalars, see hw_check_scalar()
+ * @param results bit i is set if scalar i is valid {(count + 7) / 8 bytes}
+ * @param scalars the scalars {32 bytes * count}
+ * @param count the number of scalars
+ * @return
+ */
+uint16_t hw_check_scalars(unsigned char *results, const unsigned char *scalars, const size_t count)
+{
+    explicit_bzero(results, (count + 7) / 8);
+
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (hw_check_scalar(scalars + (i * KEY_SIZE)) == OP_NOK)
+        {
+            results[i / 8] |= 1 << (i % 8);
+        }
+    }
+
+    return OP_OK;
+}
+
 /**
  * Generates a key image such that
  * I = Hp(P)x
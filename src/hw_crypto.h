@@ -23,21 +23,57 @@
 #include <string.h>
 #include <varint.h>
 
+#define HP_CACHE_SIZE 7 // 450 bytes, fits the working set of an APDU
+
+/**
+ * Remembers Hp(P) for the ring members seen by a run of ring signature
+ * checks so that keys used in more than one ring are only hashed to a
+ * point once
+ */
+typedef struct hp_cache_s
+{
+    unsigned char keys[HP_CACHE_SIZE][KEY_SIZE]; // 224-bytes, P
+
+    unsigned char points[HP_CACHE_SIZE][KEY_SIZE]; // 224-bytes, Hp(P)
+
+    uint8_t count; // 1-byte
+
+    uint8_t next; // 1-byte, the entry replaced on the next miss once the cache is full
+} hp_cache_t;
+
 uint16_t hw_check_key(const unsigned char *key);
 
+uint16_t hw_check_keys(unsigned char *results, const unsigned char *keys, const size_t count);
+
 uint16_t hw_check_scalar(const unsigned char *scalar);
 
+uint16_t hw_check_scalars(unsigned char *results, const unsigned char *scalars, const size_t count);
+
 uint16_t hw_check_signature(
     const unsigned char *message_digest,
     const unsigned char *public_key,
     const unsigned char *signature);
 
+uint16_t hw_check_signatures(
+    unsigned char *results,
+    const unsigned char *message_digest,
+    const size_t count,
+    const unsigned char *public_keys,
+    const unsigned char *signatures);
+
 uint16_t hw_check_ring_signatures(
     const unsigned char *tx_prefix_hash,
     const unsigned char *key_image,
     const unsigned char *public_keys,
     const unsigned char *signatures);
 
+uint16_t hw_check_ring_signatures_cached(
+    const unsigned char *tx_prefix_hash,
+    const unsigned char *key_image,
+    const unsigned char *public_keys,
+    const unsigned char *signatures,
+    hp_cache_t *cache);
+
 uint16_t hw_complete_ring_signature(
     unsigned char *signature,
     const unsigned char *tx_public_key,
@@ -102,6 +138,13 @@ uint16_t hw_generate_signature(
     const unsigned char *public_key,
     const unsigned char *private_key);
 
+uint16_t hw_generate_signatures(
+    unsigned char *signatures,
+    const unsigned char *message_digests,
+    const size_t count,
+    const unsigned char *public_key,
+    const unsigned char *private_key);
+
 uint16_t hw_keccak(const unsigned char *in, size_t len, unsigned char *out);
 
 uint16_t hw_private_key_to_public_key(unsigned char *public, const unsigned char *private);
@@ -0,0 +1,129 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "keccak.h"
+
+#include <os.h>
+#include <stdint.h>
+
+static const uint64_t C_keccak_rc[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+// rho rotation of each lane visited by the pi walk below
+static const unsigned char C_keccak_rotc[24] = {1,  3,  6,  10, 15, 21, 28, 36, 45, 55, 2,  14,
+                                                27, 41, 56, 8,  25, 43, 62, 18, 39, 61, 20, 44};
+
+// pi, the order in which the lanes are visited starting from lane 1
+static const unsigned char C_keccak_piln[24] = {10, 7,  11, 17, 18, 3, 5,  16, 8,  21, 24, 4,
+                                                15, 23, 19, 13, 12, 2, 20, 14, 22, 9,  6,  1};
+
+static uint64_t rotl64(const uint64_t x, const unsigned int n)
+{
+    return (x << n) | (x >> (64 - n));
+}
+
+/**
+ * The Keccak-f[1600] permutation. Every step is a fixed sequence of xor, and,
+ * not and rotate so the timing does not depend on the state
+ */
+static void keccakf(uint64_t *st)
+{
+    uint64_t bc[5], t;
+
+    unsigned int round, i, j;
+
+    for (round = 0; round < 24; round++)
+    {
+        // theta
+        for (i = 0; i < 5; i++)
+        {
+            bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+        }
+
+        for (i = 0; i < 5; i++)
+        {
+            t = bc[(i + 4) % 5] ^ rotl64(bc[(i + 1) % 5], 1);
+
+            for (j = 0; j < 25; j += 5)
+            {
+                st[j + i] ^= t;
+            }
+        }
+
+        // rho and pi
+        t = st[1];
+
+        for (i = 0; i < 24; i++)
+        {
+            j = C_keccak_piln[i];
+
+            bc[0] = st[j];
+
+            st[j] = rotl64(t, C_keccak_rotc[i]);
+
+            t = bc[0];
+        }
+
+        // chi
+        for (j = 0; j < 25; j += 5)
+        {
+            for (i = 0; i < 5; i++)
+            {
+                bc[i] = st[j + i];
+            }
+
+            for (i = 0; i < 5; i++)
+            {
+                st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+            }
+        }
+
+        // iota
+        st[0] ^= C_keccak_rc[round];
+    }
+}
+
+void keccak_short(const unsigned char *in, size_t length, unsigned char *out)
+{
+    uint64_t st[25] = {0};
+
+    // absorb straight into the little endian lanes rather than through a block buffer
+    size_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        st[i / 8] ^= (uint64_t)in[i] << (8 * (i % 8));
+    }
+
+    // original keccak padding, 0x01 after the message and 0x80 in the last byte of the block
+    st[length / 8] ^= (uint64_t)0x01 << (8 * (length % 8));
+
+    st[(KECCAK_RATE - 1) / 8] ^= (uint64_t)0x80 << 56;
+
+    keccakf(st);
+
+    for (i = 0; i < 32; i++)
+    {
+        out[i] = (unsigned char)(st[i / 8] >> (8 * (i % 8)));
+    }
+
+    explicit_bzero(st, sizeof(st));
+}
\ No newline at end of file
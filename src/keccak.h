@@ -0,0 +1,36 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#ifndef KECCAK_H
+#define KECCAK_H
+
+#include <stddef.h>
+
+// the Keccak-256 rate in bytes, one block of input
+#define KECCAK_RATE 136
+
+/**
+ * Keccak-256 (original padding, as used by cn_fast_hash) of an input that fits
+ * in a single block with its padding, that is length < KECCAK_RATE. This is one
+ * permutation on a 200 byte state with no context setup and no syscall, for the
+ * short hashes of derivation to scalar and hash to point
+ * @param in the input
+ * @param length the input length, below KECCAK_RATE
+ * @param out the 32 byte digest
+ */
+void keccak_short(const unsigned char *in, size_t length, unsigned char *out);
+
+#endif // KECCAK_H
\ No newline at end of file
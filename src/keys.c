@@ -16,6 +16,9 @@
 
 #include "keys.h"
 
+#include <nonce_pool.h>
+#include <profile.h>
+
 static const unsigned char W_MAGIC[KEY_SIZE] = {0x54, 0x75, 0x72, 0x74, 0x6c, 0x65, 0x43, 0x6f, 0x69, 0x6e, 0x20,
                                                 0x69, 0x73, 0x20, 0x6e, 0x6f, 0x74, 0x20, 0x61, 0x20, 0x4d, 0x6f,
                                                 0x6e, 0x65, 0x72, 0x6f, 0x20, 0x66, 0x6f, 0x72, 0x6b, 0x21};
@@ -36,8 +39,11 @@ uint16_t reset_keys()
         {
             PRINTF("Resetting keys...\n");
 
+            // nothing generated under the old keys should outlive them
+            nonce_pool_clear();
+
             // Zero out the wallet structure in NVRAM
-            nvm_write((void *)N_turtlecoin_wallet, NULL, sizeof(wallet_t));
+            NVM_WRITE((void *)N_turtlecoin_wallet, NULL, sizeof(wallet_t), PROFILE_NVM_NO_SLOT);
 
             // Then reinitialize the keys
             uint16_t status = init_keys();
@@ -68,6 +74,9 @@ uint16_t init_keys()
      * wallet This limits writes to NVRAM to on first boot OR on key reset only 7
      * writes to NVRAM each time it is used: wipe, private spend, public spend,
      * private view, public view, address, magic
+     *
+     * The magic sits after everything else in the structure, so a record written
+     * by a build with a different layout fails this check and is rebuilt
      */
     if (os_memcmp((void *)N_turtlecoin_wallet->magic, (void *)W_MAGIC, sizeof(W_MAGIC)) != 0)
     {
@@ -78,7 +87,7 @@ uint16_t init_keys()
             TRY
             {
                 // Zero out enough space in NVRAM for the size of our wallet structure
-                nvm_write((void *)N_turtlecoin_wallet, NULL, sizeof(wallet_t));
+                NVM_WRITE((void *)N_turtlecoin_wallet, NULL, sizeof(wallet_t), PROFILE_NVM_NO_SLOT);
 
                 // Retrieve the private spend key for which all things are made
                 if (hw_retrieve_private_spend_key(wallet.spend.private) != 0)
@@ -104,6 +113,14 @@ uint16_t init_keys()
                     THROW(ERR_SECKEY_TO_PUBKEY);
                 }
 
+                // The public keys never change from here on so neither does the address
+                const uint16_t status = generate_public_address(wallet.spend.public, wallet.view.public, wallet.address);
+
+                if (status != OP_OK)
+                {
+                    THROW(status);
+                }
+
                 /**
                  * Write the magic bytes to the structure in RAM so that upon
                  * the next application load we do not have to perform these
@@ -112,7 +129,7 @@ uint16_t init_keys()
                 os_memmove(wallet.magic, W_MAGIC, sizeof(W_MAGIC));
 
                 // write the wallet structure to NVRAM
-                nvm_write((void *)N_turtlecoin_wallet, (void *)&wallet, sizeof(wallet_t));
+                NVM_WRITE((void *)N_turtlecoin_wallet, (void *)&wallet, sizeof(wallet_t), PROFILE_NVM_NO_SLOT);
 
                 CLOSE_TRY;
 
@@ -34,6 +34,8 @@ typedef struct wallet_s
 
     key_pair_t view; // 64-bytes
 
+    unsigned char address[BASE58_ADDRESS_SIZE]; // 99-bytes, Base58 of the public keys
+
     unsigned char magic[KEY_SIZE]; // 32-bytes
 } wallet_t;
 
@@ -49,6 +51,7 @@ extern wallet_t N_state_pic;
 #define PTR_SPEND_PRIVATE ((unsigned char *)N_turtlecoin_wallet->spend.private)
 #define PTR_VIEW_PUBLIC ((unsigned char *)N_turtlecoin_wallet->view.public)
 #define PTR_VIEW_PRIVATE ((unsigned char *)N_turtlecoin_wallet->view.private)
+#define PTR_ADDRESS ((unsigned char *)N_turtlecoin_wallet->address)
 
 uint16_t init_keys();
 
@@ -19,6 +19,11 @@
 #include "apdu.h"
 #include "menu.h"
 
+#include <nonce_pool.h>
+#include <profile.h>
+#include <scratch.h>
+#include <session.h>
+
 unsigned char G_io_seproxyhal_spi_buffer[IO_SEPROXYHAL_BUFFER_SIZE_B];
 
 #define CLA 0xE0
@@ -41,6 +46,8 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
             // Explicitly clear the working memory
             explicit_bzero(WORKING_SET, WORKING_SET_SIZE);
 
+            scratch_reset();
+
             // Explicitly clear any display information
             explicit_bzero(DISPLAY_KEY_HEX, KEY_HEXSTR_SIZE);
 
@@ -51,6 +58,12 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
 
             uint16_t data_length = data_length = readUint16BE((uint8_t *)&G_io_apdu_buffer[OFFSET_LC]);
 
+            // reading the profile should not show up in it
+            if (G_io_apdu_buffer[OFFSET_INS] != APDU_DEBUG)
+            {
+                profile_apdu_begin(G_io_apdu_buffer[OFFSET_INS]);
+            }
+
             switch (G_io_apdu_buffer[OFFSET_INS])
             {
                 case APDU_VERSION:
@@ -58,13 +71,27 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
                     break;
 
                 case APDU_DEBUG:
-                    handle_debug();
+                    handle_debug(G_io_apdu_buffer[OFFSET_P1]);
                     break;
 
                 case APDU_IDENT:
                     handle_ident();
                     break;
 
+                case APDU_SESSION_START:
+                    handle_session_start(
+                        G_io_apdu_buffer[OFFSET_P1],
+                        G_io_apdu_buffer[OFFSET_P2],
+                        G_io_apdu_buffer + OFFSET_CDATA,
+                        data_length,
+                        flags,
+                        tx);
+                    break;
+
+                case APDU_SESSION_END:
+                    handle_session_end();
+                    break;
+
                 case APDU_PUBLIC_KEYS:
                     handle_public_keys(G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2], flags, tx);
                     break;
@@ -115,6 +142,26 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
                         tx);
                     break;
 
+                case APDU_CHECK_KEYS:
+                    handle_check_keys(
+                        G_io_apdu_buffer[OFFSET_P1],
+                        G_io_apdu_buffer[OFFSET_P2],
+                        G_io_apdu_buffer + OFFSET_CDATA,
+                        data_length,
+                        flags,
+                        tx);
+                    break;
+
+                case APDU_CHECK_SCALARS:
+                    handle_check_scalars(
+                        G_io_apdu_buffer[OFFSET_P1],
+                        G_io_apdu_buffer[OFFSET_P2],
+                        G_io_apdu_buffer + OFFSET_CDATA,
+                        data_length,
+                        flags,
+                        tx);
+                    break;
+
                 case APDU_ADDRESS:
                     handle_address(G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2], flags, tx);
                     break;
@@ -189,6 +236,36 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
                         tx);
                     break;
 
+                case APDU_GENERATE_SIGNATURES_START:
+                    handle_generate_signatures_start(
+                        G_io_apdu_buffer[OFFSET_P1],
+                        G_io_apdu_buffer[OFFSET_P2],
+                        G_io_apdu_buffer + OFFSET_CDATA,
+                        data_length,
+                        flags,
+                        tx);
+                    break;
+
+                case APDU_GENERATE_SIGNATURES:
+                    handle_generate_signatures(
+                        G_io_apdu_buffer[OFFSET_P1],
+                        G_io_apdu_buffer[OFFSET_P2],
+                        G_io_apdu_buffer + OFFSET_CDATA,
+                        data_length,
+                        flags,
+                        tx);
+                    break;
+
+                case APDU_CHECK_SIGNATURES:
+                    handle_check_signatures(
+                        G_io_apdu_buffer[OFFSET_P1],
+                        G_io_apdu_buffer[OFFSET_P2],
+                        G_io_apdu_buffer + OFFSET_CDATA,
+                        data_length,
+                        flags,
+                        tx);
+                    break;
+
                 case APDU_GENERATE_KEY_DERIVATION:
                     handle_generate_key_derivation(
                         G_io_apdu_buffer[OFFSET_P1],
@@ -220,7 +297,7 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
                     break;
 
                 case APDU_TX_STATE:
-                    handle_tx_state();
+                    handle_tx_state(G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2], flags, tx);
                     break;
 
                 case APDU_TX_START:
@@ -234,7 +311,7 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
                     break;
 
                 case APDU_TX_START_INPUT_LOAD:
-                    handle_tx_start_input_load(flags);
+                    handle_tx_start_input_load(G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2], flags, tx);
                     break;
 
                 case APDU_TX_LOAD_INPUT:
@@ -248,7 +325,7 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
                     break;
 
                 case APDU_TX_START_OUTPUT_LOAD:
-                    handle_tx_start_output_load(flags);
+                    handle_tx_start_output_load(G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2], flags, tx);
                     break;
 
                 case APDU_TX_LOAD_OUTPUT:
@@ -262,7 +339,7 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
                     break;
 
                 case APDU_TX_FINALIZE_PREFIX:
-                    handle_tx_finalize_prefix(flags);
+                    handle_tx_finalize_prefix(G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2], flags, tx);
                     break;
 
                 case APDU_TX_SIGN:
@@ -283,6 +360,48 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
                     handle_tx_reset(G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2], flags, tx);
                     break;
 
+                case APDU_TX_STREAM_START:
+                    handle_tx_stream_start(G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2], flags, tx);
+                    break;
+
+                case APDU_TX_STREAM_HINT:
+                    handle_tx_stream_hint(
+                        G_io_apdu_buffer[OFFSET_P1],
+                        G_io_apdu_buffer[OFFSET_P2],
+                        G_io_apdu_buffer + OFFSET_CDATA,
+                        data_length,
+                        flags,
+                        tx);
+                    break;
+
+                case APDU_TX_STREAM_PREFIX:
+                    handle_tx_stream_prefix(
+                        G_io_apdu_buffer[OFFSET_P1],
+                        G_io_apdu_buffer[OFFSET_P2],
+                        G_io_apdu_buffer + OFFSET_CDATA,
+                        data_length,
+                        flags,
+                        tx);
+                    break;
+
+                case APDU_TX_VERIFY:
+                    handle_tx_verify(G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2], flags, tx);
+                    break;
+
+                case APDU_TX_SIGN_RING:
+                    handle_tx_sign_ring(
+                        G_io_apdu_buffer[OFFSET_P1],
+                        G_io_apdu_buffer[OFFSET_P2],
+                        G_io_apdu_buffer + OFFSET_CDATA,
+                        data_length,
+                        flags,
+                        tx);
+                    break;
+
+                case APDU_TX_DUMP_STREAM:
+                    handle_tx_dump_stream(G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2], flags, tx);
+                    break;
+
                 case APDU_RESET_KEYS:
                     handle_reset(G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2], flags, tx);
                     break;
@@ -444,6 +563,18 @@ unsigned char io_event(unsigned char channel)
             break;
 
         case SEPROXYHAL_TAG_TICKER_EVENT:
+            session_tick();
+
+            profile_tick();
+
+            tx_sign_ticker();
+
+            // signing has the tick to itself, otherwise top up the nonce pool
+            if (!tx_sign_busy())
+            {
+                nonce_pool_tick();
+            }
+
             UX_TICKER_EVENT(G_io_seproxyhal_spi_buffer, {
 #ifndef TARGET_NANOX
                 if (UX_ALLOWED)
@@ -507,6 +638,8 @@ unsigned short io_exchange_al(unsigned char channel, unsigned short tx_len)
 
 void app_exit(void)
 {
+    nonce_pool_clear();
+
     BEGIN_TRY_L(exit)
     {
         TRY_L(exit)
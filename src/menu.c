@@ -18,12 +18,16 @@
 
 #include "menu.h"
 
+#include <apdu_tx_sign.h>
+#include <nonce_pool.h>
 #include <transaction.h>
 
 #define DISPLAY_ADDRESS WORKING_SET
 
 static void app_kill(void)
 {
+    nonce_pool_clear();
+
     BEGIN_TRY_L(exit)
     {
         TRY_L(exit)
@@ -62,7 +66,7 @@ UX_STEP_VALID(ux_idle_flow_2_step, pnn, ui_display_address(), {&C_icon_turtlecoi
 
 UX_STEP_NOCB(ux_idle_flow_3_step, bn, {"Version", APPVERSION});
 
-UX_STEP_VALID(ux_idle_flow_4_step, pb, os_sched_exit(-1), {&C_icon_dashboard_x, "Quit"});
+UX_STEP_VALID(ux_idle_flow_4_step, pb, app_kill(), {&C_icon_dashboard_x, "Quit"});
 
 UX_FLOW(
     ux_idle_flow,
@@ -84,6 +88,12 @@ void ui_idle()
         ux_stack_push();
     }
 
+    // a transaction awaiting approval (or being signed) takes precedence over the menu
+    if (tx_sign_ui_pending())
+    {
+        return tx_sign_display();
+    }
+
     ux_flow_init(0, ux_idle_flow, NULL);
 }
 
@@ -99,12 +109,7 @@ void ui_splash()
 
 void ui_display_address()
 {
-    if (tx_state() != TX_UNUSED)
-    {
-        return;
-    }
-
-    const uint16_t status = generate_public_address(PTR_SPEND_PUBLIC, PTR_VIEW_PUBLIC, DISPLAY_ADDRESS);
+    os_memmove(DISPLAY_ADDRESS, PTR_ADDRESS, BASE58_ADDRESS_SIZE);
 
     if (G_ux.stack_count == 0)
     {
@@ -0,0 +1,98 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "nonce_pool.h"
+
+#include <hw_crypto.h>
+
+/**
+ * Random nonces and their commitments to the base point, produced ahead of
+ * time on ticker events while the device is otherwise idle (at the menu or
+ * waiting on a confirmation screen) so that signing does not have to pay for
+ * the scalar multiplication. Every entry is used once and wiped as it is taken
+ */
+static nonce_pool_entry_t L_nonce_pool[NONCE_POOL_SIZE];
+
+static uint8_t L_nonce_pool_count = 0;
+
+/**
+ * Wipes every pooled nonce, on exit and whenever the keys are reset
+ */
+void nonce_pool_clear()
+{
+    explicit_bzero(L_nonce_pool, sizeof(L_nonce_pool));
+
+    L_nonce_pool_count = 0;
+}
+
+/**
+ * Returns the number of nonces ready to be taken
+ * @return
+ */
+uint8_t nonce_pool_count()
+{
+    return L_nonce_pool_count;
+}
+
+/**
+ * Takes a random nonce k and its commitment k * G from the pool, or generates
+ * them on the spot if the pool is empty
+ * @param nonce the resulting nonce
+ * @param commitment the resulting commitment
+ * @return
+ */
+uint16_t nonce_pool_take(unsigned char *nonce, unsigned char *commitment)
+{
+    if (L_nonce_pool_count == 0)
+    {
+        return hw_generate_keypair(commitment, nonce);
+    }
+
+    L_nonce_pool_count--;
+
+    nonce_pool_entry_t *entry = &L_nonce_pool[L_nonce_pool_count];
+
+    os_memmove(nonce, entry->nonce, KEY_SIZE);
+
+    os_memmove(commitment, entry->commitment, KEY_SIZE);
+
+    explicit_bzero(entry, sizeof(nonce_pool_entry_t));
+
+    return OP_OK;
+}
+
+/**
+ * Called on ticker events when no signing is under way, adds at most one
+ * entry per tick so that the UI stays responsive
+ */
+void nonce_pool_tick()
+{
+    if (L_nonce_pool_count >= NONCE_POOL_SIZE)
+    {
+        return;
+    }
+
+    nonce_pool_entry_t *entry = &L_nonce_pool[L_nonce_pool_count];
+
+    if (hw_generate_keypair(entry->commitment, entry->nonce) != OP_OK)
+    {
+        explicit_bzero(entry, sizeof(nonce_pool_entry_t));
+
+        return;
+    }
+
+    L_nonce_pool_count++;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#ifndef NONCE_POOL_H
+#define NONCE_POOL_H
+
+#include <common.h>
+
+#ifndef NONCE_POOL_SIZE
+#define NONCE_POOL_SIZE 4 // enough for one ring signature set
+#endif
+
+typedef struct nonce_pool_entry_s // 64-bytes
+{
+    unsigned char nonce[KEY_SIZE]; // 32-bytes, k
+
+    unsigned char commitment[KEY_SIZE]; // 32-bytes, k * G
+} nonce_pool_entry_t;
+
+void nonce_pool_clear();
+
+uint8_t nonce_pool_count();
+
+uint16_t nonce_pool_take(unsigned char *nonce, unsigned char *commitment);
+
+void nonce_pool_tick();
+
+#endif // NONCE_POOL_H
\ No newline at end of file
@@ -0,0 +1,395 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+
+#include "profile.h"
+
+#if PROFILE_BUILD == 1
+
+#include <common.h>
+#include <transaction.h>
+
+static profile_bucket_t L_profile[PROFILE_BUCKETS];
+
+// the bucket of the APDU currently being processed, if any
+static profile_bucket_t *L_profile_current = NULL;
+
+// the NVRAM programmed by the current (or last) APDU
+static nvm_stats_t L_nvm_apdu;
+
+// the NVRAM programmed since the transaction in each slot was started
+static nvm_stats_t L_nvm_tx[TX_SLOT_COUNT];
+
+/**
+ * The page ranges written by the current APDU so that the distinct pages can
+ * be counted; once every range is taken, writes that do not overlap one of them
+ * are counted as distinct and so the count becomes an upper bound
+ */
+static struct
+{
+    uint32_t first[PROFILE_NVM_RANGES];
+
+    uint32_t last[PROFILE_NVM_RANGES];
+
+    uint8_t count;
+
+    uint32_t overflow;
+} L_nvm_ranges;
+
+#ifdef HAVE_BOLOS_APP_STACK_CANARY
+// the bounds of the application stack from the SDK link script, it grows down from _estack towards _stack
+extern unsigned int _stack;
+extern unsigned int _estack;
+
+#define PROFILE_STACK_PAINT 0xA5A5A5A5
+#define PROFILE_STACK_MARGIN 64 // bytes left unpainted below the frame doing the painting
+
+/**
+ * Paints the unused part of the stack so that the deepest use can be found later
+ */
+static void profile_stack_paint()
+{
+    uint32_t *word = (uint32_t *)&_stack;
+
+    const uint32_t *limit = (const uint32_t *)((uintptr_t)&word - PROFILE_STACK_MARGIN);
+
+    while (word < limit)
+    {
+        *word++ = PROFILE_STACK_PAINT;
+    }
+}
+
+/**
+ * Returns the number of bytes of stack used since it was last painted
+ */
+static uint16_t profile_stack_used()
+{
+    const uint32_t *word = (const uint32_t *)&_stack;
+
+    while (word < (const uint32_t *)&_estack && *word == PROFILE_STACK_PAINT)
+    {
+        word++;
+    }
+
+    return (uint16_t)((uintptr_t)&_estack - (uintptr_t)word);
+}
+#else
+#define profile_stack_paint()
+#define profile_stack_used() 0
+#endif
+
+/**
+ * Records the deepest stack use of the current APDU in its bucket
+ */
+static void profile_stack_record()
+{
+    const uint16_t used = profile_stack_used();
+
+    if (L_profile_current != NULL && used > L_profile_current->stack)
+    {
+        L_profile_current->stack = used;
+    }
+}
+
+static void write_uint32(unsigned char *out, const uint32_t value)
+{
+    out[0] = (unsigned char)(value >> 24);
+
+    out[1] = (unsigned char)(value >> 16);
+
+    out[2] = (unsigned char)(value >> 8);
+
+    out[3] = (unsigned char)value;
+}
+
+static uint16_t write_nvm_stats(unsigned char *out, const nvm_stats_t *stats)
+{
+    write_uint32(out, stats->writes);
+
+    write_uint32(out + 4, stats->bytes);
+
+    write_uint32(out + 8, stats->page_programs);
+
+    return PROFILE_NVM_STATS_SIZE;
+}
+
+/**
+ * Adds the page range to those written by the current APDU, merging it with
+ * any range it overlaps or touches
+ */
+static void nvm_ranges_add(uint32_t first, uint32_t last)
+{
+    uint8_t i = 0;
+
+    while (i < L_nvm_ranges.count)
+    {
+        if (first <= L_nvm_ranges.last[i] + 1 && L_nvm_ranges.first[i] <= last + 1)
+        {
+            first = (L_nvm_ranges.first[i] < first) ? L_nvm_ranges.first[i] : first;
+
+            last = (L_nvm_ranges.last[i] > last) ? L_nvm_ranges.last[i] : last;
+
+            // remove the range and merge the result again in case it now reaches another
+            L_nvm_ranges.count--;
+
+            L_nvm_ranges.first[i] = L_nvm_ranges.first[L_nvm_ranges.count];
+
+            L_nvm_ranges.last[i] = L_nvm_ranges.last[L_nvm_ranges.count];
+
+            i = 0;
+
+            continue;
+        }
+
+        i++;
+    }
+
+    if (L_nvm_ranges.count < PROFILE_NVM_RANGES)
+    {
+        L_nvm_ranges.first[L_nvm_ranges.count] = first;
+
+        L_nvm_ranges.last[L_nvm_ranges.count] = last;
+
+        L_nvm_ranges.count++;
+    }
+    else
+    {
+        L_nvm_ranges.overflow += last - first + 1;
+    }
+}
+
+static uint32_t nvm_ranges_pages()
+{
+    uint32_t pages = L_nvm_ranges.overflow;
+
+    uint8_t i;
+
+    for (i = 0; i < L_nvm_ranges.count; i++)
+    {
+        pages += L_nvm_ranges.last[i] - L_nvm_ranges.first[i] + 1;
+    }
+
+    return pages;
+}
+
+/**
+ * Attributes everything that follows to the given INS until the reply is sent
+ * @param ins the INS of the APDU received
+ */
+void profile_apdu_begin(const uint8_t ins)
+{
+    uint8_t i;
+
+    // the previous APDU may have been answered with an exception rather than through sendResponse()
+    profile_stack_record();
+
+    for (i = 0; i < PROFILE_BUCKETS - 1; i++)
+    {
+        if (L_profile[i].apdus == 0 || L_profile[i].ins == ins)
+        {
+            break;
+        }
+    }
+
+    // the last bucket is shared by every INS that did not get one of its own
+    L_profile_current = &L_profile[i];
+
+    L_profile_current->ins = (i == PROFILE_BUCKETS - 1) ? PROFILE_INS_OTHER : ins;
+
+    L_profile_current->apdus++;
+
+    explicit_bzero(&L_nvm_apdu, sizeof(L_nvm_apdu));
+
+    explicit_bzero(&L_nvm_ranges, sizeof(L_nvm_ranges));
+
+    profile_stack_paint();
+}
+
+/**
+ * Called when the reply to the current APDU has been sent
+ */
+void profile_apdu_end()
+{
+    profile_stack_record();
+
+    L_profile_current = NULL;
+}
+
+/**
+ * Serializes the counters as bucket_count {1 byte} followed by, for each bucket,
+ * ins {1 byte} || apdus {4 bytes} || ticks {4 bytes} || stack {2 bytes} || ops {4 bytes each}
+ * @param out the buffer to write to, at least PROFILE_SIZE bytes
+ * @return the number of bytes written
+ */
+uint16_t profile_dump(unsigned char *out)
+{
+    uint16_t pos = 1;
+
+    uint8_t i, j;
+
+    out[0] = 0;
+
+    for (i = 0; i < PROFILE_BUCKETS; i++)
+    {
+        if (L_profile[i].apdus == 0)
+        {
+            continue;
+        }
+
+        out[0]++;
+
+        out[pos++] = L_profile[i].ins;
+
+        write_uint32(out + pos, L_profile[i].apdus);
+
+        pos += 4;
+
+        write_uint32(out + pos, L_profile[i].ticks);
+
+        pos += 4;
+
+        out[pos++] = (unsigned char)(L_profile[i].stack >> 8);
+
+        out[pos++] = (unsigned char)L_profile[i].stack;
+
+        for (j = 0; j < PROFILE_OP_COUNT; j++)
+        {
+            write_uint32(out + pos, L_profile[i].ops[j]);
+
+            pos += 4;
+        }
+    }
+
+    return pos;
+}
+
+/**
+ * Serializes the NVRAM accounting as the last APDU's writes {4 bytes} || bytes {4 bytes}
+ * || page_programs {4 bytes} || distinct_pages {4 bytes}, followed by writes || bytes
+ * || page_programs {12 bytes} for the transaction in each slot
+ * @param out the buffer to write to, at least PROFILE_NVM_SIZE bytes
+ * @return the number of bytes written
+ */
+uint16_t profile_nvm_dump(unsigned char *out)
+{
+    uint16_t pos = write_nvm_stats(out, &L_nvm_apdu);
+
+    write_uint32(out + pos, nvm_ranges_pages());
+
+    pos += 4;
+
+    uint8_t i;
+
+    for (i = 0; i < TX_SLOT_COUNT; i++)
+    {
+        pos += write_nvm_stats(out + pos, &L_nvm_tx[i]);
+    }
+
+    return pos;
+}
+
+/**
+ * Starts the NVRAM accounting of a new transaction in the given slot
+ * @param slot
+ */
+void profile_nvm_tx_begin(const uint8_t slot)
+{
+    if (slot < TX_SLOT_COUNT)
+    {
+        explicit_bzero(&L_nvm_tx[slot], sizeof(nvm_stats_t));
+    }
+}
+
+/**
+ * Writes to NVRAM, accounting for the write against the current APDU and
+ * the transaction in the given slot
+ * @param dst the NVRAM address
+ * @param src the data to write, or NULL to zero it
+ * @param length the number of bytes
+ * @param slot the transaction slot the write belongs to, or PROFILE_NVM_NO_SLOT
+ */
+void profile_nvm_write(void *dst, void *src, const unsigned int length, const uint8_t slot)
+{
+    nvm_write(dst, src, length);
+
+    if (length == 0)
+    {
+        return;
+    }
+
+    const uint32_t first = (uint32_t)((uintptr_t)dst / NVM_PAGE_SIZE);
+
+    const uint32_t last = (uint32_t)(((uintptr_t)dst + length - 1) / NVM_PAGE_SIZE);
+
+    L_nvm_apdu.writes++;
+
+    L_nvm_apdu.bytes += length;
+
+    L_nvm_apdu.page_programs += last - first + 1;
+
+    nvm_ranges_add(first, last);
+
+    if (slot < TX_SLOT_COUNT)
+    {
+        L_nvm_tx[slot].writes++;
+
+        L_nvm_tx[slot].bytes += length;
+
+        L_nvm_tx[slot].page_programs += last - first + 1;
+    }
+}
+
+/**
+ * Counts a call to one of the PROFILE_OP_* primitives
+ * @param op the primitive about to be called
+ */
+void profile_op(const uint8_t op)
+{
+    if (L_profile_current != NULL && op < PROFILE_OP_COUNT)
+    {
+        L_profile_current->ops[op]++;
+    }
+}
+
+/**
+ * Clears all of the counters, including the NVRAM accounting
+ */
+void profile_reset()
+{
+    explicit_bzero(L_profile, sizeof(L_profile));
+
+    L_profile_current = NULL;
+
+    explicit_bzero(&L_nvm_apdu, sizeof(L_nvm_apdu));
+
+    explicit_bzero(L_nvm_tx, sizeof(L_nvm_tx));
+
+    explicit_bzero(&L_nvm_ranges, sizeof(L_nvm_ranges));
+}
+
+/**
+ * Called on every ticker event, signing spreads its work over ticker
+ * events so the ticks elapsed before the reply show where time goes
+ */
+void profile_tick()
+{
+    if (L_profile_current != NULL)
+    {
+        L_profile_current->ticks++;
+    }
+}
+
+#endif // PROFILE_BUILD
\ No newline at end of file
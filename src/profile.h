@@ -0,0 +1,113 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+
+/**
+ * Counting of the expensive cx_* calls made by hw_crypto.c and of the deepest
+ * stack use, bucketed by the top-level APDU that caused them, and of the NVRAM
+ * programmed per APDU and per transaction. Only compiled in with PROFILE=1 and
+ * read or reset through APDU_DEBUG; in all other builds the hooks are empty
+ */
+
+#define PROFILE_OP_SCALAR_MULT 0x00 // cx_ecfp_scalar_mult
+#define PROFILE_OP_DECOMPRESS 0x01 // cx_edward_decompress_point
+#define PROFILE_OP_POWM 0x02 // cx_math_powm
+#define PROFILE_OP_INVPRIMEM 0x03 // cx_math_invprimem
+#define PROFILE_OP_HASH 0x04 // cx_hash
+#define PROFILE_OP_RNG 0x05 // cx_rng
+#define PROFILE_OP_COUNT 6
+
+#define PROFILE_BUCKETS 6
+#define PROFILE_INS_OTHER 0x00 // collects the APDUs that arrive once every bucket is taken
+#define PROFILE_BUCKET_SIZE (1 + 4 + 4 + 2 + (4 * PROFILE_OP_COUNT)) // serialized size
+#define PROFILE_SIZE (1 + (PROFILE_BUCKET_SIZE * PROFILE_BUCKETS))
+
+#ifndef NVM_PAGE_SIZE
+#define NVM_PAGE_SIZE 64 // bytes, the unit in which NVRAM is erased and programmed
+#endif
+
+#define PROFILE_NVM_NO_SLOT 0xFF // writes that do not belong to a transaction (ie. keys)
+#define PROFILE_NVM_RANGES 8 // distinct page ranges tracked per APDU
+#define PROFILE_NVM_STATS_SIZE 12 // serialized size
+#define PROFILE_NVM_SIZE (PROFILE_NVM_STATS_SIZE + 4 + (PROFILE_NVM_STATS_SIZE * TX_SLOT_COUNT))
+
+typedef struct nvm_stats_s // 12-bytes
+{
+    uint32_t writes; // 4-bytes, nvm_write calls
+
+    uint32_t bytes; // 4-bytes
+
+    uint32_t page_programs; // 4-bytes, every page spanned by every write, this is what wears the flash
+} nvm_stats_t;
+
+typedef struct profile_bucket_s // 36-bytes
+{
+    uint32_t apdus; // 4-bytes, the number of APDUs received with this INS
+
+    uint32_t ticks; // 4-bytes, ticker events (100ms) elapsed before those APDUs replied
+
+    uint32_t ops[PROFILE_OP_COUNT]; // 24-bytes
+
+    uint16_t stack; // 2-bytes, the deepest stack use seen by those APDUs (0 if it cannot be measured)
+
+    uint8_t ins; // 1-byte
+
+    uint8_t reserved; // 1-byte
+} profile_bucket_t;
+
+#if PROFILE_BUILD == 1
+
+void profile_apdu_begin(const uint8_t ins);
+
+void profile_apdu_end();
+
+uint16_t profile_dump(unsigned char *out);
+
+uint16_t profile_nvm_dump(unsigned char *out);
+
+void profile_nvm_tx_begin(const uint8_t slot);
+
+void profile_nvm_write(void *dst, void *src, const unsigned int length, const uint8_t slot);
+
+void profile_op(const uint8_t op);
+
+void profile_reset();
+
+void profile_tick();
+
+#define PROFILE_OP(op) profile_op(op)
+
+#define NVM_WRITE(dst, src, length, slot) profile_nvm_write(dst, src, length, slot)
+
+#else
+
+#define profile_apdu_begin(ins)
+#define profile_apdu_end()
+#define profile_nvm_tx_begin(slot)
+#define profile_tick()
+
+#define PROFILE_OP(op)
+
+#define NVM_WRITE(dst, src, length, slot) nvm_write(dst, src, length)
+
+#endif
+
+#endif // PROFILE_H
\ No newline at end of file
@@ -0,0 +1,242 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "sc25519.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define LIMBS 12
+
+#define WIDE_LIMBS (2 * LIMBS)
+
+/**
+ * Loads a 256-bit scalar as 12 limbs, 21 bits each except the last, which
+ * takes the remaining 25 bits
+ */
+static void sc25519_load(int64_t *s, const unsigned char *in)
+{
+    unsigned int i, j;
+
+    for (i = 0; i < LIMBS; i++)
+    {
+        const unsigned int bit = 21 * i;
+
+        const unsigned int width = (i == LIMBS - 1) ? 25 : 21;
+
+        uint32_t value = 0;
+
+        for (j = 0; j < 4 && (bit / 8) + j < 32; j++)
+        {
+            value |= (uint32_t)in[(bit / 8) + j] << (8 * j);
+        }
+
+        s[i] = (value >> (bit % 8)) & ((1u << width) - 1);
+    }
+}
+
+/**
+ * Folds limb i (worth s[i] * 2^(21 * i)) down into limbs i - 12 to i - 7
+ * using 2^252 = -(q - 2^252) mod q
+ */
+static void sc25519_fold(int64_t *s, const unsigned int i)
+{
+    s[i - 12] += s[i] * 666643;
+
+    s[i - 11] += s[i] * 470296;
+
+    s[i - 10] += s[i] * 654183;
+
+    s[i - 9] -= s[i] * 997805;
+
+    s[i - 8] += s[i] * 136657;
+
+    s[i - 7] -= s[i] * 683901;
+
+    s[i] = 0;
+}
+
+/**
+ * Moves the carry of limb i into limb i + 1, rounding to the nearest so
+ * that the limb is left signed, or towards minus infinity so that it is
+ * left in [0, 2^21)
+ */
+static void sc25519_carry(int64_t *s, const unsigned int i, const int round)
+{
+    const int64_t carry = (s[i] + (round ? ((int64_t)1 << 20) : 0)) >> 21;
+
+    s[i + 1] += carry;
+
+    s[i] -= carry * ((int64_t)1 << 21);
+}
+
+/**
+ * Reduces the (signed) value held in 24 limbs mod q, after ref10's
+ * sc_reduce and sc_muladd
+ */
+static void sc25519_reduce(unsigned char *r, int64_t *s)
+{
+    uint64_t acc = 0;
+
+    unsigned int bits = 0, pos = 0;
+
+    int i;
+
+    for (i = 0; i < WIDE_LIMBS - 1; i++)
+    {
+        sc25519_carry(s, i, 1);
+    }
+
+    for (i = WIDE_LIMBS - 1; i >= 18; i--)
+    {
+        sc25519_fold(s, i);
+    }
+
+    for (i = 6; i <= 16; i++)
+    {
+        sc25519_carry(s, i, 1);
+    }
+
+    for (i = 17; i >= 12; i--)
+    {
+        sc25519_fold(s, i);
+    }
+
+    for (i = 0; i < LIMBS; i++)
+    {
+        sc25519_carry(s, i, 1);
+    }
+
+    sc25519_fold(s, 12);
+
+    for (i = 0; i < LIMBS; i++)
+    {
+        sc25519_carry(s, i, 0);
+    }
+
+    sc25519_fold(s, 12);
+
+    for (i = 0; i < LIMBS - 1; i++)
+    {
+        sc25519_carry(s, i, 0);
+    }
+
+    // 12 limbs of 21 bits, the result is below q < 2^253
+    for (i = 0; i < LIMBS; i++)
+    {
+        acc |= (uint64_t)s[i] << bits;
+
+        bits += 21;
+
+        while (bits >= 8)
+        {
+            r[pos++] = (unsigned char)acc;
+
+            acc >>= 8;
+
+            bits -= 8;
+        }
+    }
+
+    r[pos] = (unsigned char)acc;
+}
+
+void sc25519_reduce32(unsigned char *r, const unsigned char *s)
+{
+    int64_t t[WIDE_LIMBS] = {0};
+
+    sc25519_load(t, s);
+
+    sc25519_reduce(r, t);
+}
+
+void sc25519_add(unsigned char *r, const unsigned char *a, const unsigned char *b)
+{
+    int64_t t[WIDE_LIMBS] = {0}, _b[LIMBS];
+
+    unsigned int i;
+
+    sc25519_load(t, a);
+
+    sc25519_load(_b, b);
+
+    for (i = 0; i < LIMBS; i++)
+    {
+        t[i] += _b[i];
+    }
+
+    sc25519_reduce(r, t);
+}
+
+void sc25519_sub(unsigned char *r, const unsigned char *a, const unsigned char *b)
+{
+    int64_t t[WIDE_LIMBS] = {0}, _b[LIMBS];
+
+    unsigned int i;
+
+    sc25519_load(t, a);
+
+    sc25519_load(_b, b);
+
+    for (i = 0; i < LIMBS; i++)
+    {
+        t[i] -= _b[i];
+    }
+
+    sc25519_reduce(r, t);
+}
+
+/**
+ * t = c +/- (a * b) as 24 uncarried limbs
+ */
+static void sc25519_muladd(int64_t *t, const unsigned char *a, const unsigned char *b, const int sign)
+{
+    int64_t _a[LIMBS], _b[LIMBS];
+
+    unsigned int i, j;
+
+    sc25519_load(_a, a);
+
+    sc25519_load(_b, b);
+
+    for (i = 0; i < LIMBS; i++)
+    {
+        for (j = 0; j < LIMBS; j++)
+        {
+            t[i + j] += sign * _a[i] * _b[j];
+        }
+    }
+}
+
+void sc25519_mul(unsigned char *r, const unsigned char *a, const unsigned char *b)
+{
+    int64_t t[WIDE_LIMBS] = {0};
+
+    sc25519_muladd(t, a, b, 1);
+
+    sc25519_reduce(r, t);
+}
+
+void sc25519_mulsub(unsigned char *r, const unsigned char *a, const unsigned char *b, const unsigned char *c)
+{
+    int64_t t[WIDE_LIMBS] = {0};
+
+    sc25519_load(t, c);
+
+    sc25519_muladd(t, a, b, -1);
+
+    sc25519_reduce(r, t);
+}
\ No newline at end of file
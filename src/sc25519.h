@@ -0,0 +1,51 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#ifndef SC25519_H
+#define SC25519_H
+
+/**
+ * Portable arithmetic mod the group order q for the software scalar backend,
+ * on 21-bit limbs as in ref10's sc_muladd. Scalars are 32 little endian
+ * bytes; any 256-bit input is accepted and every result is fully reduced
+ */
+
+/**
+ * r = s mod q
+ */
+void sc25519_reduce32(unsigned char *r, const unsigned char *s);
+
+/**
+ * r = (a + b) mod q
+ */
+void sc25519_add(unsigned char *r, const unsigned char *a, const unsigned char *b);
+
+/**
+ * r = (a - b) mod q
+ */
+void sc25519_sub(unsigned char *r, const unsigned char *a, const unsigned char *b);
+
+/**
+ * r = (a * b) mod q
+ */
+void sc25519_mul(unsigned char *r, const unsigned char *a, const unsigned char *b);
+
+/**
+ * r = (c - (a * b)) mod q
+ */
+void sc25519_mulsub(unsigned char *r, const unsigned char *a, const unsigned char *b, const unsigned char *c);
+
+#endif // SC25519_H
\ No newline at end of file
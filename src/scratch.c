@@ -0,0 +1,152 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "scratch.h"
+
+#define SCRATCH_GUARD 0xA5
+
+static unsigned char L_scratch[SCRATCH_SIZE];
+
+#define SCRATCH L_scratch
+
+// the offset of the first free byte
+static uint16_t L_scratch_top = 0;
+
+// the number of regions currently held
+static uint8_t L_scratch_live = 0;
+
+static uint16_t L_scratch_faults = 0;
+
+/**
+ * Acquires a region of scratch on top of those already held
+ * @param region the region, released with scratch_release()
+ * @param size the number of bytes needed
+ * @return the start of the region, THROWs ERR_SCRATCH if it does not fit
+ */
+unsigned char *scratch_acquire(scratch_t *region, const size_t size)
+{
+    if (size + SCRATCH_GUARD_SIZE > (size_t)(SCRATCH_SIZE - L_scratch_top))
+    {
+        THROW(ERR_SCRATCH);
+    }
+
+    region->ptr = SCRATCH + L_scratch_top;
+
+    region->size = size;
+
+#if DEBUG_BUILD == 1
+    memset(region->ptr + size, SCRATCH_GUARD, SCRATCH_GUARD_SIZE);
+#endif
+
+    L_scratch_top += size + SCRATCH_GUARD_SIZE;
+
+    L_scratch_live++;
+
+    return region->ptr;
+}
+
+/**
+ * Wipes and releases a region. A region released out of order is wiped
+ * straight away but its space is only reclaimed once every region has been
+ * released. A region that was never acquired is ignored so that this can be
+ * called from FINALLY whether or not the acquire happened
+ * @param region
+ */
+void scratch_release(scratch_t *region)
+{
+    if (region->ptr == NULL)
+    {
+        return;
+    }
+
+    unsigned char *end = region->ptr + region->size + SCRATCH_GUARD_SIZE;
+
+#if DEBUG_BUILD == 1
+    unsigned int i;
+
+    for (i = 0; i < SCRATCH_GUARD_SIZE; i++)
+    {
+        if (region->ptr[region->size + i] != SCRATCH_GUARD)
+        {
+            L_scratch_faults++;
+
+            PRINTF("scratch region at %d overrun\n", (int)(region->ptr - SCRATCH));
+
+            break;
+        }
+    }
+
+    if (end != SCRATCH + L_scratch_top)
+    {
+        L_scratch_faults++;
+
+        PRINTF("scratch region at %d released out of order\n", (int)(region->ptr - SCRATCH));
+    }
+#endif
+
+    explicit_bzero(region->ptr, end - region->ptr);
+
+    if (end == SCRATCH + L_scratch_top)
+    {
+        L_scratch_top = region->ptr - SCRATCH;
+    }
+
+    L_scratch_live--;
+
+    if (L_scratch_live == 0)
+    {
+        L_scratch_top = 0;
+    }
+
+    region->ptr = NULL;
+}
+
+/**
+ * Called at the start of every APDU, when no region may be held. Every
+ * region was wiped on its release so the bytes are left alone
+ */
+void scratch_reset()
+{
+#if DEBUG_BUILD == 1
+    if (L_scratch_live != 0)
+    {
+        L_scratch_faults++;
+
+        PRINTF("%d scratch regions leaked\n", (int)L_scratch_live);
+    }
+#endif
+
+    L_scratch_top = 0;
+
+    L_scratch_live = 0;
+}
+
+/**
+ * Returns the number of bytes of scratch currently held
+ */
+uint16_t scratch_in_use()
+{
+    return L_scratch_top;
+}
+
+/**
+ * Returns the number of regions that were overrun, released out of order or
+ * leaked; always zero outside of debug builds
+ */
+uint16_t scratch_faults()
+{
+    return L_scratch_faults;
+}
\ No newline at end of file
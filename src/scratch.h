@@ -0,0 +1,62 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+#include <common.h>
+
+/**
+ * Scratch space for the hw_crypto routines, kept apart from the APDU buffer
+ * so that the ticker can sign while the next APDU is being received.
+ * Regions are acquired and released in LIFO order, so a routine may call
+ * another that takes its own region on top of the caller's, and a release
+ * wipes only the bytes of that region rather than the whole buffer. Debug
+ * builds follow each region with guard bytes and count the regions that
+ * were written past their end or released out of order
+ */
+#if DEBUG_BUILD == 1
+#define SCRATCH_GUARD_SIZE 4
+#else
+#define SCRATCH_GUARD_SIZE 0
+#endif
+
+/**
+ * The deepest nesting is hw_generate_ring_signatures() (2 * KEY_SIZE) calling
+ * hw__prepare_ring_signatures() (KEY_SIZE + SIG_SET_SIZE)
+ */
+#define SCRATCH_SIZE ((3 * KEY_SIZE) + (SIG_SET_SIZE) + (2 * SCRATCH_GUARD_SIZE))
+
+typedef struct scratch_s
+{
+    unsigned char *ptr; // NULL until acquired
+
+    uint16_t size;
+} scratch_t;
+
+#define SCRATCH_INIT {NULL, 0}
+
+unsigned char *scratch_acquire(scratch_t *region, const size_t size);
+
+void scratch_release(scratch_t *region);
+
+void scratch_reset();
+
+uint16_t scratch_in_use();
+
+uint16_t scratch_faults();
+
+#endif // SCRATCH_H
\ No newline at end of file
@@ -0,0 +1,182 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include "session.h"
+
+#include <apdu_tx_sign.h>
+#include <utils.h>
+
+// locally stored state of the user approved session (if any)
+static session_t L_session;
+
+// the progress line displayed while a session is active
+static char L_session_progress[SESSION_PROGRESS_SIZE];
+
+static void do_session_end()
+{
+    session_end();
+
+    ui_idle();
+}
+
+UX_STEP_NOCB(ux_session_flow_1_step, pnn, {&C_icon_turtlecoin, "Session Active", L_session_progress});
+
+UX_STEP_VALID(ux_session_flow_2_step, pb, do_session_end(), {&C_icon_crossmark, "End Session"});
+
+UX_FLOW(ux_session_flow, &ux_session_flow_1_step, &ux_session_flow_2_step, FLOW_LOOP);
+
+/**
+ * Redraws the progress display; if the user has navigated to the
+ * "End Session" step we leave them there and the updated counter is
+ * picked up when they navigate back to the first step
+ */
+static void session_redraw()
+{
+    const ux_flow_step_t *current = ux_flow_get_current();
+
+    L_session.redraw_pending = 0;
+
+    // a transaction awaiting approval (or being signed) keeps the display
+    if (current == &ux_session_flow_2_step || tx_sign_ui_pending())
+    {
+        return;
+    }
+
+    SPRINTF(L_session_progress, "%u requests", (unsigned int)L_session.requests);
+
+    L_session.ticks_since_redraw = 0;
+
+    if (G_ux.stack_count == 0)
+    {
+        ux_stack_push();
+    }
+
+    ux_flow_init(0, ux_session_flow, NULL);
+}
+
+/**
+ * Returns whether a session covering the given scope has been approved
+ * @param scope the scope(s) required
+ * @return
+ */
+bool session_active(const uint8_t scope)
+{
+    return scope != SESSION_SCOPE_NONE && (L_session.scope & scope) == scope;
+}
+
+/**
+ * Runs the handler of a non-confirm APDU. If an approved session covers
+ * the scope, the handler runs (and replies) synchronously without waiting
+ * on a splash screen; otherwise the splash flow is started as before
+ * @param scope the session scope the APDU belongs to
+ * @param flow the splash flow used outside of a session
+ * @param handler the handler the splash flow would call
+ * @param flags the i/o flags of the current APDU
+ */
+void session_dispatch(
+    const uint8_t scope,
+    const ux_flow_step_t *const *flow,
+    void (*handler)(),
+    volatile unsigned int *flags)
+{
+    if (session_active(scope))
+    {
+        handler();
+    }
+    else
+    {
+        ux_flow_init(0, flow, NULL);
+    }
+
+    *flags |= IO_ASYNCH_REPLY;
+}
+
+/**
+ * Ends the current session (if any)
+ */
+void session_end()
+{
+    explicit_bzero(&L_session, sizeof(L_session));
+
+    explicit_bzero(L_session_progress, sizeof(L_session_progress));
+}
+
+/**
+ * Called after every reply sent during a session. The progress display
+ * is redrawn immediately if something else is on screen (ie. a confirmation
+ * flow) and otherwise at most once every SESSION_REDRAW_TICKS ticker events
+ */
+void session_progress()
+{
+    const ux_flow_step_t *current = ux_flow_get_current();
+
+    L_session.requests++;
+
+    if ((current != &ux_session_flow_1_step && current != &ux_session_flow_2_step)
+        || L_session.ticks_since_redraw >= SESSION_REDRAW_TICKS)
+    {
+        session_redraw();
+    }
+    else
+    {
+        L_session.redraw_pending = 1;
+    }
+}
+
+/**
+ * Returns the scope(s) of the current session
+ * @return
+ */
+uint8_t session_scope()
+{
+    return L_session.scope;
+}
+
+/**
+ * Starts a session for the given scope(s); the caller is responsible for
+ * having obtained user approval first
+ * @param scope the scope(s) covered by the session
+ */
+void session_start(const uint8_t scope)
+{
+    session_end();
+
+    L_session.scope = scope & SESSION_SCOPE_ALL;
+
+    L_session.ticks_since_redraw = SESSION_REDRAW_TICKS;
+}
+
+/**
+ * Called on every ticker event to flush a throttled progress redraw
+ */
+void session_tick()
+{
+    if (L_session.scope == SESSION_SCOPE_NONE)
+    {
+        return;
+    }
+
+    if (L_session.ticks_since_redraw < SESSION_REDRAW_TICKS)
+    {
+        L_session.ticks_since_redraw++;
+    }
+
+    if (L_session.redraw_pending == 1 && L_session.ticks_since_redraw >= SESSION_REDRAW_TICKS
+        && ux_flow_get_current() == &ux_session_flow_1_step)
+    {
+        session_redraw();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*****************************************************************************
+ *   (c) 2020 The TurtleCoin Developers
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <common.h>
+#include <stdbool.h>
+
+#define SESSION_SCOPE_NONE 0x00
+#define SESSION_SCOPE_TX 0x01 // transaction construction (tx start, input/output load, prefix, dump)
+#define SESSION_SCOPE_SYNC 0x02 // wallet sync (derivations, key images, key checks)
+#define SESSION_SCOPE_ALL (SESSION_SCOPE_TX | SESSION_SCOPE_SYNC)
+
+#define SESSION_REDRAW_TICKS 5 // ticker events fire every 100ms, so redraw at most twice a second
+#define SESSION_PROGRESS_SIZE 17
+
+typedef struct session_s // 12-bytes
+{
+    uint32_t requests; // 4-bytes
+
+    uint16_t ticks_since_redraw; // 2-bytes
+
+    uint8_t scope; // 1-byte
+
+    uint8_t redraw_pending; // 1-byte
+} session_t;
+
+bool session_active(const uint8_t scope);
+
+void session_dispatch(
+    const uint8_t scope,
+    const ux_flow_step_t *const *flow,
+    void (*handler)(),
+    volatile unsigned int *flags);
+
+void session_end();
+
+void session_progress();
+
+uint8_t session_scope();
+
+void session_start(const uint8_t scope);
+
+void session_tick();
+
+#endif // SESSION_H
\ No newline at end of file
@@ -17,72 +17,366 @@
 #include "transaction.h"
 
 #include <keys.h>
+#include <profile.h>
 #include <varint.h>
 
+// each array starts on an NVRAM page so that the pages a write programs do not depend on what precedes it
+#define NVM_ALIGNED __attribute__((aligned(NVM_PAGE_SIZE)))
+
 #ifdef TARGET_NANOX
-const raw_transaction_t N_state_raw_transaction_pic;
-const tx_pre_signatures_t N_state_pre_signatures_pic;
-const transaction_info_t N_state_transaction_info_pic;
+const raw_transaction_t N_state_raw_transaction_pic[TX_SLOT_COUNT] NVM_ALIGNED;
+const tx_pre_signatures_t N_state_pre_signatures_pic[TX_SLOT_COUNT] NVM_ALIGNED;
+const transaction_info_t N_state_transaction_info_pic[TX_SLOT_COUNT] NVM_ALIGNED;
+const tx_checkpoints_t N_state_checkpoints_pic[TX_SLOT_COUNT] NVM_ALIGNED;
 #else
-raw_transaction_t N_state_raw_transaction_pic;
-tx_pre_signatures_t N_state_pre_signatures_pic;
-transaction_info_t N_state_transaction_info_pic;
+raw_transaction_t N_state_raw_transaction_pic[TX_SLOT_COUNT] NVM_ALIGNED;
+tx_pre_signatures_t N_state_pre_signatures_pic[TX_SLOT_COUNT] NVM_ALIGNED;
+transaction_info_t N_state_transaction_info_pic[TX_SLOT_COUNT] NVM_ALIGNED;
+tx_checkpoints_t N_state_checkpoints_pic[TX_SLOT_COUNT] NVM_ALIGNED;
 #endif
 
-// locally stored meta data about the current transaction construction
-static transaction_t L_transaction;
+// locally stored meta data about the transaction construction in each slot
+static transaction_t L_transactions[TX_SLOT_COUNT];
+
+// the sequence number of the last checkpoint written to NVRAM for each slot
+static uint32_t L_checkpoint_sequence[TX_SLOT_COUNT];
+
+// the slot that all tx_* calls currently operate on
+static uint8_t L_slot;
+
+// bumped whenever the transaction in a slot is reset, so that state kept about it elsewhere can tell it is stale
+static uint16_t L_generation[TX_SLOT_COUNT];
+
+#define TX_RESET()                                                           \
+    NVM_WRITE((void *)N_raw_transaction(L_slot), NULL, TX_MAX_SIZE, L_slot); \
+    L_transactions[L_slot].current_position = 0;
+
+#define TX_WRITE(payload, length)                                                    \
+    NVM_WRITE(                                                                       \
+        (void *)N_raw_transaction(L_slot) + L_transactions[L_slot].current_position, \
+        (void *)&payload,                                                            \
+        length,                                                                      \
+        L_slot);                                                                     \
+    L_transactions[L_slot].current_position += length
+
+#define TX_WRITE_PTR(payload, length)                                                \
+    NVM_WRITE(                                                                       \
+        (void *)N_raw_transaction(L_slot) + L_transactions[L_slot].current_position, \
+        (void *)payload,                                                             \
+        length,                                                                      \
+        L_slot);                                                                     \
+    L_transactions[L_slot].current_position += length
+
+#define PRE_SIG_RESET() NVM_WRITE((void *)N_tx_pre_signatures(L_slot), NULL, sizeof(tx_pre_signatures_t), L_slot)
+
+#define PRE_SIG_WRITE(index, payload) \
+    NVM_WRITE(                        \
+        (void *)&(*N_tx_pre_signatures(L_slot))[index], (void *)&payload, sizeof(transaction_input_t), L_slot)
+
+#define TX_INFO_RESET() NVM_WRITE((void *)N_tx_info(L_slot), NULL, sizeof(transaction_info_t), L_slot)
+
+#define TX_INFO_WRITE(payload) \
+    NVM_WRITE((void *)N_tx_info(L_slot), (void *)&payload, sizeof(transaction_info_t), L_slot)
+
+#define TX_CHECKPOINT_RESET() NVM_WRITE((void *)N_tx_checkpoints(L_slot), NULL, sizeof(tx_checkpoints_t), L_slot)
+
+// the fields of a serialized prefix in the order that tx_stream_prefix() expects them
+#define TX_STREAM_VERSION 0x00
+#define TX_STREAM_UNLOCK_TIME 0x01
+#define TX_STREAM_INPUT_COUNT 0x02
+#define TX_STREAM_INPUT_TYPE 0x03
+#define TX_STREAM_INPUT_AMOUNT 0x04
+#define TX_STREAM_INPUT_OFFSET_COUNT 0x05
+#define TX_STREAM_INPUT_OFFSETS 0x06
+#define TX_STREAM_INPUT_KEY_IMAGE 0x07
+#define TX_STREAM_OUTPUT_COUNT 0x08
+#define TX_STREAM_OUTPUT_AMOUNT 0x09
+#define TX_STREAM_OUTPUT_TYPE 0x0a
+#define TX_STREAM_OUTPUT_KEY 0x0b
+#define TX_STREAM_EXTRA_SIZE 0x0c
+#define TX_STREAM_EXTRA 0x0d
+#define TX_STREAM_DONE 0x0e
+
+#define TX_INPUT_TYPE_KEY 0x02
+#define TX_OUTPUT_TYPE_KEY 0x02
+
+/**
+ * FNV-1a over the checkpoint excluding the checksum itself, this only needs
+ * to detect a checkpoint write that did not complete
+ */
+static uint32_t tx_checkpoint_checksum(const transaction_checkpoint_t *checkpoint)
+{
+    const unsigned char *data = (const unsigned char *)checkpoint;
+
+    uint32_t hash = 0x811c9dc5;
+
+    unsigned int i;
+
+    for (i = 0; i < offsetof(transaction_checkpoint_t, checksum); i++)
+    {
+        hash ^= data[i];
+
+        hash *= 0x01000193;
+    }
+
+    return hash;
+}
+
+/**
+ * Saves the transaction metadata to NVRAM. This is always called after the
+ * transaction data it describes has been written so that a restored
+ * checkpoint never refers to data that is not there yet
+ */
+static void tx_checkpoint()
+{
+    transaction_checkpoint_t checkpoint;
 
-#define TX_RESET()                                           \
-    nvm_write((void *)N_raw_transaction, NULL, TX_MAX_SIZE); \
-    L_transaction.current_position = 0;
+    explicit_bzero(&checkpoint, sizeof(checkpoint));
 
-#define TX_WRITE(payload, length)                                                                    \
-    nvm_write((void *)N_raw_transaction + L_transaction.current_position, (void *)&payload, length); \
-    L_transaction.current_position += length
+    os_memmove(&checkpoint.transaction, &L_transactions[L_slot], sizeof(transaction_t));
 
-#define TX_WRITE_PTR(payload, length)                                                               \
-    nvm_write((void *)N_raw_transaction + L_transaction.current_position, (void *)payload, length); \
-    L_transaction.current_position += length
+    checkpoint.sequence = L_checkpoint_sequence[L_slot] + 1;
 
-#define PRE_SIG_RESET() nvm_write((void *)N_tx_pre_signatures, NULL, sizeof(tx_pre_signatures_t))
+    checkpoint.checksum = tx_checkpoint_checksum(&checkpoint);
 
-#define PRE_SIG_WRITE(payload)                                           \
-    nvm_write(                                                           \
-        (void *)N_tx_pre_signatures[L_transaction.received_input_count], \
-        (void *)&payload,                                                \
-        sizeof(transaction_input_t))
+    NVM_WRITE(
+        (void *)&(*N_tx_checkpoints(L_slot))[checkpoint.sequence % TX_CHECKPOINT_COPIES],
+        (void *)&checkpoint,
+        sizeof(transaction_checkpoint_t),
+        L_slot);
 
-#define TX_INFO_RESET() nvm_write((void *)N_tx_info, NULL, sizeof(transaction_info_t))
+    L_checkpoint_sequence[L_slot] = checkpoint.sequence;
 
-#define TX_INFO_WRITE(payload) nvm_write((void *)N_tx_info, (void *)&payload, sizeof(transaction_info_t))
+    explicit_bzero(&checkpoint, sizeof(checkpoint));
+}
 
 /**
- * Initializes our internal transaction structure that holds
- * some basic values that are used to navigate our transaction
- * state while it is in memory somewhere
+ * Restores the transaction metadata from the newest valid checkpoint in NVRAM
+ * @return OP_OK if a checkpoint was restored
+ */
+static uint16_t tx_restore_checkpoint()
+{
+    int newest = -1;
+
+    int i;
+
+    for (i = 0; i < TX_CHECKPOINT_COPIES; i++)
+    {
+        const transaction_checkpoint_t *checkpoint = (const transaction_checkpoint_t *)&(*N_tx_checkpoints(L_slot))[i];
+
+        if (checkpoint->sequence == 0 || checkpoint->checksum != tx_checkpoint_checksum(checkpoint))
+        {
+            continue;
+        }
+
+        if (newest == -1 || checkpoint->sequence > (*N_tx_checkpoints(L_slot))[newest].sequence)
+        {
+            newest = i;
+        }
+    }
+
+    if (newest == -1)
+    {
+        return OP_NOK;
+    }
+
+    os_memmove(
+        &L_transactions[L_slot], (const void *)&(*N_tx_checkpoints(L_slot))[newest].transaction, sizeof(transaction_t));
+
+    L_checkpoint_sequence[L_slot] = (*N_tx_checkpoints(L_slot))[newest].sequence;
+
+    return OP_OK;
+}
+
+/**
+ * Derives the private ephemeral and key image of an input after checking
+ * that the output in the real position of the ring belongs to us
+ * @param tx_input the structure to fill, its public keys double as scratch space unless TX_COMPACT_PRESIG is set
+ * @param tx_public_key
+ * @param output_index
+ * @param public_keys
+ * @param real_output_index
  * @return
  */
-uint16_t init_tx()
+static uint16_t tx_derive_input(
+    transaction_input_t *tx_input,
+    const unsigned char *tx_public_key,
+    const uint8_t output_index,
+    const unsigned char *public_keys,
+    const uint8_t real_output_index)
+{
+#if TX_COMPACT_PRESIG == 1
+    // the compact structure has no room to spare for these
+    unsigned char derivation[KEY_SIZE * 3];
+
+#define DERIVATION derivation
+#else
+// we are shadowing these into the tx_input structure to save memory
+#define DERIVATION (unsigned char *)tx_input->public_keys
+#endif
+#define PUBLIC_EPHEMERAL DERIVATION + KEY_SIZE
+#define PUBLIC_EPHEMERAL2 PUBLIC_EPHEMERAL + KEY_SIZE
+
+    if (real_output_index >= RING_PARTICIPANTS)
+    {
+        return ERR_OUT_OF_RANGE;
+    }
+
+    // generate the key derivation using our private view key and the transaction public key
+    uint16_t status = hw_generate_key_derivation(DERIVATION, tx_public_key, PTR_VIEW_PRIVATE);
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+
+    // derive the public ephemeral
+    status = hw_derive_public_key(PUBLIC_EPHEMERAL, DERIVATION, output_index, PTR_SPEND_PUBLIC);
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+
+    // check to make sure that the calculated output key is in the position specified
+    if (os_memcmp(PUBLIC_EPHEMERAL, public_keys + (real_output_index * KEY_SIZE), KEY_SIZE) != 0)
+    {
+        return ERR_PUBKEY_MISMATCH;
+    }
+
+    // derive the private ephemeral
+    status = hw_derive_secret_key(tx_input->private_ephemeral, DERIVATION, output_index, PTR_SPEND_PRIVATE);
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+
+    // calculate the public key of the private ephemeral for matching down below
+    status = hw_private_key_to_public_key(PUBLIC_EPHEMERAL2, tx_input->private_ephemeral);
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+
+    // compare the derived public ephemeral against the one calculated by the private ephemeral
+    if (os_memcmp(PUBLIC_EPHEMERAL, PUBLIC_EPHEMERAL2, KEY_SIZE) != 0)
+    {
+        return ERR_PUBKEY_MISMATCH;
+    }
+
+    // generate the input key image using the public ephemeral and private ephemeral
+    status = hw__generate_key_image(tx_input->key_image, PUBLIC_EPHEMERAL, tx_input->private_ephemeral);
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+
+#undef PUBLIC_EPHEMERAL2
+#undef PUBLIC_EPHEMERAL
+#undef DERIVATION
+
+#if TX_COMPACT_PRESIG == 1
+    explicit_bzero(derivation, sizeof(derivation));
+
+    // the host supplies the ring again when the signatures are generated, it is checked against this
+    status = hw_keccak(public_keys, RING_PARTICIPANTS * KEY_SIZE, tx_input->ring_hash);
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+#else
+    // the ring is needed again when the signatures are generated
+    os_memmove(tx_input->public_keys, public_keys, RING_PARTICIPANTS * KEY_SIZE);
+#endif
+
+    tx_input->real_output_index = real_output_index;
+
+    return OP_OK;
+}
+
+/**
+ * Feeds one byte of a varint in the streamed prefix to the parser,
+ * the decoded value is only available once its last byte has been fed
+ * @param byte
+ * @param value where the decoded value is placed
+ * @return whether the varint is complete
+ */
+static bool tx_stream_varint(const unsigned char byte, uint64_t *value)
+{
+    tx_stream_t *stream = &L_transactions[L_slot].stream;
+
+    // a uint64_t fits in 10 bytes and the 10th byte only carries a single bit
+    if (stream->shift > 63 || (stream->shift == 63 && (byte & 0x7e) != 0))
+    {
+        THROW(ERR_VARINT_DATA_RANGE);
+    }
+
+    stream->value |= ((uint64_t)(byte & 0x7f)) << stream->shift;
+
+    if ((byte & 0x80) != 0)
+    {
+        stream->shift += 7;
+
+        return false;
+    }
+
+    *value = stream->value;
+
+    stream->value = 0;
+
+    stream->shift = 0;
+
+    return true;
+}
+
+/**
+ * Initializes the internal transaction structure of the selected slot,
+ * restoring it from its checkpoint if a transaction was under
+ * construction in that slot when the application last exited
+ * @return
+ */
+static uint16_t tx_init_slot()
 {
     BEGIN_TRY
     {
         TRY
         {
-            L_transaction.total_input_amount = 0;
+            if (tx_restore_checkpoint() == OP_OK)
+            {
+                CLOSE_TRY;
+
+                return OP_OK;
+            }
+
+            L_checkpoint_sequence[L_slot] = 0;
+
+            L_transactions[L_slot].current_position = 0;
+
+            L_transactions[L_slot].total_input_amount = 0;
+
+            L_transactions[L_slot].total_output_amount = 0;
 
-            L_transaction.total_output_amount = 0;
+            L_transactions[L_slot].has_payment_id = 0;
 
-            L_transaction.has_payment_id = 0;
+            L_transactions[L_slot].input_count = 0;
 
-            L_transaction.input_count = 0;
+            L_transactions[L_slot].received_input_count = 0;
 
-            L_transaction.received_input_count = 0;
+            L_transactions[L_slot].output_count = 0;
 
-            L_transaction.output_count = 0;
+            L_transactions[L_slot].received_output_count = 0;
 
-            L_transaction.received_output_count = 0;
+            L_transactions[L_slot].signed_input_count = 0;
 
-            L_transaction.state = TX_UNUSED;
+            explicit_bzero(L_transactions[L_slot].prefix_hash, KEY_SIZE);
+
+            explicit_bzero(&L_transactions[L_slot].stream, sizeof(tx_stream_t));
+
+            L_transactions[L_slot].state = TX_UNUSED;
 
             CLOSE_TRY;
 
@@ -97,6 +391,35 @@ uint16_t init_tx()
     END_TRY;
 }
 
+/**
+ * Initializes our internal transaction structures that hold
+ * some basic values that are used to navigate our transaction
+ * state while it is in memory somewhere. If a transaction was
+ * under construction in any slot when the application last exited,
+ * it is restored from its checkpoint and construction continues from there
+ * @return
+ */
+uint16_t init_tx()
+{
+    uint8_t slot;
+
+    for (slot = 0; slot < TX_SLOT_COUNT; slot++)
+    {
+        L_slot = slot;
+
+        if (tx_init_slot() != OP_OK)
+        {
+            L_slot = 0;
+
+            return ERR_TX_INIT;
+        }
+    }
+
+    L_slot = 0;
+
+    return OP_OK;
+}
+
 /**
  * Dumps the raw transaction to the given unsigned character array
  * @param out the pointer to dump to
@@ -108,7 +431,7 @@ uint16_t tx_dump(unsigned char *out, const uint16_t start_offset, const uint16_t
     {
         TRY
         {
-            os_memmove(out, (unsigned char *)N_raw_transaction + start_offset, length);
+            os_memmove(out, (unsigned char *)N_raw_transaction(L_slot) + start_offset, length);
 
             CLOSE_TRY;
 
@@ -160,7 +483,7 @@ uint16_t tx_finalize_prefix()
             {
                 unsigned int extra_size = TX_EXTRA_TAG_SIZE + KEY_SIZE; // include the public key at minimum
 
-                if (L_transaction.has_payment_id == 1)
+                if (L_transactions[L_slot].has_payment_id == 1)
                 {
                     // nonce_tag + size + paymentid_tag + key
                     extra_size += TX_EXTRA_TAG_SIZE + TX_EXTRA_TAG_SIZE + TX_EXTRA_TAG_SIZE + KEY_SIZE;
@@ -177,12 +500,12 @@ uint16_t tx_finalize_prefix()
 
                 pos += TX_EXTRA_TAG_SIZE;
 
-                os_memmove(extra + pos, N_tx_info->tx_public_key, KEY_SIZE);
+                os_memmove(extra + pos, N_tx_info(L_slot)->tx_public_key, KEY_SIZE);
 
                 pos += KEY_SIZE;
             }
 
-            if (L_transaction.has_payment_id == 1)
+            if (L_transactions[L_slot].has_payment_id == 1)
             {
                 // write the nonce tag to extra
                 {
@@ -206,7 +529,7 @@ uint16_t tx_finalize_prefix()
 
                     pos += TX_EXTRA_TAG_SIZE;
 
-                    os_memmove(extra + pos, N_tx_info->payment_id, KEY_SIZE);
+                    os_memmove(extra + pos, N_tx_info(L_slot)->payment_id, KEY_SIZE);
 
                     pos += KEY_SIZE;
                 }
@@ -215,7 +538,9 @@ uint16_t tx_finalize_prefix()
             // batch write to NVRAM
             TX_WRITE(extra, pos);
 
-            L_transaction.state = TX_PREFIX_READY;
+            L_transactions[L_slot].state = TX_PREFIX_READY;
+
+            tx_checkpoint();
 
             CLOSE_TRY;
 
@@ -233,12 +558,22 @@ uint16_t tx_finalize_prefix()
     END_TRY;
 }
 
+/**
+ * Returns the generation of the transaction in the selected slot, which
+ * changes every time the slot is reset (and thus when a new transaction is
+ * started in it)
+ */
+uint16_t tx_generation()
+{
+    return L_generation[L_slot];
+}
+
 /**
  * Returns if the transaction uses a payment id
  */
 unsigned int tx_has_payment_id()
 {
-    return (unsigned int)L_transaction.has_payment_id;
+    return (unsigned int)L_transactions[L_slot].has_payment_id;
 }
 
 /**
@@ -251,7 +586,8 @@ uint16_t tx_hash(unsigned char *hash)
     {
         TRY
         {
-            const uint16_t status = hw_keccak((unsigned char *)N_raw_transaction, L_transaction.current_position, hash);
+            const uint16_t status =
+                hw_keccak((unsigned char *)N_raw_transaction(L_slot), L_transactions[L_slot].current_position, hash);
 
             if (status != OP_OK)
             {
@@ -276,7 +612,41 @@ uint16_t tx_hash(unsigned char *hash)
  */
 uint64_t tx_input_amount()
 {
-    return L_transaction.total_input_amount;
+    return L_transactions[L_slot].total_input_amount;
+}
+
+/**
+ * Returns whether a transaction is under construction in any slot
+ */
+bool tx_in_progress()
+{
+    uint8_t slot;
+
+    for (slot = 0; slot < TX_SLOT_COUNT; slot++)
+    {
+        if (L_transactions[slot].state != TX_UNUSED)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Returns the number of inputs the transaction was started with
+ */
+uint8_t tx_input_count()
+{
+    return L_transactions[L_slot].input_count;
+}
+
+/**
+ * Returns the number of inputs loaded so far
+ */
+uint8_t tx_received_input_count()
+{
+    return L_transactions[L_slot].received_input_count;
 }
 
 /**
@@ -306,67 +676,14 @@ uint16_t tx_load_input(
 
     transaction_input_t tx_input; // 193-bytes
 
-// we are shadowing these into the tx_input structure to save memory
-#define DERIVATION (unsigned char *)&tx_input.public_keys
-#define PUBLIC_EPHEMERAL DERIVATION + KEY_SIZE
-#define PUBLIC_EPHEMERAL2 PUBLIC_EPHEMERAL + KEY_SIZE
-
     BEGIN_TRY
     {
         TRY
         {
             unsigned int pos = 0;
 
-            // generate the key derivation using our private view key and the transaction public key
-            uint16_t status = hw_generate_key_derivation(DERIVATION, tx_public_key, PTR_VIEW_PRIVATE);
-
-            if (status != OP_OK)
-            {
-                THROW(status);
-            }
-
-            // derive the public ephemeral
-            status = hw_derive_public_key(PUBLIC_EPHEMERAL, DERIVATION, output_index, PTR_SPEND_PUBLIC);
-
-            if (status != OP_OK)
-            {
-                THROW(status);
-            }
-
-            // check to make sure that the calculated output key is in the position specified
-            status = os_memcmp(PUBLIC_EPHEMERAL, public_keys + (real_output_index * KEY_SIZE), KEY_SIZE);
-
-            if (status != OP_OK)
-            {
-                THROW(status);
-            }
-
-            // derive the private ephemeral
-            status = hw_derive_secret_key(tx_input.private_ephemeral, DERIVATION, output_index, PTR_SPEND_PRIVATE);
-
-            if (status != OP_OK)
-            {
-                THROW(status);
-            }
-
-            // calculate the public key of the private ephemeral for matching down below
-            status = hw_private_key_to_public_key(PUBLIC_EPHEMERAL2, tx_input.private_ephemeral);
-
-            if (status != OP_OK)
-            {
-                THROW(status);
-            }
-
-            // compare the derived public ephemeral against the one calculated by the private ephemeral
-            status = os_memcmp(PUBLIC_EPHEMERAL, PUBLIC_EPHEMERAL2, KEY_SIZE);
-
-            if (status != OP_OK)
-            {
-                THROW(status);
-            }
-
-            // generate the input key image using the public ephemeral and private ephemeral
-            status = hw__generate_key_image(tx_input.key_image, PUBLIC_EPHEMERAL, tx_input.private_ephemeral);
+            const uint16_t status =
+                tx_derive_input(&tx_input, tx_public_key, output_index, public_keys, real_output_index);
 
             if (status != OP_OK)
             {
@@ -387,13 +704,13 @@ uint16_t tx_load_input(
                 pos += encode_varint(tx + pos, amount, sizeof(tx));
             }
 
-            L_transaction.total_input_amount += amount;
+            L_transactions[L_slot].total_input_amount += amount;
 
             // write number of global index offsets to the transaction prefix
             {
                 unsigned char offset_length = RING_PARTICIPANTS;
 
-                os_memmove(tx + pos, &offset_length, sizeof(tx));
+                os_memmove(tx + pos, &offset_length, TX_EXTRA_TAG_SIZE);
 
                 pos += TX_EXTRA_TAG_SIZE;
             }
@@ -425,21 +742,19 @@ uint16_t tx_load_input(
              * later when we need them as we need to limit RAM usage
              */
             {
-                os_memmove(tx_input.public_keys, public_keys, RING_PARTICIPANTS * KEY_SIZE);
-
-                tx_input.real_output_index = real_output_index;
-
-                PRE_SIG_WRITE(tx_input);
+                PRE_SIG_WRITE(L_transactions[L_slot].received_input_count, tx_input);
             }
 
-            L_transaction.received_input_count++;
+            L_transactions[L_slot].received_input_count++;
 
             // if we've now received all of the inputs that we expected, change the transaction state
-            if (L_transaction.received_input_count == L_transaction.input_count)
+            if (L_transactions[L_slot].received_input_count == L_transactions[L_slot].input_count)
             {
-                L_transaction.state = TX_INPUTS_RECEIVED;
+                L_transactions[L_slot].state = TX_INPUTS_RECEIVED;
             }
 
+            tx_checkpoint();
+
             CLOSE_TRY;
 
             return OP_OK;
@@ -450,8 +765,6 @@ uint16_t tx_load_input(
         }
         FINALLY
         {
-#undef PUBLIC_EPHEMERAL
-#undef DERIVATION
             explicit_bzero((void *)&tx_input, sizeof(transaction_input_t));
 
             explicit_bzero(tx, sizeof(tx));
@@ -504,16 +817,18 @@ uint16_t tx_load_output(const uint64_t amount, const unsigned char *key)
             // batch write to NVRAM
             TX_WRITE(tx, pos);
 
-            L_transaction.total_output_amount += amount;
+            L_transactions[L_slot].total_output_amount += amount;
 
-            L_transaction.received_output_count++;
+            L_transactions[L_slot].received_output_count++;
 
             // if we have now received all of the outputs that we were expecting update the transaction state
-            if (L_transaction.received_output_count == L_transaction.output_count)
+            if (L_transactions[L_slot].received_output_count == L_transactions[L_slot].output_count)
             {
-                L_transaction.state = TX_OUTPUTS_RECEIVED;
+                L_transactions[L_slot].state = TX_OUTPUTS_RECEIVED;
             }
 
+            tx_checkpoint();
+
             CLOSE_TRY;
 
             return OP_OK;
@@ -535,7 +850,23 @@ uint16_t tx_load_output(const uint64_t amount, const unsigned char *key)
  */
 uint64_t tx_output_amount()
 {
-    return L_transaction.total_output_amount;
+    return L_transactions[L_slot].total_output_amount;
+}
+
+/**
+ * Returns the number of outputs the transaction was started with
+ */
+uint8_t tx_output_count()
+{
+    return L_transactions[L_slot].output_count;
+}
+
+/**
+ * Returns the number of outputs loaded so far
+ */
+uint8_t tx_received_output_count()
+{
+    return L_transactions[L_slot].received_output_count;
 }
 
 /**
@@ -543,7 +874,7 @@ uint64_t tx_output_amount()
  */
 void tx_payment_id(unsigned char *payment_id)
 {
-    os_memmove(payment_id, N_tx_info->payment_id, KEY_SIZE);
+    os_memmove(payment_id, N_tx_info(L_slot)->payment_id, KEY_SIZE);
 }
 
 /**
@@ -551,6 +882,8 @@ void tx_payment_id(unsigned char *payment_id)
  */
 uint16_t tx_reset()
 {
+    L_generation[L_slot]++;
+
     BEGIN_TRY
     {
         TRY
@@ -561,7 +894,9 @@ uint16_t tx_reset()
 
             TX_INFO_RESET();
 
-            if (init_tx() != 0)
+            TX_CHECKPOINT_RESET();
+
+            if (tx_init_slot() != 0)
             {
                 THROW(ERR_TX_RESET);
             }
@@ -581,56 +916,56 @@ uint16_t tx_reset()
 
 /**
  * Completes the ring signatures for the transaction currently in memory
+ * in one pass; resumes from the last signed input if signing was started
  */
 uint16_t tx_sign()
 {
-    if (tx_state() != TX_PREFIX_READY)
+    uint16_t status = OP_OK;
+
+    if (tx_state() == TX_PREFIX_READY || tx_state() == TX_PRESIGNING)
+    {
+        status = tx_sign_begin();
+    }
+    else if (tx_state() != TX_SIGNING)
     {
         return ERR_TRANSACTION_STATE;
     }
 
-#define SIGNATURES WORKING_SET
-#define PREFIX_HASH SIGNATURES + (SIG_SIZE * RING_PARTICIPANTS)
+    while (status == OP_OK && tx_state() == TX_SIGNING)
+    {
+        status = tx_sign_step();
+    }
+
+    return status;
+}
 
+/**
+ * Calculates the transaction prefix hash that all of the ring signatures are
+ * made over and moves the transaction into the given signing state
+ * @param state TX_SIGNING or TX_PRESIGNING
+ */
+static uint16_t tx_sign_prepare(const uint8_t state)
+{
     BEGIN_TRY
     {
         TRY
         {
-            // calculate the transaction prefix hash and hold it for later
-            uint16_t status =
-                hw_keccak((unsigned char *)N_raw_transaction, L_transaction.current_position, PREFIX_HASH);
+            // calculate the transaction prefix hash and hold it until all of the inputs are signed
+            const uint16_t status = hw_keccak(
+                (unsigned char *)N_raw_transaction(L_slot),
+                L_transactions[L_slot].current_position,
+                L_transactions[L_slot].prefix_hash);
 
             if (status != OP_OK)
             {
                 THROW(status);
             }
 
-            int i;
-            for (i = 0; i < L_transaction.input_count; i++)
-            {
-                status = hw__generate_ring_signatures(
-                    SIGNATURES,
-                    PREFIX_HASH,
-                    N_tx_pre_signatures[i]->key_image,
-                    N_tx_pre_signatures[i]->public_keys,
-                    N_tx_pre_signatures[i]->private_ephemeral,
-                    N_tx_pre_signatures[i]->real_output_index);
-
-                if (status != OP_OK)
-                {
-                    THROW(status);
-                }
+            L_transactions[L_slot].signed_input_count = 0;
 
-                /**
-                 * Normally, we'd try to batch the write to NVRAM but due to memory constraints
-                 * and the fact that each signature set is 256-bytes, we need to commit the
-                 * signatures to NVRAM during each pass of the loop as there can be 90 inputs
-                 * processed and 90 * 256 = 23,040 bytes -- too many
-                 */
-                TX_WRITE_PTR(SIGNATURES, SIG_SIZE * RING_PARTICIPANTS);
-            }
+            L_transactions[L_slot].state = state;
 
-            L_transaction.state = TX_COMPLETE;
+            tx_checkpoint();
 
             CLOSE_TRY;
 
@@ -638,24 +973,326 @@ uint16_t tx_sign()
         }
         CATCH_OTHER(e)
         {
+            explicit_bzero(L_transactions[L_slot].prefix_hash, KEY_SIZE);
+
             return e;
         }
-        FINALLY
-        {
-#undef PREFIX_HASH
-#undef SIGNATURES
-            explicit_bzero(WORKING_SET, WORKING_SET_SIZE);
-        }
+        FINALLY {}
     }
     END_TRY;
 }
 
 /**
- * Returns the current size of the transaction in memory
+ * Starts generating the ring signatures of the transaction currently in memory
+ * while its approval is still pending. tx_sign_step() signs in this state as
+ * usual but the transaction cannot complete, and so cannot be dumped, until
+ * tx_sign_begin() records the approval
+ */
+uint16_t tx_presign_begin()
+{
+    // without the rings there is nothing to sign until the host supplies them after the approval
+    if (TX_COMPACT_PRESIG == 1)
+    {
+        return ERR_OP_NOT_PERMITTED;
+    }
+    else if (tx_state() != TX_PREFIX_READY)
+    {
+        return ERR_TRANSACTION_STATE;
+    }
+
+    return tx_sign_prepare(TX_PRESIGNING);
+}
+
+/**
+ * Throws away the ring signatures generated ahead of an approval that was
+ * refused, wiping them from NVRAM, and returns the transaction to
+ * TX_PREFIX_READY
+ */
+uint16_t tx_presign_abort()
+{
+    if (tx_state() != TX_PRESIGNING)
+    {
+        return ERR_TRANSACTION_STATE;
+    }
+
+    transaction_t previous;
+
+    os_memmove(&previous, &L_transactions[L_slot], sizeof(transaction_t));
+
+    BEGIN_TRY
+    {
+        TRY
+        {
+            const uint16_t length = L_transactions[L_slot].signed_input_count * SIG_SIZE * RING_PARTICIPANTS;
+
+            L_transactions[L_slot].current_position -= length;
+
+            L_transactions[L_slot].signed_input_count = 0;
+
+            explicit_bzero(L_transactions[L_slot].prefix_hash, KEY_SIZE);
+
+            L_transactions[L_slot].state = TX_PREFIX_READY;
+
+            // checkpoint first so that an interrupted wipe never leaves a checkpoint pointing at wiped signatures
+            tx_checkpoint();
+
+            if (length != 0)
+            {
+                NVM_WRITE(
+                    (void *)N_raw_transaction(L_slot) + L_transactions[L_slot].current_position, NULL, length, L_slot);
+            }
+
+            CLOSE_TRY;
+
+            return OP_OK;
+        }
+        CATCH_OTHER(e)
+        {
+            os_memmove(&L_transactions[L_slot], &previous, sizeof(transaction_t));
+
+            return e;
+        }
+        FINALLY
+        {
+            explicit_bzero(&previous, sizeof(transaction_t));
+        }
+    }
+    END_TRY;
+}
+
+/**
+ * Starts the signing of the transaction currently in memory once it has been
+ * approved. Signatures already generated ahead of the approval are kept, so
+ * if every input was presigned the transaction is complete straight away
+ */
+uint16_t tx_sign_begin()
+{
+    if (tx_state() == TX_PREFIX_READY)
+    {
+        return tx_sign_prepare(TX_SIGNING);
+    }
+    else if (tx_state() != TX_PRESIGNING)
+    {
+        return ERR_TRANSACTION_STATE;
+    }
+
+    BEGIN_TRY
+    {
+        TRY
+        {
+            if (L_transactions[L_slot].signed_input_count == L_transactions[L_slot].input_count)
+            {
+                explicit_bzero(L_transactions[L_slot].prefix_hash, KEY_SIZE);
+
+                L_transactions[L_slot].state = TX_COMPLETE;
+            }
+            else
+            {
+                L_transactions[L_slot].state = TX_SIGNING;
+            }
+
+            tx_checkpoint();
+
+            CLOSE_TRY;
+
+            return OP_OK;
+        }
+        CATCH_OTHER(e)
+        {
+            return e;
+        }
+        FINALLY {}
+    }
+    END_TRY;
+}
+
+/**
+ * Generates the ring signatures for the next unsigned input over the given
+ * ring members and appends them to the transaction. If this fails, nothing
+ * is written and a later call retries the same input.
+ * @param public_keys the ring members of the input {KEY_SIZE * RING_PARTICIPANTS}
+ */
+static uint16_t tx_sign_input(const unsigned char *public_keys)
+{
+// kept apart from the working set so that any APDU waiting on its splash screen is left intact
+#define SIGNATURES TX_WORKING_SET
+
+    BEGIN_TRY
+    {
+        TRY
+        {
+            const uint8_t i = L_transactions[L_slot].signed_input_count;
+
+            const uint16_t status = hw__generate_ring_signatures(
+                SIGNATURES,
+                L_transactions[L_slot].prefix_hash,
+                (*N_tx_pre_signatures(L_slot))[i].key_image,
+                public_keys,
+                (*N_tx_pre_signatures(L_slot))[i].private_ephemeral,
+                (*N_tx_pre_signatures(L_slot))[i].real_output_index);
+
+            if (status != OP_OK)
+            {
+                THROW(status);
+            }
+
+            /**
+             * Normally, we'd try to batch the write to NVRAM but due to memory constraints
+             * and the fact that each signature set is 256-bytes, we need to commit the
+             * signatures to NVRAM for each input as there can be 90 inputs
+             * processed and 90 * 256 = 23,040 bytes -- too many
+             */
+            TX_WRITE_PTR(SIGNATURES, SIG_SIZE * RING_PARTICIPANTS);
+
+            L_transactions[L_slot].signed_input_count++;
+
+            // if we have now signed all of the inputs (and signing was approved) then the transaction is complete
+            if (L_transactions[L_slot].signed_input_count == L_transactions[L_slot].input_count
+                && L_transactions[L_slot].state == TX_SIGNING)
+            {
+                explicit_bzero(L_transactions[L_slot].prefix_hash, KEY_SIZE);
+
+                L_transactions[L_slot].state = TX_COMPLETE;
+            }
+
+            tx_checkpoint();
+
+            CLOSE_TRY;
+
+            return OP_OK;
+        }
+        CATCH_OTHER(e)
+        {
+            return e;
+        }
+        FINALLY
+        {
+            explicit_bzero(SIGNATURES, SIG_SIZE * RING_PARTICIPANTS);
+#undef SIGNATURES
+        }
+    }
+    END_TRY;
+}
+
+/**
+ * Generates the ring signatures for the next unsigned input and appends them
+ * to the transaction. If this fails, nothing is written and a later call
+ * retries the same input. The rings are not kept when TX_COMPACT_PRESIG is
+ * set, the inputs are then signed by tx_sign_ring() instead.
+ */
+uint16_t tx_sign_step()
+{
+    if (tx_state() != TX_SIGNING && tx_state() != TX_PRESIGNING)
+    {
+        return ERR_TRANSACTION_STATE;
+    }
+
+    // everything was presigned, the rest is up to the approval
+    if (L_transactions[L_slot].signed_input_count == L_transactions[L_slot].input_count)
+    {
+        return OP_OK;
+    }
+
+#if TX_COMPACT_PRESIG == 1
+    return ERR_TX_RING;
+#else
+    return tx_sign_input((*N_tx_pre_signatures(L_slot))[L_transactions[L_slot].signed_input_count].public_keys);
+#endif
+}
+
+/**
+ * Signs the given input of the approved transaction with the ring members
+ * that the host supplies again, which must be the ones the input was loaded
+ * with. The inputs are signed in order; an input that is already signed
+ * (ie. by the ticker or by a request that is retried) is skipped.
+ * @param index the input to sign
+ * @param public_keys the ring members of the input {KEY_SIZE * RING_PARTICIPANTS}
+ * @return
+ */
+uint16_t tx_sign_ring(const uint8_t index, const unsigned char *public_keys)
+{
+    if (tx_state() != TX_SIGNING && tx_state() != TX_COMPLETE)
+    {
+        return ERR_TRANSACTION_STATE;
+    }
+    else if (index >= L_transactions[L_slot].input_count)
+    {
+        return ERR_TX_INPUT_OUTPUT_OUT_OF_RANGE;
+    }
+    else if (index < L_transactions[L_slot].signed_input_count || tx_state() == TX_COMPLETE)
+    {
+        return OP_OK;
+    }
+    else if (index != L_transactions[L_slot].signed_input_count)
+    {
+        return ERR_TX_RING;
+    }
+
+#if TX_COMPACT_PRESIG == 1
+    unsigned char ring_hash[KEY_SIZE];
+
+    const uint16_t status = hw_keccak(public_keys, RING_PARTICIPANTS * KEY_SIZE, ring_hash);
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+
+    if (os_memcmp(ring_hash, (const void *)(*N_tx_pre_signatures(L_slot))[index].ring_hash, KEY_SIZE) != 0)
+    {
+        return ERR_TX_RING;
+    }
+#else
+    if (os_memcmp(
+            public_keys, (const void *)(*N_tx_pre_signatures(L_slot))[index].public_keys, RING_PARTICIPANTS * KEY_SIZE)
+        != 0)
+    {
+        return ERR_TX_RING;
+    }
+#endif
+
+    return tx_sign_input(public_keys);
+}
+
+/**
+ * Returns the number of inputs that have been signed
+ */
+uint8_t tx_signed_input_count()
+{
+    return L_transactions[L_slot].signed_input_count;
+}
+
+/**
+ * Selects the slot that all following tx_* calls operate on
+ * @param slot
+ * @return
+ */
+uint16_t tx_select(const uint8_t slot)
+{
+    if (slot >= TX_SLOT_COUNT)
+    {
+        return ERR_TX_SLOT;
+    }
+
+    L_slot = slot;
+
+    return OP_OK;
+}
+
+/**
+ * Returns the current size of the transaction in memory
  */
 uint16_t tx_size()
 {
-    return L_transaction.current_position;
+    return L_transactions[L_slot].current_position;
+}
+
+/**
+ * Returns the currently selected slot
+ */
+uint8_t tx_slot()
+{
+    return L_slot;
 }
 
 /**
@@ -683,6 +1320,8 @@ uint16_t tx_start(
         {
             unsigned int pos = 0;
 
+            profile_nvm_tx_begin(L_slot);
+
             if (tx_reset() != 0)
             {
                 THROW(ERR_TX_RESET);
@@ -708,16 +1347,16 @@ uint16_t tx_start(
                 pos += encode_varint(tx + pos, unlock_time, sizeof(tx));
             }
 
-            L_transaction.input_count = input_count;
+            L_transactions[L_slot].input_count = input_count;
 
             // write the number of inputs to the transaction data
             {
                 pos += encode_varint(tx + pos, input_count, sizeof(tx));
             }
 
-            L_transaction.output_count = output_count;
+            L_transactions[L_slot].output_count = output_count;
 
-            L_transaction.has_payment_id = has_payment_id;
+            L_transactions[L_slot].has_payment_id = has_payment_id;
 
             // we can go ahead and store the start of the transaction prefix
             TX_WRITE(tx, pos);
@@ -737,7 +1376,9 @@ uint16_t tx_start(
             // write the structure to NVRAM so that we can use it later (saves RAM)
             TX_INFO_WRITE(tx_info);
 
-            L_transaction.state = TX_READY;
+            L_transactions[L_slot].state = TX_READY;
+
+            tx_checkpoint();
 
             CLOSE_TRY;
 
@@ -765,7 +1406,9 @@ uint16_t tx_start_input_load()
         return ERR_TRANSACTION_STATE;
     }
 
-    L_transaction.state = TX_RECEIVING_INPUTS;
+    L_transactions[L_slot].state = TX_RECEIVING_INPUTS;
+
+    tx_checkpoint();
 
     return OP_OK;
 }
@@ -785,12 +1428,14 @@ uint16_t tx_start_output_load()
 
     unsigned int pos = 0;
 
-    pos += encode_varint(tx, L_transaction.output_count, sizeof(tx));
+    pos += encode_varint(tx, L_transactions[L_slot].output_count, sizeof(tx));
 
     // write the number of outputs to the transaction prefix
     TX_WRITE(tx, pos);
 
-    L_transaction.state = TX_RECEIVING_OUTPUTS;
+    L_transactions[L_slot].state = TX_RECEIVING_OUTPUTS;
+
+    tx_checkpoint();
 
     return OP_OK;
 }
@@ -800,5 +1445,438 @@ uint16_t tx_start_output_load()
  */
 unsigned int tx_state()
 {
-    return (unsigned int)L_transaction.state;
+    return (unsigned int)L_transactions[L_slot].state;
+}
+
+/**
+ * Loads the secrets hint for the next input of a streamed prefix. The hint
+ * carries what is not in the prefix itself so that we can verify that the
+ * input belongs to us, and generate its key image and later its signature;
+ * the key image is then matched against the one in the prefix as it streams in
+ * @param tx_public_key
+ * @param output_index
+ * @param public_keys
+ * @param real_output_index
+ * @return
+ */
+uint16_t tx_stream_hint(
+    const unsigned char *tx_public_key,
+    const uint8_t output_index,
+    const unsigned char *public_keys,
+    const uint8_t real_output_index)
+{
+    if (tx_state() != TX_STREAMING)
+    {
+        return ERR_TRANSACTION_STATE;
+    }
+
+    tx_stream_t *stream = &L_transactions[L_slot].stream;
+
+    // once the number of inputs is known there cannot be more hints than inputs
+    if (stream->hint_count >= TX_MAX_INPUTS
+        || (stream->field > TX_STREAM_INPUT_COUNT && stream->hint_count >= L_transactions[L_slot].input_count))
+    {
+        return ERR_TX_INPUT_OUTPUT_OUT_OF_RANGE;
+    }
+
+    transaction_input_t tx_input; // 193-bytes
+
+    BEGIN_TRY
+    {
+        TRY
+        {
+            const uint16_t status =
+                tx_derive_input(&tx_input, tx_public_key, output_index, public_keys, real_output_index);
+
+            if (status != OP_OK)
+            {
+                THROW(status);
+            }
+
+            PRE_SIG_WRITE(stream->hint_count, tx_input);
+
+            stream->hint_count++;
+
+            tx_checkpoint();
+
+            CLOSE_TRY;
+
+            return OP_OK;
+        }
+        CATCH_OTHER(e)
+        {
+            return e;
+        }
+        FINALLY
+        {
+            explicit_bzero((void *)&tx_input, sizeof(transaction_input_t));
+        }
+    }
+    END_TRY;
+}
+
+/**
+ * Parses the next chunk of a fully serialized transaction prefix streamed in
+ * by the host and appends it to the transaction. Only the tx_stream_t is
+ * carried between chunks so a chunk may end anywhere, including in the middle
+ * of a varint or a key. The amounts are totalled and the key images checked
+ * against the hints as they pass; a chunk that fails to parse leaves the
+ * transaction as it was so that the host may send it again
+ * @param data
+ * @param length
+ * @return
+ */
+uint16_t tx_stream_prefix(const unsigned char *data, const uint16_t length)
+{
+    if (tx_state() != TX_STREAMING)
+    {
+        return ERR_TRANSACTION_STATE;
+    }
+
+    transaction_t *transaction = &L_transactions[L_slot];
+
+    tx_stream_t *stream = &transaction->stream;
+
+    transaction_t previous; // 70-bytes
+
+    os_memmove(&previous, transaction, sizeof(transaction_t));
+
+    BEGIN_TRY
+    {
+        TRY
+        {
+            uint64_t value = 0;
+
+            uint16_t i;
+
+            for (i = 0; i < length; i++)
+            {
+                const unsigned char byte = data[i];
+
+                switch (stream->field)
+                {
+                    case TX_STREAM_VERSION:
+                        if (tx_stream_varint(byte, &value))
+                        {
+                            if (value != 1)
+                            {
+                                THROW(ERR_TX_STREAM);
+                            }
+
+                            stream->field = TX_STREAM_UNLOCK_TIME;
+                        }
+                        break;
+
+                    case TX_STREAM_UNLOCK_TIME:
+                        if (tx_stream_varint(byte, &value))
+                        {
+                            stream->field = TX_STREAM_INPUT_COUNT;
+                        }
+                        break;
+
+                    case TX_STREAM_INPUT_COUNT:
+                        if (tx_stream_varint(byte, &value))
+                        {
+                            if (value == 0 || value > TX_MAX_INPUTS || value < stream->hint_count)
+                            {
+                                THROW(ERR_TX_INPUT_OUTPUT_OUT_OF_RANGE);
+                            }
+
+                            transaction->input_count = (uint8_t)value;
+
+                            stream->field = TX_STREAM_INPUT_TYPE;
+                        }
+                        break;
+
+                    case TX_STREAM_INPUT_TYPE:
+                        if (byte != TX_INPUT_TYPE_KEY)
+                        {
+                            THROW(ERR_TX_STREAM);
+                        }
+
+                        // the hint for an input must arrive before its key image
+                        if (transaction->received_input_count >= stream->hint_count)
+                        {
+                            THROW(ERR_TX_STREAM_HINT);
+                        }
+
+                        stream->field = TX_STREAM_INPUT_AMOUNT;
+                        break;
+
+                    case TX_STREAM_INPUT_AMOUNT:
+                        if (tx_stream_varint(byte, &value))
+                        {
+                            if (transaction->total_input_amount + value < transaction->total_input_amount)
+                            {
+                                THROW(ERR_TX_AMOUNT);
+                            }
+
+                            transaction->total_input_amount += value;
+
+                            stream->field = TX_STREAM_INPUT_OFFSET_COUNT;
+                        }
+                        break;
+
+                    case TX_STREAM_INPUT_OFFSET_COUNT:
+                        if (tx_stream_varint(byte, &value))
+                        {
+                            if (value != RING_PARTICIPANTS)
+                            {
+                                THROW(ERR_TX_STREAM);
+                            }
+
+                            stream->remaining = RING_PARTICIPANTS;
+
+                            stream->field = TX_STREAM_INPUT_OFFSETS;
+                        }
+                        break;
+
+                    case TX_STREAM_INPUT_OFFSETS:
+                        if (tx_stream_varint(byte, &value))
+                        {
+                            if (value > UINT32_MAX)
+                            {
+                                THROW(ERR_TX_STREAM);
+                            }
+
+                            stream->remaining--;
+
+                            if (stream->remaining == 0)
+                            {
+                                stream->remaining = KEY_SIZE;
+
+                                stream->field = TX_STREAM_INPUT_KEY_IMAGE;
+                            }
+                        }
+                        break;
+
+                    case TX_STREAM_INPUT_KEY_IMAGE:
+                        // the key image proves that the hint (and thus the input) is ours
+                        if ((*N_tx_pre_signatures(L_slot))[transaction->received_input_count]
+                                .key_image[KEY_SIZE - stream->remaining]
+                            != byte)
+                        {
+                            THROW(ERR_TX_STREAM_HINT);
+                        }
+
+                        stream->remaining--;
+
+                        if (stream->remaining == 0)
+                        {
+                            transaction->received_input_count++;
+
+                            stream->field = (transaction->received_input_count == transaction->input_count)
+                                                ? TX_STREAM_OUTPUT_COUNT
+                                                : TX_STREAM_INPUT_TYPE;
+                        }
+                        break;
+
+                    case TX_STREAM_OUTPUT_COUNT:
+                        if (tx_stream_varint(byte, &value))
+                        {
+                            if (value > TX_MAX_OUTPUTS)
+                            {
+                                THROW(ERR_TX_INPUT_OUTPUT_OUT_OF_RANGE);
+                            }
+
+                            transaction->output_count = (uint8_t)value;
+
+                            stream->field = (value == 0) ? TX_STREAM_EXTRA_SIZE : TX_STREAM_OUTPUT_AMOUNT;
+                        }
+                        break;
+
+                    case TX_STREAM_OUTPUT_AMOUNT:
+                        if (tx_stream_varint(byte, &value))
+                        {
+                            if (transaction->total_output_amount + value < transaction->total_output_amount)
+                            {
+                                THROW(ERR_TX_AMOUNT);
+                            }
+
+                            transaction->total_output_amount += value;
+
+                            stream->field = TX_STREAM_OUTPUT_TYPE;
+                        }
+                        break;
+
+                    case TX_STREAM_OUTPUT_TYPE:
+                        if (byte != TX_OUTPUT_TYPE_KEY)
+                        {
+                            THROW(ERR_TX_STREAM);
+                        }
+
+                        stream->remaining = KEY_SIZE;
+
+                        stream->field = TX_STREAM_OUTPUT_KEY;
+                        break;
+
+                    case TX_STREAM_OUTPUT_KEY:
+                        stream->remaining--;
+
+                        if (stream->remaining == 0)
+                        {
+                            transaction->received_output_count++;
+
+                            stream->field = (transaction->received_output_count == transaction->output_count)
+                                                ? TX_STREAM_EXTRA_SIZE
+                                                : TX_STREAM_OUTPUT_AMOUNT;
+                        }
+                        break;
+
+                    case TX_STREAM_EXTRA_SIZE:
+                        if (tx_stream_varint(byte, &value))
+                        {
+                            if (value > TX_EXTRA_MAX_SIZE)
+                            {
+                                THROW(ERR_TX_STREAM);
+                            }
+
+                            stream->remaining = (uint8_t)value;
+
+                            stream->field = (value == 0) ? TX_STREAM_DONE : TX_STREAM_EXTRA;
+                        }
+                        break;
+
+                    case TX_STREAM_EXTRA:
+                        stream->remaining--;
+
+                        if (stream->remaining == 0)
+                        {
+                            stream->field = TX_STREAM_DONE;
+                        }
+                        break;
+
+                    default:
+                        // there is nothing after the extra field
+                        THROW(ERR_TX_STREAM);
+                }
+            }
+
+            // leave room for the ring signatures that are appended to the prefix
+            if ((uint32_t)transaction->current_position + length
+                    + ((uint32_t)transaction->input_count * SIG_SIZE * RING_PARTICIPANTS)
+                > TX_MAX_SIZE)
+            {
+                THROW(ERR_OUT_OF_RANGE);
+            }
+
+            // batch write to NVRAM
+            TX_WRITE_PTR(data, length);
+
+            if (stream->field == TX_STREAM_DONE)
+            {
+                // every hint must have been used by an input
+                if (stream->hint_count != transaction->input_count)
+                {
+                    THROW(ERR_TX_STREAM_HINT);
+                }
+
+                // Are we trying to create more in outputs than we supplied in inputs?
+                if (transaction->total_output_amount > transaction->total_input_amount)
+                {
+                    THROW(ERR_TX_AMOUNT);
+                }
+
+                transaction->state = TX_PREFIX_READY;
+            }
+
+            tx_checkpoint();
+
+            CLOSE_TRY;
+
+            return OP_OK;
+        }
+        CATCH_OTHER(e)
+        {
+            os_memmove(transaction, &previous, sizeof(transaction_t));
+
+            return e;
+        }
+        FINALLY {}
+    }
+    END_TRY;
+}
+
+/**
+ * Starts a new transaction whose serialized prefix is streamed in by the
+ * host, see tx_stream_hint() and tx_stream_prefix()
+ * @return
+ */
+uint16_t tx_stream_start()
+{
+    const uint16_t status = tx_reset();
+
+    if (status != OP_OK)
+    {
+        return ERR_TX_RESET;
+    }
+
+    L_transactions[L_slot].state = TX_STREAMING;
+
+    tx_checkpoint();
+
+    return OP_OK;
+}
+
+/**
+ * Checks the ring signatures of every input of the completed transaction
+ * against its prefix and the ring members and key images it was signed with.
+ * The prefix is hashed once for all of the inputs and Hp(P) of ring members
+ * shared between inputs comes from the cache
+ * @param results bit i is set if the ring signatures of input i are valid {(TX_MAX_INPUTS + 7) / 8 bytes}
+ * @param cache the Hp(P) cache to use
+ * @return
+ */
+uint16_t tx_verify(unsigned char *results, hp_cache_t *cache)
+{
+#if TX_COMPACT_PRESIG == 1
+    UNUSED(results);
+
+    UNUSED(cache);
+
+    // the rings are not kept to check against
+    return ERR_OP_NOT_PERMITTED;
+#else
+    if (tx_state() != TX_COMPLETE)
+    {
+        return ERR_TRANSACTION_STATE;
+    }
+
+    const uint8_t input_count = L_transactions[L_slot].input_count;
+
+    // the signatures follow the prefix
+    const uint16_t prefix_size = L_transactions[L_slot].current_position - (input_count * SIG_SET_SIZE);
+
+    unsigned char prefix_hash[KEY_SIZE];
+
+    const uint16_t status = hw_keccak((unsigned char *)N_raw_transaction(L_slot), prefix_size, prefix_hash);
+
+    if (status != OP_OK)
+    {
+        return status;
+    }
+
+    explicit_bzero(results, (TX_MAX_INPUTS + 7) / 8);
+
+    explicit_bzero(cache, sizeof(hp_cache_t));
+
+    uint8_t i;
+
+    for (i = 0; i < input_count; i++)
+    {
+        // an error (ie. a ring member that is not a point) fails only its own input
+        if (hw_check_ring_signatures_cached(
+                prefix_hash,
+                (*N_tx_pre_signatures(L_slot))[i].key_image,
+                (*N_tx_pre_signatures(L_slot))[i].public_keys,
+                (unsigned char *)N_raw_transaction(L_slot) + prefix_size + (i * SIG_SET_SIZE),
+                cache)
+            == 1)
+        {
+            results[i / 8] |= 1 << (i % 8);
+        }
+    }
+
+    return OP_OK;
+#endif
 }
@@ -18,6 +18,7 @@
 #define TRANSACTION_H
 
 #include <keys.h>
+#include <stdbool.h>
 
 #define TX_MAX_INPUTS 90
 #define TX_MAX_OUTPUTS 90
@@ -25,6 +26,22 @@
 #define TX_EXTRA_MAX_SIZE 80 // bytes
 #define TX_MAX_DUMP_SIZE 448 // bytes
 
+#ifndef TX_SLOT_COUNT
+#define TX_SLOT_COUNT 2 // independent transactions that can be under construction at once
+#endif
+
+/**
+ * When set, only a Keccak commitment to the ring members of each input is kept
+ * in NVRAM rather than the ring itself, which halves the NVRAM reserved for
+ * (and written to) the pre-signatures. The host then supplies every ring again
+ * at signing time, see tx_sign_ring(), and nothing is signed ahead of approval
+ */
+#ifndef TX_COMPACT_PRESIG
+#define TX_COMPACT_PRESIG 0
+#endif
+
+#define P2_TX_SLOT_MASK 0x0F // the low nibble of P2 selects the slot in every TX_* APDU
+
 #define TX_EXTRA_TAG_SIZE 1
 #define TX_EXTRA_PUBKEY_TAG 0x01
 #define TX_EXTRA_NONCE_TAG 0x02
@@ -38,12 +55,19 @@
 #define TX_OUTPUTS_RECEIVED 0x05
 #define TX_PREFIX_READY 0x06
 #define TX_COMPLETE 0x07
+#define TX_SIGNING 0x08 // ring signatures are being generated, see tx_sign_step()
+#define TX_STREAMING 0x09 // a serialized prefix is being streamed in, see tx_stream_prefix()
+#define TX_PRESIGNING 0x0A // ring signatures are generated ahead of approval, see tx_presign_begin()
 
 typedef unsigned char raw_transaction_t[TX_MAX_SIZE];
 
 typedef struct transaction_input_s
 {
+#if TX_COMPACT_PRESIG == 1
+    unsigned char ring_hash[KEY_SIZE]; // 32-bytes, Keccak of the ring public keys
+#else
     unsigned char public_keys[RING_PARTICIPANTS * KEY_SIZE]; // 128-bytes
+#endif
 
     unsigned char private_ephemeral[KEY_SIZE]; // 32-bytes
 
@@ -59,7 +83,26 @@ typedef struct transaction_info_s
     unsigned char payment_id[KEY_SIZE]; // 32-bytes
 } transaction_info_t;
 
-typedef struct transaction_s // 24-bytes
+/**
+ * The state of the incremental parser used by tx_stream_prefix(), this is
+ * all that is carried between chunks so it does not grow with the prefix
+ */
+typedef struct tx_stream_s // 13-bytes
+{
+    uint64_t value; // 8-bytes, the varint decoded so far
+
+    uint8_t shift; // 1-byte, the bits of the varint decoded so far
+
+    uint8_t field; // 1-byte, the field of the prefix being parsed
+
+    uint8_t remaining; // 1-byte, the offsets or bytes left in the current field
+
+    uint8_t hint_count; // 1-byte, the number of input hints received
+
+    uint8_t reserved; // 1-byte
+} tx_stream_t;
+
+typedef struct transaction_s // 70-bytes
 {
     uint64_t total_input_amount; // 8-bytes
 
@@ -78,24 +121,51 @@ typedef struct transaction_s // 24-bytes
     uint8_t received_output_count; // 1-byte
 
     uint8_t state; // 1-byte
+
+    uint8_t signed_input_count; // 1-byte
+
+    unsigned char prefix_hash[KEY_SIZE]; // 32-bytes
+
+    tx_stream_t stream; // 13-bytes
 } transaction_t;
 
 typedef transaction_input_t tx_pre_signatures_t[TX_MAX_INPUTS];
 
+typedef struct transaction_checkpoint_s // 78-bytes
+{
+    transaction_t transaction; // 70-bytes
+
+    uint32_t sequence; // 4-bytes
+
+    uint32_t checksum; // 4-bytes
+} transaction_checkpoint_t;
+
+/**
+ * The transaction metadata is checkpointed alternately into two copies so that
+ * an interrupted write leaves the previous checkpoint intact
+ */
+#define TX_CHECKPOINT_COPIES 2
+
+typedef transaction_checkpoint_t tx_checkpoints_t[TX_CHECKPOINT_COPIES];
+
 #ifdef TARGET_NANOX
-extern const raw_transaction_t N_state_raw_transaction_pic;
-extern const tx_pre_signatures_t N_state_pre_signatures_pic;
-extern const transaction_info_t N_state_transaction_info_pic;
-#define N_raw_transaction ((volatile raw_transaction_t *)PIC(&N_state_raw_transaction_pic))
-#define N_tx_pre_signatures ((volatile tx_pre_signatures_t *)PIC(&N_state_pre_signatures_pic))
-#define N_tx_info ((volatile tx_info_t *)PIC(&N_state_transaction_info_pic))
+extern const raw_transaction_t N_state_raw_transaction_pic[TX_SLOT_COUNT];
+extern const tx_pre_signatures_t N_state_pre_signatures_pic[TX_SLOT_COUNT];
+extern const transaction_info_t N_state_transaction_info_pic[TX_SLOT_COUNT];
+extern const tx_checkpoints_t N_state_checkpoints_pic[TX_SLOT_COUNT];
+#define N_raw_transaction(slot) ((volatile raw_transaction_t *)PIC(&N_state_raw_transaction_pic[slot]))
+#define N_tx_pre_signatures(slot) ((volatile tx_pre_signatures_t *)PIC(&N_state_pre_signatures_pic[slot]))
+#define N_tx_info(slot) ((volatile transaction_info_t *)PIC(&N_state_transaction_info_pic[slot]))
+#define N_tx_checkpoints(slot) ((volatile tx_checkpoints_t *)PIC(&N_state_checkpoints_pic[slot]))
 #else
-extern raw_transaction_t N_state_raw_transaction_pic;
-extern tx_pre_signatures_t N_state_pre_signatures_pic;
-extern transaction_info_t N_state_transaction_info_pic;
-#define N_raw_transaction ((WIDE raw_transaction_t *)PIC(&N_state_raw_transaction_pic))
-#define N_tx_pre_signatures ((WIDE tx_pre_signatures_t *)PIC(&N_state_pre_signatures_pic))
-#define N_tx_info ((WIDE transaction_info_t *)PIC(&N_state_transaction_info_pic))
+extern raw_transaction_t N_state_raw_transaction_pic[TX_SLOT_COUNT];
+extern tx_pre_signatures_t N_state_pre_signatures_pic[TX_SLOT_COUNT];
+extern transaction_info_t N_state_transaction_info_pic[TX_SLOT_COUNT];
+extern tx_checkpoints_t N_state_checkpoints_pic[TX_SLOT_COUNT];
+#define N_raw_transaction(slot) ((WIDE raw_transaction_t *)PIC(&N_state_raw_transaction_pic[slot]))
+#define N_tx_pre_signatures(slot) ((WIDE tx_pre_signatures_t *)PIC(&N_state_pre_signatures_pic[slot]))
+#define N_tx_info(slot) ((WIDE transaction_info_t *)PIC(&N_state_transaction_info_pic[slot]))
+#define N_tx_checkpoints(slot) ((WIDE tx_checkpoints_t *)PIC(&N_state_checkpoints_pic[slot]))
 #endif
 
 uint16_t init_tx();
@@ -106,12 +176,22 @@ uint64_t tx_fee();
 
 uint16_t tx_finalize_prefix();
 
+uint16_t tx_generation();
+
 unsigned int tx_has_payment_id();
 
 uint16_t tx_hash(unsigned char *hash);
 
 uint64_t tx_input_amount();
 
+bool tx_in_progress();
+
+uint8_t tx_input_count();
+
+uint8_t tx_received_input_count();
+
+uint8_t tx_received_output_count();
+
 uint16_t tx_load_input(
     const unsigned char *tx_public_key,
     const uint8_t output_index,
@@ -124,14 +204,32 @@ uint16_t tx_load_output(const uint64_t amount, const unsigned char *key);
 
 uint64_t tx_output_amount();
 
+uint8_t tx_output_count();
+
 void tx_payment_id(unsigned char *payment_id);
 
+uint16_t tx_presign_abort();
+
+uint16_t tx_presign_begin();
+
 uint16_t tx_reset();
 
+uint16_t tx_select(const uint8_t slot);
+
 uint16_t tx_sign();
 
+uint16_t tx_sign_begin();
+
+uint16_t tx_sign_ring(const uint8_t index, const unsigned char *public_keys);
+
+uint16_t tx_sign_step();
+
+uint8_t tx_signed_input_count();
+
 uint16_t tx_size();
 
+uint8_t tx_slot();
+
 uint16_t tx_start(
     const uint64_t unlock_time,
     const uint8_t input_count,
@@ -146,4 +244,16 @@ uint16_t tx_start_output_load();
 
 unsigned int tx_state();
 
+uint16_t tx_stream_hint(
+    const unsigned char *tx_public_key,
+    const uint8_t output_index,
+    const unsigned char *public_keys,
+    const uint8_t real_output_index);
+
+uint16_t tx_stream_prefix(const unsigned char *data, const uint16_t length);
+
+uint16_t tx_stream_start();
+
+uint16_t tx_verify(unsigned char *results, hp_cache_t *cache);
+
 #endif // TRANSACTION_H
@@ -19,6 +19,9 @@
 
 #include "utils.h"
 
+#include <profile.h>
+#include <session.h>
+
 uint64_t readUint64BE(uint8_t *buffer)
 {
     return (uint64_t)((uint64_t)buffer[0] << 56) | ((uint64_t)buffer[1] << 48) | ((uint64_t)buffer[2] << 40)
@@ -77,8 +80,32 @@ void sendResponse(size_t tx, bool approve)
     // Send back the response, do not restart the event loop
     io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, tx);
 
-    // Display back the original UX
-    ui_idle();
+    profile_apdu_end();
+
+    // Display back the original UX, or the progress of the approved session
+    if (session_scope() != SESSION_SCOPE_NONE)
+    {
+        session_progress();
+    }
+    else
+    {
+        ui_idle();
+    }
+}
+
+/**
+ * Sends a successful response without redrawing the display, for replies
+ * that follow each other too quickly for a redraw after every one of them
+ */
+void sendResponseQuiet(size_t tx)
+{
+    G_io_apdu_buffer[tx++] = 0x90;
+
+    G_io_apdu_buffer[tx++] = 0x00;
+
+    io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, tx);
+
+    profile_apdu_end();
 }
 
 void sendError(const uint16_t errCode)
@@ -69,6 +69,8 @@ void uint16ToChar(unsigned char *r, const uint16_t value);
 
 void sendResponse(size_t tx, bool approve);
 
+void sendResponseQuiet(size_t tx);
+
 void sendError(const uint16_t errCode);
 
 void do_deny();
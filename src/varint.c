@@ -72,12 +72,12 @@ unsigned int decode_varint(const unsigned char *varint, const size_t max_length,
             THROW(ERR_VARINT_DATA_RANGE);
         }
 
-        val = val + (((varint[length]) & 0x7f) << (length * 7));
+        val = val + ((uint64_t)((varint[length]) & 0x7f) << (length * 7));
 
         length++;
     }
 
-    val = val + (((varint[length]) & 0x7f) << (length * 7));
+    val = val + ((uint64_t)((varint[length]) & 0x7f) << (length * 7));
 
     *value = val;
 
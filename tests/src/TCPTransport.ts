@@ -6,12 +6,34 @@ import Transport, { Observer, Subscription } from '@ledgerhq/hw-transport';
 import { Reader, Writer } from '@turtlecoin/bytestream';
 import { Socket, createConnection } from 'net';
 import { AbortController } from 'abort-controller/dist/abort-controller';
+import * as fs from 'fs';
+
+/**
+ * A single recorded exchange: the offset from the start of the recording at
+ * which the command was sent, the command and response (hex, the response
+ * without its status word), the status word, and how long it took (ms)
+ */
+export interface TraceExchange {
+    at: number;
+    command: string;
+    response: string;
+    status: number;
+    elapsed: number;
+}
+
+export interface Trace {
+    version: number;
+    recorded: string;
+    exchanges: TraceExchange[];
+}
 
 export class TCPTransport extends Transport<string> {
     private readonly m_socket: Socket;
     private readonly m_timeout: number;
     private m_verbose = false;
     private m_scrambleKey?: string;
+    private m_trace?: Trace;
+    private m_traceStart: [number, number] = [0, 0];
 
     constructor (socket: Socket, timeout = 30000) {
         super();
@@ -41,6 +63,41 @@ export class TCPTransport extends Transport<string> {
         this.m_verbose = val;
     }
 
+    /**
+     * The exchanges recorded since startTrace() was called (if any)
+     */
+    public get trace (): Trace | undefined {
+        return this.m_trace;
+    }
+
+    /**
+     * Starts recording every exchange, discarding anything previously recorded
+     */
+    public startTrace () {
+        this.m_trace = {
+            version: 1,
+            recorded: new Date().toISOString(),
+            exchanges: []
+        };
+
+        this.m_traceStart = process.hrtime();
+    }
+
+    /**
+     * Stops recording and, if a filename is supplied, writes the trace to it
+     */
+    public stopTrace (filename?: string): Trace | undefined {
+        const trace = this.m_trace;
+
+        this.m_trace = undefined;
+
+        if (trace && filename) {
+            fs.writeFileSync(filename, JSON.stringify(trace, null, 4));
+        }
+
+        return trace;
+    }
+
     public static async isSupported (): Promise<boolean> {
         return true;
     }
@@ -95,6 +152,8 @@ export class TCPTransport extends Transport<string> {
 
             const timeout = setTimeout(() => controller.abort(), this.m_timeout);
 
+            const sent = process.hrtime();
+
             const writer = new Writer();
 
             writer.uint32_t(apdu.length, true);
@@ -116,6 +175,19 @@ export class TCPTransport extends Transport<string> {
                 }
 
                 const code = reader.uint16_t(true).toJSNumber();
+
+                if (this.m_trace) {
+                    const elapsed = milliseconds(process.hrtime(sent));
+
+                    this.m_trace.exchanges.push({
+                        at: milliseconds(process.hrtime(this.m_traceStart)) - elapsed,
+                        command: apdu.toString('hex'),
+                        response: response.slice(0, size).toString('hex'),
+                        status: code,
+                        elapsed: elapsed
+                    });
+                }
+
                 if (code === 0x9000) {
                     clearTimeout(timeout);
 
@@ -132,6 +204,10 @@ export class TCPTransport extends Transport<string> {
     }
 }
 
+function milliseconds (time: [number, number]): number {
+    return (time[0] * 1000) + (time[1] / 1000000);
+}
+
 async function send (socket: Socket, data: Buffer, verbose = false): Promise<void> {
     return new Promise((resolve, reject) => {
         if (verbose) {
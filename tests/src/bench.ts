@@ -0,0 +1,459 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+import { Address, Crypto, LedgerDevice } from 'turtlecoin-utils';
+import { TCPTransport } from './TCPTransport';
+import * as fs from 'fs';
+import * as path from 'path';
+
+/**
+ * This benchmark drives the application running in Speculos through the same
+ * TCPTransport used by the test suite and times every instruction over a number
+ * of iterations, followed by a set of reference transactions that are built,
+ * signed and dumped phase by phase. The results are written as JSON and the
+ * medians are compared against the checked-in baseline so that a slowdown in
+ * the signing pipeline fails the run rather than going unnoticed. A measurement
+ * without a recorded baseline is listed as unmeasured so that a new instruction
+ * or phase is visible until its baseline is recorded
+ *
+ * BENCH_ITERATIONS      iterations of each instruction (default 10)
+ * BENCH_TX_ITERATIONS   iterations of each reference transaction (default 1)
+ * BENCH_OUTPUT          file to write the results to (default: stdout only)
+ * BENCH_BASELINE        baseline to compare with (default: bench-baseline.json)
+ * BENCH_UPDATE_BASELINE when set, the baseline is rewritten from this run
+ * TRACE                 file to record every exchange of the run to (see replay.ts)
+ */
+
+/** @ignore */
+const iterations = parseInt(process.env.BENCH_ITERATIONS || '10', 10);
+
+/** @ignore */
+const txIterations = parseInt(process.env.BENCH_TX_ITERATIONS || '1', 10);
+
+/** @ignore */
+const baselineFile = process.env.BENCH_BASELINE || path.join(__dirname, '..', 'bench-baseline.json');
+
+/** @ignore */
+const updateBaseline = !!(process.env.BENCH_UPDATE_BASELINE && process.env.BENCH_UPDATE_BASELINE.length !== 0);
+
+/**
+ * The reference transactions as [inputs, outputs]
+ */
+const referenceTransactions: [number, number][] = [[1, 1], [8, 8], [30, 2], [90, 1], [1, 90]];
+
+/**
+ * Transaction phases in the order they are run
+ */
+const phases = ['load', 'finalize', 'sign', 'sign_ring', 'verify', 'dump', 'dump_stream', 'stream'];
+
+/**
+ * The largest chunk of a dump stream, see TX_MAX_DUMP_SIZE in src/transaction.h
+ */
+const maxDumpSize = 448;
+
+/**
+ * The same seed and ident as the test suite, see index.ts
+ */
+const walletSeed = '74e4ac6f5a858c4161593a90d2f6f22d3a57195a89e75d10500d68db3c68c70f';
+
+const ledgerIdent = '547572746c65436f696e206973206e6f742061204d6f6e65726f20666f726b21';
+
+interface Statistics {
+    samples: number;
+    mean: number;
+    median: number;
+    p95: number;
+    min: number;
+    max: number;
+}
+
+interface Baseline {
+    tolerance: number;
+    instructions: {[name: string]: number | null};
+    transactions: {[name: string]: {[phase: string]: number | null}};
+}
+
+/**
+ * Returns the number of milliseconds the given call took
+ */
+async function time (call: () => Promise<any>): Promise<number> {
+    const start = process.hrtime();
+
+    await call();
+
+    const [seconds, nanoseconds] = process.hrtime(start);
+
+    return (seconds * 1000) + (nanoseconds / 1000000);
+}
+
+/**
+ * Summarises a set of samples (in milliseconds)
+ */
+function statistics (samples: number[]): Statistics {
+    const sorted = samples.slice().sort((a, b) => a - b);
+
+    const round = (value: number) => Math.round(value * 1000) / 1000;
+
+    const at = (fraction: number) => sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * fraction))];
+
+    return {
+        samples: sorted.length,
+        mean: round(sorted.reduce((sum, value) => sum + value, 0) / sorted.length),
+        median: round(at(0.5)),
+        p95: round(at(0.95)),
+        min: round(sorted[0]),
+        max: round(sorted[sorted.length - 1])
+    };
+}
+
+/**
+ * Compares the medians of this run with the baseline, returning a line for each
+ * measurement that exceeded it by more than the tolerance, the name of each
+ * measurement without a baseline is added to unmeasured
+ */
+function regressions (
+    baseline: Baseline,
+    instructions: {[name: string]: Statistics},
+    transactions: {[name: string]: {[phase: string]: Statistics}},
+    unmeasured: string[]): string[] {
+    const result: string[] = [];
+
+    const check = (name: string, expected: number | null | undefined, actual: Statistics) => {
+        if (expected === null || expected === undefined) {
+            unmeasured.push(name);
+
+            return;
+        }
+
+        if (actual.median > expected * (1 + baseline.tolerance)) {
+            result.push(name + ': ' + actual.median + 'ms against a baseline of ' + expected + 'ms');
+        }
+    };
+
+    for (const name of Object.keys(instructions)) {
+        check(name, baseline.instructions[name], instructions[name]);
+    }
+
+    for (const name of Object.keys(transactions)) {
+        for (const phase of Object.keys(transactions[name])) {
+            check(name + ' ' + phase, (baseline.transactions[name] || {})[phase], transactions[name][phase]);
+        }
+    }
+
+    return result;
+}
+
+(async () => {
+    const TurtleCoinCrypto = new Crypto();
+
+    // signing 90 inputs takes far longer than the default timeout in Speculos
+    const transport = await TCPTransport.open('127.0.0.1:9999', 600000);
+
+    if (process.env.TRACE) {
+        transport.startTrace();
+    }
+
+    const ledger = new LedgerDevice(transport);
+
+    const Wallet = await Address.fromSeed(walletSeed);
+
+    /**
+     * Known good inputs for every instruction, built the same way as in index.ts
+     */
+    const output_index = 2;
+
+    const tx_public_key = (await TurtleCoinCrypto.generateKeys()).public_key;
+
+    const derivation = await TurtleCoinCrypto.generateKeyDerivation(tx_public_key, Wallet.view.privateKey);
+
+    const publicEphemeral = await TurtleCoinCrypto.derivePublicKey(
+        derivation, output_index, Wallet.spend.publicKey);
+
+    const privateEphemeral = await TurtleCoinCrypto.deriveSecretKey(
+        derivation, output_index, Wallet.spend.privateKey);
+
+    const key_image = await TurtleCoinCrypto.generateKeyImage(publicEphemeral, privateEphemeral);
+
+    const message_digest = await TurtleCoinCrypto.cn_fast_hash(ledgerIdent);
+
+    const signature = await TurtleCoinCrypto.generateSignature(
+        message_digest, Wallet.spend.publicKey, Wallet.spend.privateKey);
+
+    const public_keys = [publicEphemeral];
+
+    for (let i = 0; i < 3; i++) {
+        public_keys.push((await TurtleCoinCrypto.generateKeys()).public_key);
+    }
+
+    const prepped = await TurtleCoinCrypto.prepareRingSignatures(message_digest, key_image, public_keys, 0);
+
+    const ring_signatures = await TurtleCoinCrypto.generateRingSignatures(
+        message_digest, key_image, public_keys, privateEphemeral, 0);
+
+    // a batch of one digest, the link after the last digest is all zeros
+    const batch_link = await TurtleCoinCrypto.cn_fast_hash(message_digest + '00'.repeat(32));
+
+    const batch_start = Buffer.alloc(35);
+
+    batch_start.writeUInt16BE(1, 1);
+
+    Buffer.from(batch_link, 'hex').copy(batch_start, 3);
+
+    const startBatch = () => transport.send(0xe0, 0x57, 0x00, 0x00, batch_start);
+
+    /**
+     * Every instruction in src/apdu.h that does not change the state of the device
+     * or need confirmation. The transaction instructions are timed by phase below
+     * and APDU_RESET_KEYS is left out as it would regenerate the wallet keys. The
+     * optional third element prepares each iteration and is not timed
+     */
+    const instructions: [string, () => Promise<any>, (() => Promise<any>)?][] = [
+        ['APDU_VERSION', () => ledger.getVersion()],
+        ['APDU_DEBUG', () => ledger.isDebug()],
+        ['APDU_IDENT', () => ledger.getIdent()],
+        ['APDU_SESSION_START', () => transport.send(0xe0, 0x06, 0x00, 0x00, Buffer.from([0x02]))],
+        ['APDU_SESSION_END', () => transport.send(0xe0, 0x07, 0x00, 0x00)],
+        ['APDU_PUBLIC_KEYS', () => ledger.getPublicKeys(false)],
+        ['APDU_VIEW_SECRET_KEY', () => ledger.getPrivateViewKey(false)],
+        ['APDU_SPEND_SECRET_KEY', () => ledger.getPrivateSpendKey(false)],
+        ['APDU_VIEW_WALLET_KEYS', () => ledger.getViewWallet(false)],
+        ['APDU_CHECK_KEY', () => ledger.checkKey(Wallet.spend.publicKey)],
+        ['APDU_CHECK_SCALAR', () => ledger.checkScalar(Wallet.spend.privateKey)],
+        ['APDU_CHECK_KEYS', () => transport.send(0xe0, 0x1a, 0x00, 0x00, Buffer.from(
+            Wallet.spend.publicKey + Wallet.spend.privateKey + Wallet.view.publicKey, 'hex'))],
+        ['APDU_CHECK_SCALARS', () => transport.send(0xe0, 0x1b, 0x00, 0x00, Buffer.from(
+            Wallet.spend.privateKey + Wallet.spend.publicKey + Wallet.view.privateKey, 'hex'))],
+        ['APDU_PRIVATE_TO_PUBLIC', () => ledger.privateToPublic(Wallet.spend.privateKey)],
+        ['APDU_RANDOM_KEY_PAIR', () => ledger.getRandomKeyPair()],
+        ['APDU_ADDRESS', () => ledger.getAddress(false)],
+        ['APDU_GENERATE_KEYIMAGE', () => ledger.generateKeyImage(
+            tx_public_key, output_index, publicEphemeral, false)],
+        ['APDU_GENERATE_KEYIMAGE_PRIMITIVE', () => ledger.generateKeyImagePrimitive(
+            derivation, output_index, publicEphemeral, false)],
+        ['APDU_GENERATE_RING_SIGNATURES', () => ledger.generateRingSignatures(
+            tx_public_key, output_index, publicEphemeral, message_digest, public_keys, 0, false)],
+        ['APDU_COMPLETE_RING_SIGUATURE', () => ledger.completeRingSignature(
+            tx_public_key, output_index, publicEphemeral, prepped.k, prepped.signatures[0], false)],
+        ['APDU_CHECK_RING_SIGNATURES', () => ledger.checkRingSignatures(
+            message_digest, key_image, public_keys, ring_signatures)],
+        ['APDU_GENERATE_SIGNATURE', () => ledger.generateSignature(message_digest, false)],
+        ['APDU_CHECK_SIGNATURE', () => ledger.checkSignature(message_digest, Wallet.spend.publicKey, signature)],
+        ['APDU_GENERATE_SIGNATURES_START', startBatch],
+        ['APDU_GENERATE_SIGNATURES', () => transport.send(
+            0xe0, 0x58, 0x00, 0x00, Buffer.from(message_digest + '00'.repeat(32), 'hex')), startBatch],
+        ['APDU_CHECK_SIGNATURES', () => transport.send(0xe0, 0x59, 0x00, 0x00, Buffer.from(
+            message_digest + Wallet.spend.publicKey + Wallet.spend.publicKey + signature + signature, 'hex'))],
+        ['APDU_GENERATE_KEY_DERIVATION', () => ledger.generateKeyDerivation(tx_public_key, false)],
+        ['APDU_DERIVE_PUBLIC_KEY', () => ledger.derivePublicKey(derivation, output_index, false)],
+        ['APDU_DERIVE_SECRET_KEY', () => ledger.deriveSecretKey(derivation, output_index, false)],
+        ['APDU_TX_STATE', () => ledger.transactionState()]
+    ];
+
+    const instructionResults: {[name: string]: Statistics} = {};
+
+    for (const [name, call, setup] of instructions) {
+        const samples: number[] = [];
+
+        for (let i = 0; i < iterations; i++) {
+            if (setup) {
+                await setup();
+            }
+
+            samples.push(await time(call));
+        }
+
+        instructionResults[name] = statistics(samples);
+
+        console.error('%s: %s ms', name.padEnd(36), instructionResults[name].median);
+    }
+
+    /**
+     * The reference transactions spend the same owned input repeatedly (as the
+     * test suite does) with mixins, so only the counts vary between them
+     */
+    const input_tx_public_key = (await TurtleCoinCrypto.generateKeys()).public_key;
+
+    const input_derivation = await TurtleCoinCrypto.generateKeyDerivation(
+        input_tx_public_key, Wallet.view.privateKey);
+
+    const mixins = [await TurtleCoinCrypto.derivePublicKey(input_derivation, 0, Wallet.spend.publicKey)];
+
+    for (let i = 0; i < 3; i++) {
+        mixins.push((await TurtleCoinCrypto.generateKeys()).public_key);
+    }
+
+    const output_key = (await TurtleCoinCrypto.generateKeys()).public_key;
+
+    const transactionResults: {[name: string]: {[phase: string]: Statistics}} = {};
+
+    for (const [inputs, outputs] of referenceTransactions) {
+        const name = inputs + 'x' + outputs;
+
+        const samples: {[phase: string]: number[]} = {};
+
+        for (const phase of phases) {
+            samples[phase] = [];
+        }
+
+        for (let i = 0; i < txIterations; i++) {
+            if (await ledger.transactionState() !== 0) {
+                await ledger.resetTransaction(false);
+            }
+
+            const tx_key = (await TurtleCoinCrypto.generateKeys()).public_key;
+
+            await ledger.startTransaction(0, inputs, outputs, tx_key);
+
+            samples.load.push(await time(async () => {
+                await ledger.startTransactionInputLoad();
+
+                for (let j = 0; j < inputs; j++) {
+                    await ledger.loadTransactionInput(input_tx_public_key, 0, 1000, mixins, [0, 1, 2, 3], 0);
+                }
+
+                await ledger.startTransactionOutputLoad();
+
+                for (let j = 0; j < outputs; j++) {
+                    await ledger.loadTransactionOutput(10, output_key);
+                }
+            }));
+
+            samples.finalize.push(await time(() => ledger.finalizeTransactionPrefix()));
+
+            let tx_size = 0;
+
+            samples.sign.push(await time(async () => {
+                tx_size = (await ledger.signTransaction(false)).size;
+            }));
+
+            // every input is already signed by the ticker unless the build keeps only ring commitments
+            samples.sign_ring.push(await time(async () => {
+                for (let j = 0; j < inputs; j++) {
+                    await transport.send(0xe0, 0x7e, 0x00, 0x00, Buffer.concat([
+                        Buffer.from([j]),
+                        Buffer.concat(mixins.map(key => Buffer.from(key, 'hex')))]));
+                }
+            }));
+
+            samples.verify.push(await time(() => transport.send(0xe0, 0x7d, 0x00, 0x00)));
+
+            let transaction: Buffer = Buffer.alloc(0);
+
+            samples.dump.push(await time(async () => {
+                transaction = (await ledger.retrieveTransaction()).toBuffer();
+            }));
+
+            samples.dump_stream.push(await time(async () => {
+                let chunk = await transport.send(0xe0, 0x7f, 0x03, 0x00);
+
+                while (chunk.length - 2 === maxDumpSize) {
+                    chunk = await transport.send(0xe0, 0x7f, 0x00, 0x00);
+                }
+            }));
+
+            // the prefix is streamed back into the second slot, with a hint for each input
+            const prefix = transaction.slice(0, tx_size - (inputs * 4 * 64));
+
+            const hint = Buffer.concat([
+                Buffer.from(input_tx_public_key, 'hex'),
+                Buffer.from([0]),
+                Buffer.concat(mixins.map(key => Buffer.from(key, 'hex'))),
+                Buffer.from([0])]);
+
+            samples.stream.push(await time(async () => {
+                await transport.send(0xe0, 0x7a, 0x00, 0x01);
+
+                for (let j = 0; j < inputs; j++) {
+                    await transport.send(0xe0, 0x7b, 0x00, 0x01, hint);
+                }
+
+                for (let offset = 0; offset < prefix.length; offset += 255) {
+                    await transport.send(0xe0, 0x7c, 0x00, 0x01, prefix.slice(offset, offset + 255));
+                }
+            }));
+
+            await transport.send(0xe0, 0x79, 0x00, 0x01);
+
+            await ledger.resetTransaction(false);
+        }
+
+        transactionResults[name] = {};
+
+        for (const phase of phases) {
+            transactionResults[name][phase] = statistics(samples[phase]);
+        }
+
+        console.error('%s: %s', name.padEnd(36), phases.map(phase =>
+            phase + ' ' + transactionResults[name][phase].median + ' ms').join(', '));
+    }
+
+    if (process.env.TRACE) {
+        transport.stopTrace(process.env.TRACE);
+    }
+
+    await transport.close();
+
+    const results = {
+        iterations: iterations,
+        txIterations: txIterations,
+        instructions: instructionResults,
+        transactions: transactionResults
+    };
+
+    const json = JSON.stringify(results, null, 4);
+
+    if (process.env.BENCH_OUTPUT) {
+        fs.writeFileSync(process.env.BENCH_OUTPUT, json);
+    }
+
+    console.log(json);
+
+    const baseline: Baseline = JSON.parse(fs.readFileSync(baselineFile).toString());
+
+    if (updateBaseline) {
+        for (const name of Object.keys(instructionResults)) {
+            baseline.instructions[name] = instructionResults[name].median;
+        }
+
+        for (const name of Object.keys(transactionResults)) {
+            baseline.transactions[name] = {};
+
+            for (const phase of phases) {
+                baseline.transactions[name][phase] = transactionResults[name][phase].median;
+            }
+        }
+
+        fs.writeFileSync(baselineFile, JSON.stringify(baseline, null, 4) + '\n');
+
+        console.error('Baseline updated: %s', baselineFile);
+
+        return;
+    }
+
+    const unmeasured: string[] = [];
+
+    const failures = regressions(baseline, instructionResults, transactionResults, unmeasured);
+
+    if (unmeasured.length !== 0) {
+        console.error('No baseline recorded (set BENCH_UPDATE_BASELINE=1 to record one) for:');
+
+        for (const name of unmeasured) {
+            console.error('    %s', name);
+        }
+    }
+
+    if (failures.length !== 0) {
+        console.error('Slower than the baseline by more than %s%%:', baseline.tolerance * 100);
+
+        for (const failure of failures) {
+            console.error('    %s', failure);
+        }
+
+        process.exit(1);
+    }
+})().catch(error => {
+    console.error(error);
+
+    process.exit(1);
+});
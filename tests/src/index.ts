@@ -11,6 +11,9 @@ import * as assert from 'assert';
 /** @ignore */
 const confirm = !!(process.env.CONFIRM && process.env.CONFIRM.length !== 0);
 
+/** @ignore */
+const traceFile = process.env.TRACE;
+
 /**
  * This set of tests is designed to test the application and thus the crypto operations
  * provided by the TurtleCoin application running on a Ledger hardware device against
@@ -45,6 +48,10 @@ describe('Ledger Hardware Tests', function () {
     before(async () => {
         transport = await TCPTransport.open('127.0.0.1:9999');
 
+        if (traceFile) {
+            (transport as TCPTransport).startTrace();
+        }
+
         ledger = new LedgerDevice(transport);
 
         Wallet = await Address.fromSeed(walletSeed);
@@ -52,6 +59,10 @@ describe('Ledger Hardware Tests', function () {
 
     after(async () => {
         if (transport) {
+            if (traceFile) {
+                (transport as TCPTransport).stopTrace(traceFile);
+            }
+
             await transport.close();
         }
     });
@@ -70,6 +81,12 @@ describe('Ledger Hardware Tests', function () {
         it('Is Debug?', async () => {
             assert(await ledger.isDebug());
         });
+
+        it('Is Debug?: Fails with unknown option', async () => {
+            await transport.send(0xe0, 0x02, 0x7f, 0x00)
+                .then(() => assert(false))
+                .catch(() => assert(true));
+        });
     });
 
     describe('Key Fundamentals', () => {
@@ -142,6 +159,18 @@ describe('Ledger Hardware Tests', function () {
             assert(!await ledger.checkScalar(Wallet.spend.publicKey));
         });
 
+        it('Check Keys', async () => {
+            const data = Buffer.from(Wallet.spend.publicKey + Wallet.spend.privateKey + Wallet.view.publicKey, 'hex');
+
+            assert((await transport.send(0xe0, 0x1a, 0x00, 0x00, data))[0] === 0x05);
+        });
+
+        it('Check Scalars', async () => {
+            const data = Buffer.from(Wallet.spend.privateKey + Wallet.spend.publicKey + Wallet.view.privateKey, 'hex');
+
+            assert((await transport.send(0xe0, 0x1b, 0x00, 0x00, data))[0] === 0x05);
+        });
+
         it('Reset Keys', async () => {
             return ledger.resetKeys(confirm);
         });
@@ -160,6 +189,65 @@ describe('Ledger Hardware Tests', function () {
             assert(await TurtleCoinCrypto.checkSignature(message_digest, Wallet.spend.publicKey, signature));
         });
 
+        describe('Signature Batch', () => {
+            const digests: string[] = [];
+
+            // links[i] is the batch hash of digests[i] onwards
+            const links: string[] = ['00'.repeat(32)];
+
+            const startBatch = async () => {
+                const data = Buffer.alloc(35);
+
+                data.writeUInt8(0x00, 0);
+
+                data.writeUInt16BE(digests.length, 1);
+
+                Buffer.from(links[0], 'hex').copy(data, 3);
+
+                return transport.send(0xe0, 0x57, confirm ? 0x01 : 0x00, 0x00, data);
+            };
+
+            before(async () => {
+                for (let i = 0; i < 6; i++) {
+                    digests.push(await TurtleCoinCrypto.cn_fast_hash(message_digest + i.toString(16).padStart(2, '0')));
+                }
+
+                for (let i = digests.length - 1; i >= 0; i--) {
+                    links.unshift(await TurtleCoinCrypto.cn_fast_hash(digests[i] + links[0]));
+                }
+            });
+
+            it('Generate Signatures', async () => {
+                await startBatch();
+
+                for (let i = 0; i < digests.length; i += 4) {
+                    const chunk = digests.slice(i, i + 4);
+
+                    const result = await transport.send(
+                        0xe0, 0x58, 0x00, 0x00, Buffer.from(chunk.join('') + links[i + chunk.length], 'hex'));
+
+                    for (let j = 0; j < chunk.length; j++) {
+                        const signature = result.slice(j * 64, (j + 1) * 64).toString('hex');
+
+                        assert(await TurtleCoinCrypto.checkSignature(chunk[j], Wallet.spend.publicKey, signature));
+                    }
+                }
+            });
+
+            it('Generate Signatures: Digests outside of the batch fail', async () => {
+                await startBatch();
+
+                await transport.send(0xe0, 0x58, 0x00, 0x00, Buffer.from(digests[1] + links[2], 'hex'))
+                    .then(() => assert(false))
+                    .catch(() => assert(true));
+
+                // the batch ended with the chunk that did not belong to it
+                await transport.send(0xe0, 0x58, 0x00, 0x00, Buffer.from(digests[0] + links[1], 'hex'))
+                    .then(() => assert(false))
+                    .catch(() => assert(true));
+            });
+        });
+
         it('Check Signature', async () => {
             const signature = await TurtleCoinCrypto.generateSignature(
                 message_digest, Wallet.spend.publicKey, Wallet.spend.privateKey);
@@ -167,6 +255,23 @@ describe('Ledger Hardware Tests', function () {
             assert(await ledger.checkSignature(message_digest, Wallet.spend.publicKey, signature));
         });
 
+        it('Check Signatures', async () => {
+            const signature = await TurtleCoinCrypto.generateSignature(
+                message_digest, Wallet.spend.publicKey, Wallet.spend.privateKey);
+
+            const broken = signature.split('').reverse().join('');
+
+            const some = Buffer.from(message_digest + Wallet.spend.publicKey + Wallet.view.publicKey +
+                Wallet.spend.publicKey + signature + signature + broken, 'hex');
+
+            assert((await transport.send(0xe0, 0x59, 0x00, 0x00, some))[0] === 0x01);
+
+            const all = Buffer.from(message_digest + Wallet.spend.publicKey + Wallet.spend.publicKey +
+                signature + signature, 'hex');
+
+            assert((await transport.send(0xe0, 0x59, 0x00, 0x00, all))[0] === 0x03);
+        });
+
         it('Check Signature: Supplying private key fails', async () => {
             const signature = await TurtleCoinCrypto.generateSignature(
                 message_digest, Wallet.spend.publicKey, Wallet.spend.privateKey);
@@ -383,6 +488,48 @@ describe('Ledger Hardware Tests', function () {
         });
     });
 
+    describe('Session Mode', () => {
+        let tx_public_key: string;
+        let expected_derivation: string;
+
+        before(async () => {
+            tx_public_key = (await TurtleCoinCrypto.generateKeys()).public_key;
+
+            expected_derivation = await TurtleCoinCrypto.generateKeyDerivation(
+                tx_public_key, Wallet.view.privateKey);
+        });
+
+        after(async () => {
+            await transport.send(0xe0, 0x07, 0x00, 0x00);
+        });
+
+        it('Start Session: Fails with unknown scope', async () => {
+            await transport.send(0xe0, 0x06, confirm ? 0x01 : 0x00, 0x00, Buffer.from([0x04]))
+                .then(() => assert(false))
+                .catch(() => assert(true));
+        });
+
+        it('Start Session', async () => {
+            await transport.send(0xe0, 0x06, confirm ? 0x01 : 0x00, 0x00, Buffer.from([0x02]));
+        });
+
+        it('Generate Key Derivation within Session', async () => {
+            for (let i = 0; i < 5; i++) {
+                const derivation = await ledger.generateKeyDerivation(tx_public_key, false);
+
+                assert(expected_derivation === derivation);
+            }
+        });
+
+        it('Check Key within Session', async () => {
+            assert(await ledger.checkKey(Wallet.spend.publicKey));
+        });
+
+        it('End Session', async () => {
+            await transport.send(0xe0, 0x07, 0x00, 0x00);
+        });
+    });
+
     describe('Transaction Construction Tests', function () {
         let skipTests = false;
 
@@ -667,6 +814,84 @@ describe('Ledger Hardware Tests', function () {
                 assert(state === 7);
             });
 
+            it('Check signing progress', async function () {
+                if (cancelTests) {
+                    return this.skip();
+                }
+
+                const result = await transport.send(0xe0, 0x70, 0x01, 0x00);
+
+                assert(result[0] === 7 && result[1] === 2 && result[2] === 2);
+                assert(result[3] === 2 && result[4] === 1 && result[5] === 1);
+                assert(result[6] === 0);
+            });
+
+            it('Fetch signing result again', async function () {
+                if (cancelTests) {
+                    return this.skip();
+                }
+
+                const result = await transport.send(0xe0, 0x77, 0x00, 0x00);
+
+                assert(result.slice(0, 32).toString('hex') === tx_hash);
+                assert(result.readUInt16BE(32) === tx_size);
+            });
+
+            it('Verify the ring signatures of the transaction', async function () {
+                if (cancelTests) {
+                    return this.skip();
+                }
+
+                const result = await transport.send(0xe0, 0x7d, 0x00, 0x00);
+
+                assert(result.length === 3 && result[0] === 0x03);
+            });
+
+            it('Supply the ring of an input that is already signed', async function () {
+                if (cancelTests) {
+                    return this.skip();
+                }
+
+                // inputs that are already signed are skipped so that a request can be retried
+                const result = await transport.send(0xe0, 0x7e, 0x00, 0x00, Buffer.alloc(129));
+
+                assert(result.length === 3 && result[0] === 2);
+            });
+
+            it('Start Transaction in second slot', async function () {
+                if (cancelTests) {
+                    return this.skip();
+                }
+
+                const keys = await TurtleCoinCrypto.generateKeys();
+
+                const data = Buffer.alloc(43);
+
+                data.writeUInt8(1, 8);
+                data.writeUInt8(1, 9);
+                Buffer.from(keys.public_key, 'hex').copy(data, 10);
+
+                await transport.send(0xe0, 0x71, 0x00, 0x01, data);
+
+                const slot1 = await transport.send(0xe0, 0x70, 0x00, 0x01);
+
+                const slot0 = await transport.send(0xe0, 0x70, 0x00, 0x00);
+
+                assert(slot1[0] === 1 && slot0[0] === 7);
+            });
+
+            it('Reset Transaction in second slot', async function () {
+                if (cancelTests) {
+                    return this.skip();
+                }
+
+                await transport.send(0xe0, 0x79, 0x00, 0x01);
+
+                const result = await transport.send(0xe0, 0x70, 0x00, 0x01);
+
+                assert(result[0] === 0);
+            });
+
             it('Retrieve Transaction', async function () {
                 if (cancelTests) {
                     return this.skip();
@@ -678,27 +903,88 @@ describe('Ledger Hardware Tests', function () {
                 assert(tx_hash === await transaction.hash());
                 assert(payment_id === transaction.paymentId);
             });
+
+            it('Stream Transaction dump with hash trailer', async function () {
+                if (cancelTests) {
+                    return this.skip();
+                }
+
+                const chunks: Buffer[] = [];
+
+                let chunk = await transport.send(0xe0, 0x7f, 0x03, 0x00);
+
+                chunks.push(chunk.slice(0, chunk.length - 2));
+
+                // every response but the last is a full chunk
+                while (chunk.length - 2 === 448) {
+                    chunk = await transport.send(0xe0, 0x7f, 0x00, 0x00);
+
+                    chunks.push(chunk.slice(0, chunk.length - 2));
+                }
+
+                const stream = Buffer.concat(chunks);
+
+                const transaction = await ledger.retrieveTransaction();
+
+                assert(stream.length === tx_size + 32);
+                assert(stream.slice(0, tx_size).equals(transaction.toBuffer()));
+                assert(stream.slice(tx_size).toString('hex') === tx_hash);
+            });
+
+            it('Stream Transaction prefix in second slot', async function () {
+                if (cancelTests) {
+                    return this.skip();
+                }
+
+                const transaction = await ledger.retrieveTransaction();
+
+                // the prefix is everything before the ring signatures of the 2 inputs
+                const prefix = transaction.toBuffer().slice(0, tx_size - (2 * 4 * 64));
+
+                const hint = Buffer.concat([
+                    Buffer.from(input_tx_public_key, 'hex'),
+                    Buffer.from([input_output_index]),
+                    Buffer.concat(mixins.map(key => Buffer.from(key, 'hex'))),
+                    Buffer.from([0])]);
+
+                await transport.send(0xe0, 0x7a, 0x00, 0x01);
+
+                await transport.send(0xe0, 0x7b, 0x00, 0x01, hint);
+                await transport.send(0xe0, 0x7b, 0x00, 0x01, hint);
+
+                // split the prefix mid-field to exercise the incremental parser
+                await transport.send(0xe0, 0x7c, 0x00, 0x01, prefix.slice(0, 50));
+                await transport.send(0xe0, 0x7c, 0x00, 0x01, prefix.slice(50));
+
+                const result = await transport.send(0xe0, 0x70, 0x01, 0x01);
+
+                await transport.send(0xe0, 0x79, 0x00, 0x01);
+
+                assert(result[0] === 6 && result[2] === 2 && result[5] === 1);
+            });
         });
 
-        describe('Key Fundamentals Fail While in Transaction State', () => {
+        describe('Key Fundamentals While in Transaction State', () => {
             it('Generate Random Key Pair', async () => {
-                await ledger.getRandomKeyPair()
-                    .then(() => assert(false))
-                    .catch(() => assert(true));
+                const keys = await ledger.getRandomKeyPair();
+
+                assert(await TurtleCoinCrypto.checkKey(keys.publicKey) &&
+                    await TurtleCoinCrypto.checkScalar(keys.privateKey));
             });
 
             it('Private Key to Public Key', async () => {
                 const keys = await TurtleCoinCrypto.generateKeys();
 
-                await ledger.privateToPublic(keys.private_key)
-                    .then(() => assert(false))
-                    .catch(() => assert(true));
+                const result = await ledger.privateToPublic(keys.private_key);
+
+                assert(result.publicKey === keys.public_key);
             });
 
             it('Get Public Keys', async () => {
-                await ledger.getPublicKeys(confirm)
-                    .then(() => assert(false))
-                    .catch(() => assert(true));
+                const keys = await ledger.getPublicKeys(confirm);
+
+                assert(keys.spend.publicKey === Wallet.spend.publicKey &&
+                    keys.view.publicKey === Wallet.view.publicKey);
             });
 
             it('Get Private Spend Key', async () => {
@@ -708,27 +994,29 @@ describe('Ledger Hardware Tests', function () {
             });
 
             it('Get Private View Key', async () => {
-                await ledger.getPrivateViewKey(confirm)
-                    .then(() => assert(false))
-                    .catch(() => assert(true));
+                const key = await ledger.getPrivateViewKey(confirm);
+
+                assert(key.privateKey === Wallet.view.privateKey);
             });
 
             it('Get Wallet Address', async () => {
-                await ledger.getAddress(confirm)
-                    .then(() => assert(false))
-                    .catch(() => assert(true));
+                const result = await ledger.getAddress(confirm);
+
+                assert(await result.address() === await Wallet.address());
             });
 
             it('Check Key', async () => {
-                await ledger.checkKey(Wallet.spend.publicKey)
-                    .then(() => assert(false))
-                    .catch(() => assert(true));
+                assert(await ledger.checkKey(Wallet.spend.publicKey));
             });
 
             it('Check Scalar', async () => {
-                await ledger.checkScalar(Wallet.spend.privateKey)
-                    .then(() => assert(false))
-                    .catch(() => assert(true));
+                assert(await ledger.checkScalar(Wallet.spend.privateKey));
+            });
+
+            it('Check Keys', async () => {
+                const data = Buffer.from(Wallet.spend.publicKey + Wallet.spend.privateKey, 'hex');
+
+                assert((await transport.send(0xe0, 0x1a, 0x00, 0x00, data))[0] === 0x01);
             });
 
             it('Reset Keys', async () => {
@@ -738,7 +1026,7 @@ describe('Ledger Hardware Tests', function () {
             });
         });
 
-        describe('Signing Fundamentals Fail While in Transaction State', () => {
+        describe('Signing Fundamentals While in Transaction State', () => {
             let message_digest: string;
 
             before(async () => {
@@ -751,17 +1039,32 @@ describe('Ledger Hardware Tests', function () {
                     .catch(() => assert(true));
             });
 
+            it('Generate Signatures', async () => {
+                const data = Buffer.concat([Buffer.from([0x00, 0x00, 0x01]), Buffer.from(message_digest, 'hex')]);
+
+                await transport.send(0xe0, 0x57, confirm ? 0x01 : 0x00, 0x00, data)
+                    .then(() => assert(false))
+                    .catch(() => assert(true));
+            });
+
             it('Check Signature', async () => {
                 const signature = await TurtleCoinCrypto.generateSignature(
                     message_digest, Wallet.spend.publicKey, Wallet.spend.privateKey);
 
-                await ledger.checkSignature(message_digest, Wallet.spend.publicKey, signature)
-                    .then(() => assert(false))
-                    .catch(() => assert(true));
+                assert(await ledger.checkSignature(message_digest, Wallet.spend.publicKey, signature));
+            });
+
+            it('Check Signatures', async () => {
+                const signature = await TurtleCoinCrypto.generateSignature(
+                    message_digest, Wallet.spend.publicKey, Wallet.spend.privateKey);
+
+                const data = Buffer.from(message_digest + Wallet.spend.publicKey + signature, 'hex');
+
+                assert((await transport.send(0xe0, 0x59, 0x00, 0x00, data))[0] === 0x01);
             });
         });
 
-        describe('Stealth Operations Fail While in Transaction State', () => {
+        describe('Stealth Operations While in Transaction State', () => {
             let ready = false;
             const output_index = 2;
 
@@ -790,15 +1093,15 @@ describe('Ledger Hardware Tests', function () {
             });
 
             it('Generate Key Derivation', async () => {
-                await ledger.generateKeyDerivation(tx_public_key, confirm)
-                    .then(() => assert(false))
-                    .catch(() => assert(true));
+                const derivation = await ledger.generateKeyDerivation(tx_public_key, confirm);
+
+                assert(expected_derivation === derivation);
             });
 
             it('Derive Public Key', async () => {
-                await ledger.derivePublicKey(expected_derivation, output_index, confirm)
-                    .then(() => assert(false))
-                    .catch(() => assert(true));
+                const result = await ledger.derivePublicKey(expected_derivation, output_index, confirm);
+
+                assert(result.publicKey === expected_publicEphemeral);
             });
 
             it('Derive Secret Key', async () => {
@@ -808,22 +1111,22 @@ describe('Ledger Hardware Tests', function () {
             });
 
             it('Generate Key Image', async () => {
-                await ledger.generateKeyImage(
-                    tx_public_key, output_index, expected_publicEphemeral, confirm)
-                    .then(() => assert(false))
-                    .catch(() => assert(true));
+                const key_image = await ledger.generateKeyImage(
+                    tx_public_key, output_index, expected_publicEphemeral, confirm);
+
+                assert(key_image === expected_key_image);
             });
 
             it('Generate Key Image Primitive', async () => {
                 const derivation = await TurtleCoinCrypto.generateKeyDerivation(tx_public_key, Wallet.view.privateKey);
 
-                await ledger.generateKeyImagePrimitive(
-                    derivation, output_index, expected_publicEphemeral, confirm)
-                    .then(() => assert(false))
-                    .catch(() => assert(true));
+                const key_image = await ledger.generateKeyImagePrimitive(
+                    derivation, output_index, expected_publicEphemeral, confirm);
+
+                assert(key_image === expected_key_image);
             });
 
-            describe('Ring Signatures Fail While in Transaction State', () => {
+            describe('Ring Signatures While in Transaction State', () => {
                 const public_keys: string[] = [];
                 const real_output_index = 0;
 
@@ -882,10 +1185,8 @@ describe('Ledger Hardware Tests', function () {
                 });
 
                 it('Check Ring Signatures', async function () {
-                    await ledger.checkRingSignatures(
-                        tx_prefix_hash, expected_key_image, public_keys, expected_ring_signatures)
-                        .then(() => assert(false))
-                        .catch(() => assert(true));
+                    assert(await ledger.checkRingSignatures(
+                        tx_prefix_hash, expected_key_image, public_keys, expected_ring_signatures));
                 });
             });
         });
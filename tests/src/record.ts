@@ -0,0 +1,126 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+import { Address, Crypto, LedgerDevice } from 'turtlecoin-utils';
+import { TCPTransport } from './TCPTransport';
+
+/**
+ * Records the shape of a typical wallet session against Speculos to a trace
+ * file that replay.ts can re-issue against any build of the application
+ *
+ * npm run record -- <sync|keyimages|spend> <trace.json>
+ *
+ * sync       a sync session: a derivation and two output checks for each of 50 transactions
+ * keyimages  a sync session generating the key images of 50 owned outputs
+ * spend      an 8 input, 2 output transaction built, signed and dumped
+ */
+
+/**
+ * The same seed as the test suite, see index.ts
+ */
+const walletSeed = '74e4ac6f5a858c4161593a90d2f6f22d3a57195a89e75d10500d68db3c68c70f';
+
+/** @ignore */
+const TRANSACTIONS = 50;
+
+/** @ignore */
+const SPEND_INPUTS = 8;
+
+/** @ignore */
+const SPEND_OUTPUTS = 2;
+
+(async () => {
+    const workload = process.argv[2];
+
+    if (process.argv.length < 4 || ['sync', 'keyimages', 'spend'].indexOf(workload) === -1) {
+        console.error('Usage: npm run record -- <sync|keyimages|spend> <trace.json>');
+
+        process.exit(1);
+    }
+
+    const TurtleCoinCrypto = new Crypto();
+
+    const Wallet = await Address.fromSeed(walletSeed);
+
+    // the keys are prepared before recording starts so only device time is captured
+    const tx_public_keys: string[] = [];
+
+    const public_ephemerals: string[] = [];
+
+    for (let i = 0; i < TRANSACTIONS; i++) {
+        tx_public_keys.push((await TurtleCoinCrypto.generateKeys()).public_key);
+
+        const derivation = await TurtleCoinCrypto.generateKeyDerivation(tx_public_keys[i], Wallet.view.privateKey);
+
+        public_ephemerals.push(await TurtleCoinCrypto.derivePublicKey(derivation, 0, Wallet.spend.publicKey));
+    }
+
+    const mixins = [public_ephemerals[0]];
+
+    for (let i = 0; i < 3; i++) {
+        mixins.push((await TurtleCoinCrypto.generateKeys()).public_key);
+    }
+
+    const output_key = (await TurtleCoinCrypto.generateKeys()).public_key;
+
+    const transport = await TCPTransport.open('127.0.0.1:9999', 600000);
+
+    const ledger = new LedgerDevice(transport);
+
+    transport.startTrace();
+
+    if (workload === 'sync') {
+        await transport.send(0xe0, 0x06, 0x00, 0x00, Buffer.from([0x02]));
+
+        for (let i = 0; i < TRANSACTIONS; i++) {
+            const derivation = await ledger.generateKeyDerivation(tx_public_keys[i], false);
+
+            await ledger.derivePublicKey(derivation, 0, false);
+
+            await ledger.derivePublicKey(derivation, 1, false);
+        }
+
+        await transport.send(0xe0, 0x07, 0x00, 0x00);
+    } else if (workload === 'keyimages') {
+        await transport.send(0xe0, 0x06, 0x00, 0x00, Buffer.from([0x02]));
+
+        for (let i = 0; i < TRANSACTIONS; i++) {
+            await ledger.generateKeyImage(tx_public_keys[i], 0, public_ephemerals[i], false);
+        }
+
+        await transport.send(0xe0, 0x07, 0x00, 0x00);
+    } else {
+        await ledger.startTransaction(0, SPEND_INPUTS, SPEND_OUTPUTS, tx_public_keys[1]);
+
+        await ledger.startTransactionInputLoad();
+
+        for (let i = 0; i < SPEND_INPUTS; i++) {
+            await ledger.loadTransactionInput(tx_public_keys[0], 0, 1000, mixins, [0, 1, 2, 3], 0);
+        }
+
+        await ledger.startTransactionOutputLoad();
+
+        for (let i = 0; i < SPEND_OUTPUTS; i++) {
+            await ledger.loadTransactionOutput(10, output_key);
+        }
+
+        await ledger.finalizeTransactionPrefix();
+
+        await ledger.signTransaction(false);
+
+        await ledger.retrieveTransaction();
+
+        await ledger.resetTransaction(false);
+    }
+
+    const trace = transport.stopTrace(process.argv[3]);
+
+    await transport.close();
+
+    console.error('Recorded %s exchanges to %s', trace ? trace.exchanges.length : 0, process.argv[3]);
+})().catch(error => {
+    console.error(error);
+
+    process.exit(1);
+});
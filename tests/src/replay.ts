@@ -0,0 +1,159 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+import { TCPTransport, Trace, TraceExchange } from './TCPTransport';
+import * as fs from 'fs';
+
+/**
+ * Re-issues the exchanges of a trace recorded by TCPTransport (see record.ts,
+ * or set TRACE when running the test suite or benchmark) against Speculos and
+ * reports the latency of each exchange and of the whole session next to the
+ * recorded figures. Responses that involve random scalars will differ between
+ * runs so only the status words are compared
+ *
+ * npm run replay -- <trace.json> [output.json]
+ *
+ * REPLAY_REALTIME  when set, the recorded gaps between exchanges are kept
+ * REPLAY_VERBOSE   when set, every exchange is printed
+ */
+
+/** @ignore */
+const realtime = !!(process.env.REPLAY_REALTIME && process.env.REPLAY_REALTIME.length !== 0);
+
+/** @ignore */
+const verbose = !!(process.env.REPLAY_VERBOSE && process.env.REPLAY_VERBOSE.length !== 0);
+
+interface InstructionSummary {
+    count: number;
+    recorded: number;
+    replayed: number;
+}
+
+function round (value: number): number {
+    return Math.round(value * 1000) / 1000;
+}
+
+function ins (exchange: TraceExchange): string {
+    return '0x' + exchange.command.slice(2, 4);
+}
+
+async function sleep (ms: number): Promise<void> {
+    return new Promise(resolve => setTimeout(resolve, ms));
+}
+
+(async () => {
+    if (process.argv.length < 3) {
+        console.error('Usage: npm run replay -- <trace.json> [output.json]');
+
+        process.exit(1);
+    }
+
+    const recorded: Trace = JSON.parse(fs.readFileSync(process.argv[2]).toString());
+
+    const transport = await TCPTransport.open('127.0.0.1:9999', 600000);
+
+    transport.startTrace();
+
+    for (let i = 0; i < recorded.exchanges.length; i++) {
+        const exchange = recorded.exchanges[i];
+
+        if (realtime && i !== 0) {
+            const previous = recorded.exchanges[i - 1];
+
+            await sleep(Math.max(0, exchange.at - (previous.at + previous.elapsed)));
+        }
+
+        // a failing status word is part of the session being replayed
+        await transport.exchange(Buffer.from(exchange.command, 'hex')).catch(() => undefined);
+
+        const trace = transport.trace as Trace;
+
+        // an exchange that timed out was not recorded, keep the two traces aligned
+        if (trace.exchanges.length === i) {
+            trace.exchanges.push({ at: 0, command: exchange.command, response: '', status: 0, elapsed: 0 });
+        }
+    }
+
+    const replayed = transport.stopTrace() as Trace;
+
+    await transport.close();
+
+    const summary: {[ins: string]: InstructionSummary} = {};
+
+    let mismatches = 0;
+
+    let recordedTotal = 0;
+
+    let replayedTotal = 0;
+
+    const exchanges = recorded.exchanges.map((exchange, index) => {
+        const status = replayed.exchanges[index].status;
+
+        const elapsed = replayed.exchanges[index].elapsed;
+
+        if (status !== exchange.status) {
+            mismatches++;
+        }
+
+        summary[ins(exchange)] = summary[ins(exchange)] || { count: 0, recorded: 0, replayed: 0 };
+
+        summary[ins(exchange)].count++;
+        summary[ins(exchange)].recorded += exchange.elapsed;
+        summary[ins(exchange)].replayed += elapsed;
+
+        recordedTotal += exchange.elapsed;
+
+        replayedTotal += elapsed;
+
+        if (verbose) {
+            console.error('%s %s %s -> %s %s ms (recorded %s ms)', index.toString().padStart(5), ins(exchange),
+                exchange.status.toString(16), status.toString(16), round(elapsed), round(exchange.elapsed));
+        }
+
+        return {
+            ins: ins(exchange),
+            status: status,
+            recordedStatus: exchange.status,
+            elapsed: round(elapsed),
+            recordedElapsed: round(exchange.elapsed)
+        };
+    });
+
+    for (const key of Object.keys(summary).sort()) {
+        const entry = summary[key];
+
+        console.error('%s x%s: %s ms (recorded %s ms)', key, entry.count.toString().padEnd(5),
+            round(entry.replayed), round(entry.recorded));
+
+        entry.recorded = round(entry.recorded);
+
+        entry.replayed = round(entry.replayed);
+    }
+
+    console.error('total: %s ms over %s exchanges (recorded %s ms), %s status mismatches',
+        round(replayedTotal), exchanges.length, round(recordedTotal), mismatches);
+
+    const json = JSON.stringify({
+        trace: process.argv[2],
+        total: round(replayedTotal),
+        recordedTotal: round(recordedTotal),
+        mismatches: mismatches,
+        instructions: summary,
+        exchanges: exchanges
+    }, null, 4);
+
+    if (process.argv.length > 3) {
+        fs.writeFileSync(process.argv[3], json);
+    }
+
+    console.log(json);
+
+    if (mismatches !== 0) {
+        process.exit(1);
+    }
+})().catch(error => {
+    console.error(error);
+
+    process.exit(1);
+});